@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -35,6 +36,12 @@ struct position
     float y{};
     float z{};
 };
+
+/** Distinct unregistered component types for the spawn workload. */
+template <std::size_t Slot> struct spawn_component
+{
+    std::uint64_t value{};
+};
 } // namespace arc::benchmarks
 
 namespace arc::ecs
@@ -99,6 +106,11 @@ template <> struct component_traits<benchmarks::position>
                                                      false,
                                                      {}};
 };
+
+template <> struct component_storage_traits<benchmarks::position>
+{
+    static constexpr component_storage storage = component_storage::dense;
+};
 } // namespace arc::ecs
 
 namespace
@@ -305,6 +317,92 @@ int main(int argc, char** argv)
     for (std::uint32_t index = 0; index < 4096; ++index)
         ecs_world.emplace<arc::benchmarks::position>(ecs_world.create(),
                                                      arc::benchmarks::position{static_cast<float>(index), 1.0f, 2.0f});
+    const auto populate_view_world = [](arc::ecs::world& target, std::uint32_t count)
+    {
+        target.prepare_query<arc::benchmarks::position>();
+        for (std::uint32_t index = 0; index < count; ++index)
+            target.emplace<arc::benchmarks::position>(target.create(),
+                                                      arc::benchmarks::position{static_cast<float>(index), 1.0f, 2.0f});
+    };
+    // Spawn workload: every pair, triple and quad of eight components, capped at 120 cached queries.
+    std::vector<arc::ecs::query_signature> spawn_queries;
+    const std::array<arc::ecs::component_type_id, 8> spawn_types{
+        arc::ecs::component_type<arc::benchmarks::spawn_component<0>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<1>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<2>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<3>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<4>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<5>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<6>>(),
+        arc::ecs::component_type<arc::benchmarks::spawn_component<7>>(),
+    };
+    for (std::size_t width = 2; width <= 4; ++width)
+        for (unsigned mask = 1; mask < 256 && spawn_queries.size() < 120; ++mask)
+        {
+            if (static_cast<std::size_t>(std::popcount(mask)) != width) continue;
+            arc::ecs::query_signature signature;
+            for (std::size_t slot = 0; slot < spawn_types.size(); ++slot)
+                if (mask & (1u << slot)) signature.required.push_back(spawn_types[slot]);
+            std::sort(signature.required.begin(), signature.required.end());
+            spawn_queries.push_back(std::move(signature));
+        }
+    const auto spawn = [&spawn_queries]
+    {
+        arc::ecs::world target;
+        for (const auto& signature : spawn_queries)
+            target.prepare_query(signature);
+        for (std::uint64_t index = 0; index < 10'000; ++index)
+        {
+            const auto value = target.create();
+            target.emplace<arc::benchmarks::spawn_component<0>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<1>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<2>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<3>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<4>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<5>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<6>>(value, index);
+            target.emplace<arc::benchmarks::spawn_component<7>>(value, index);
+        }
+        std::uint64_t matched{};
+        for (const auto value : target.query(spawn_queries.back()))
+            matched += value.index;
+        return matched;
+    };
+    // Rollback workloads: 10k entities with 128 of them changing per captured tick.
+    arc::ecs::world rollback_world;
+    std::vector<arc::ecs::entity> rollback_entities;
+    for (std::uint32_t index = 0; index < 10'000; ++index)
+    {
+        rollback_entities.push_back(rollback_world.create());
+        rollback_world.emplace<arc::benchmarks::position>(rollback_entities.back(),
+                                                          arc::benchmarks::position{static_cast<float>(index)});
+    }
+    std::uint64_t rollback_tick{};
+    const auto simulate_rollback_tick = [&rollback_world, &rollback_entities, &rollback_tick]
+    {
+        ++rollback_tick;
+        for (std::uint32_t offset = 0; offset < 128; ++offset)
+        {
+            const auto index = (rollback_tick * 128 + offset) * 7919 % rollback_entities.size();
+            rollback_world.get<arc::benchmarks::position>(rollback_entities[index]).y += 1.0f;
+        }
+        return arc::ecs::simulation_tick_id{rollback_tick};
+    };
+    arc::ecs::rollback_ring rollback_history(64);
+    arc::ecs::rollback_ring rollback_full(64);
+    for (std::size_t tick = 0; tick < 64; ++tick)
+        rollback_full.capture(rollback_world, simulate_rollback_tick());
+    arc::ecs::world view_world_100k;
+    arc::ecs::world view_world_1m;
+    populate_view_world(view_world_100k, 100'000);
+    populate_view_world(view_world_1m, 1'000'000);
+    const auto sum_view = [](const arc::ecs::world& source)
+    {
+        float sum{};
+        source.view<arc::benchmarks::position>().each([&sum](arc::ecs::entity, const arc::benchmarks::position& value)
+                                                      { sum += value.x + value.y + value.z; });
+        return static_cast<std::uint64_t>(sum);
+    };
 
     arc::jobs::job_system jobs({
         .worker_count = 4,
@@ -312,6 +410,35 @@ int main(int argc, char** argv)
         .io_worker_count = 0,
         .enable_render_thread = false,
     });
+    // Separate schedulers isolate the worker-count dimension of jobs.dispatch.
+    std::array<std::unique_ptr<arc::jobs::job_system>, 4> scaling_jobs;
+    for (std::size_t index = 0; index < scaling_jobs.size(); ++index)
+        scaling_jobs[index] = std::make_unique<arc::jobs::job_system>(arc::jobs::job_system_config{
+            .worker_count = std::size_t{1} << index,
+            .run_inline = false,
+            .io_worker_count = 0,
+            .enable_render_thread = false,
+        });
+    const auto dispatch_scaling = [](arc::jobs::job_system& scheduler)
+    {
+        return [&scheduler]
+        {
+            std::array<std::uint64_t, 256> values{};
+            std::array<arc::jobs::job_handle, 256> handles;
+            for (std::size_t index = 0; index < handles.size(); ++index)
+                handles[index] = scheduler.submit(
+                    [&values, index]
+                    {
+                        std::uint64_t value{index};
+                        for (std::uint64_t step = 0; step < 1024; ++step)
+                            value = (value ^ (step + 0x9e3779b97f4a7c15ull)) * 0xbf58476d1ce4e5b9ull;
+                        values[index] = value;
+                    });
+            for (const auto& handle : handles)
+                handle.wait();
+            return std::accumulate(values.begin(), values.end(), std::uint64_t{});
+        };
+    };
     std::cerr << "ARC benchmark setup: assets\n";
 
     std::array<std::byte, 64 * 1024> hash_input{};
@@ -366,9 +493,11 @@ int main(int argc, char** argv)
     camera_transform.position = {0.0f, 30.0f, 40.0f};
     render_scene_world.emplace<arc::scene::transform_component>(camera, camera_transform);
     render_scene_world.emplace<arc::scene::camera_component>(camera);
+    std::vector<arc::ecs::entity> render_scene_meshes;
     for (std::uint32_t index = 0; index < 2048; ++index)
     {
         const auto value = render_scene_world.create();
+        render_scene_meshes.push_back(value);
         arc::scene::transform_component transform;
         transform.position = {static_cast<float>(index % 64) - 32.0f, 0.0f, -static_cast<float>(index / 64)};
         render_scene_world.emplace<arc::scene::transform_component>(value, transform);
@@ -378,6 +507,43 @@ int main(int argc, char** argv)
     }
     arc::scene::prepare_render_scene_queries(render_scene_world);
     std::uint64_t render_frame{};
+    // Persistent extraction state for the incremental workload; moving a few meshes leaves the full rebuild's cost
+    // unchanged, so both workloads share the scene.
+    arc::scene::transform_hierarchy_cache render_scene_transforms;
+    arc::scene::render_extraction_cache render_scene_extraction;
+    std::size_t render_scene_dirty_cursor{};
+    // Prepare-stage packets for the large extraction workloads: boxes scattered around a perspective camera.
+    const auto make_extraction_packet = [](std::size_t count)
+    {
+        arc::render::render_world_packet packet;
+        auto& projection = packet.camera.view_projection;
+        projection = arc::math::matrix4f{};
+        projection(0, 0) = 1.0f / std::tan(0.5f) * 9.0f / 16.0f;
+        projection(1, 1) = 1.0f / std::tan(0.5f);
+        projection(2, 2) = 500.0f / (0.1f - 500.0f);
+        projection(2, 3) = 500.0f * 0.1f / (0.1f - 500.0f);
+        projection(3, 2) = -1.0f;
+        std::uint64_t state{0x9e3779b97f4a7c15ull};
+        const auto next = [&state]
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<float>(state >> 40u) / static_cast<float>(1u << 24u);
+        };
+        packet.items.reserve(count);
+        for (std::size_t index = 0; index < count; ++index)
+        {
+            const arc::geometric::point3f min{next() * 800.0f - 400.0f, next() * 200.0f - 100.0f,
+                                              next() * 800.0f - 400.0f};
+            const float size = 0.1f + next() * 4.0f;
+            packet.items.push_back({.mesh = arc::render::mesh_handle{static_cast<std::uint32_t>(index % 16 + 1), 1},
+                                    .world_bounds = {min, {min[0] + size, min[1] + size, min[2] + size}}});
+        }
+        return packet;
+    };
+    auto extraction_packet_100k = make_extraction_packet(100'000);
+    auto extraction_packet_1m = make_extraction_packet(1'000'000);
+    // Reused across iterations so recording measures the warmed command arena, as a system's buffer would.
+    arc::ecs::entity_command_buffer spawn_commands;
     const std::vector<std::pair<std::string, std::function<std::uint64_t()>>> workloads{
         {"ecs.prepared-query",
          [&]
@@ -387,6 +553,8 @@ int main(int argc, char** argv)
                  sum += entity.index;
              return sum;
          }},
+        {"ecs.prepared-query.100k", [&] { return sum_view(view_world_100k); }},
+        {"ecs.prepared-query.1m", [&] { return sum_view(view_world_1m); }},
         {"ecs.command-flush",
          [&]
          {
@@ -402,6 +570,31 @@ int main(int argc, char** argv)
              const auto result = arc::ecs::entity_command_buffer::flush_ordered(command_world, buffers);
              return static_cast<std::uint64_t>(result.applied);
          }},
+        {"ecs.command-flush.4k",
+         [&]
+         {
+             arc::ecs::world command_world;
+             for (std::size_t index = 0; index < 4096; ++index)
+             {
+                 const auto entity = spawn_commands.create();
+                 spawn_commands.add<arc::benchmarks::position>(entity, {static_cast<float>(index), 0.0f, 0.0f});
+                 spawn_commands.patch<arc::benchmarks::position>(entity, [](auto& value) { value.y = 1.0f; });
+             }
+             return static_cast<std::uint64_t>(spawn_commands.flush(command_world).applied);
+         }},
+        {"ecs.spawn.10k", spawn},
+        {"ecs.rollback.capture-64",
+         [&]
+         {
+             rollback_history.capture(rollback_world, simulate_rollback_tick());
+             return static_cast<std::uint64_t>(rollback_history.size());
+         }},
+        {"ecs.rollback.restore-64",
+         [&]
+         {
+             const arc::ecs::world restored = rollback_full.restore(rollback_full.newest());
+             return static_cast<std::uint64_t>(restored.live_count());
+         }},
         {"jobs.dispatch",
          [&]
          {
@@ -412,6 +605,10 @@ int main(int argc, char** argv)
                  handle.wait();
              return std::uint64_t{64};
          }},
+        {"jobs.dispatch.workers-1", dispatch_scaling(*scaling_jobs[0])},
+        {"jobs.dispatch.workers-2", dispatch_scaling(*scaling_jobs[1])},
+        {"jobs.dispatch.workers-4", dispatch_scaling(*scaling_jobs[2])},
+        {"jobs.dispatch.workers-8", dispatch_scaling(*scaling_jobs[3])},
         {"jobs.dependencies",
          [&]
          {
@@ -474,6 +671,35 @@ int main(int argc, char** argv)
              const auto frame = scene_renderer.frame_queue().commit(++render_frame);
              return extracted.submitted_draw_count + frame.events.size();
          }},
+        {"render.scene-extraction.dirty-1pct",
+         [&]
+         {
+             for (std::size_t moved = 0; moved < render_scene_meshes.size() / 100; ++moved)
+             {
+                 const auto value = render_scene_meshes[render_scene_dirty_cursor++ % render_scene_meshes.size()];
+                 auto& transform = render_scene_world.get<arc::scene::transform_component>(value);
+                 transform.set_position(
+                     {transform.position[0], transform.position[1] + 0.01f, transform.position[2]});
+             }
+             const auto extracted = arc::scene::render_scene(
+                 render_scene_world, scene_renderer, 1920, 1080, arc::render::render_mode::shaded,
+                 arc::render::mesh_visualization_mode::standard, arc::render::editor_overlay_mode::selected_wireframe,
+                 true, {}, 0.0f, {}, {}, nullptr, &render_scene_transforms, &render_scene_extraction);
+             const auto frame = scene_renderer.frame_queue().commit(++render_frame);
+             return extracted.submitted_draw_count + frame.events.size();
+         }},
+        {"render.scene-extraction.100k",
+         [&]
+         {
+             arc::render::prepare_render_world(extraction_packet_100k, {.jobs = &jobs});
+             return extraction_packet_100k.visible_items.size();
+         }},
+        {"render.scene-extraction.1m",
+         [&]
+         {
+             arc::render::prepare_render_world(extraction_packet_1m, {.jobs = &jobs});
+             return extraction_packet_1m.visible_items.size();
+         }},
         {"render.graph-compile",
          [&]
          {
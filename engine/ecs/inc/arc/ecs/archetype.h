@@ -0,0 +1,275 @@
+#pragma once
+
+#include <arc/ecs/entity.h>
+#include <arc/ecs/reflection.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace arc::ecs
+{
+
+/** Type-erased lifetime operations for components stored in archetype chunks. */
+struct component_operations
+{
+    component_type_id type{};
+    std::size_t size{};
+    std::size_t alignment{};
+    /** Move-constructs into uninitialized `destination`, then destroys `source`. */
+    void (*relocate)(void* destination, void* source){};
+    void (*copy)(void* destination, const void* source){};
+    void (*destroy)(void* value){};
+
+    template <class T> [[nodiscard]] static const component_operations& of() noexcept
+    {
+        static constexpr component_operations value{
+            component_type<T>(),
+            sizeof(T),
+            alignof(T),
+            [](void* destination, void* source)
+            {
+                std::construct_at(static_cast<T*>(destination), std::move(*static_cast<T*>(source)));
+                std::destroy_at(static_cast<T*>(source));
+            },
+            [](void* destination, const void* source)
+            { std::construct_at(static_cast<T*>(destination), *static_cast<const T*>(source)); },
+            [](void* value) { std::destroy_at(static_cast<T*>(value)); }};
+        return value;
+    }
+};
+
+/** Revision bookkeeping kept beside every component value. */
+struct component_change_state
+{
+    std::uint64_t revision{};
+    std::uint64_t fields{};
+};
+
+/**
+ * Entities sharing one exact component set. Rows are packed densely and each
+ * 16 KiB chunk stores one contiguous array per component, so iteration walks
+ * plain arrays. Removing a row moves the last row into its place.
+ */
+class archetype
+{
+public:
+    static constexpr std::size_t chunk_bytes = 16 * 1024;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /** `columns` must be sorted by component type and free of duplicates. */
+    archetype(std::vector<const component_operations*> columns, std::pmr::memory_resource* resource)
+        : resource_(resource), columns_(std::move(columns)), entities_(resource)
+    {
+        std::size_t row_bytes{};
+        for (const auto* column : columns_)
+        {
+            types_.push_back(column->type);
+            row_bytes += column->size;
+            chunk_alignment_ = std::max(chunk_alignment_, column->alignment);
+            states_.emplace_back(resource);
+        }
+        if (columns_.empty()) return;
+
+        // Reserve worst-case padding once per column, then lay the columns out back to back.
+        std::size_t padding{};
+        for (const auto* column : columns_)
+            padding += column->alignment - 1;
+        chunk_rows_ = chunk_bytes > padding + row_bytes ? (chunk_bytes - padding) / row_bytes : 1;
+        std::size_t offset{};
+        for (const auto* column : columns_)
+        {
+            offset = (offset + column->alignment - 1) / column->alignment * column->alignment;
+            offsets_.push_back(offset);
+            offset += column->size * chunk_rows_;
+        }
+        chunk_size_ = std::max(offset, chunk_bytes);
+    }
+
+    ~archetype()
+    {
+        for (std::size_t row = 0; row < entities_.size(); ++row)
+            for (std::size_t column = 0; column < columns_.size(); ++column)
+                columns_[column]->destroy(value(column, row));
+        for (std::byte* chunk : chunks_)
+            resource_->deallocate(chunk, chunk_size_, chunk_alignment_);
+    }
+
+    archetype(const archetype&) = delete;
+    archetype& operator=(const archetype&) = delete;
+
+    [[nodiscard]] std::span<const component_type_id> types() const noexcept
+    {
+        return types_;
+    }
+    [[nodiscard]] std::span<const component_operations* const> columns() const noexcept
+    {
+        return columns_;
+    }
+    [[nodiscard]] std::span<const entity> entities() const noexcept
+    {
+        return {entities_.data(), entities_.size()};
+    }
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return entities_.size();
+    }
+    [[nodiscard]] std::size_t chunk_rows() const noexcept
+    {
+        return chunk_rows_;
+    }
+
+    [[nodiscard]] std::size_t column_index(component_type_id type) const noexcept
+    {
+        const auto found = std::lower_bound(types_.begin(), types_.end(), type);
+        return found != types_.end() && *found == type ? static_cast<std::size_t>(found - types_.begin()) : npos;
+    }
+    [[nodiscard]] bool contains(component_type_id type) const noexcept
+    {
+        return column_index(type) != npos;
+    }
+
+    [[nodiscard]] void* value(std::size_t column, std::size_t row) const noexcept
+    {
+        return chunks_[row / chunk_rows_] + offsets_[column] + row % chunk_rows_ * columns_[column]->size;
+    }
+
+    /** First value of `column` in `chunk`; the chunk holds `chunk_rows()` rows except possibly the last. */
+    template <class T> [[nodiscard]] const T* column_data(std::size_t column, std::size_t chunk) const noexcept
+    {
+        return reinterpret_cast<const T*>(chunks_[chunk] + offsets_[column]);
+    }
+
+    [[nodiscard]] component_change_state& state(std::size_t column, std::size_t row) noexcept
+    {
+        return states_[column][row];
+    }
+    [[nodiscard]] const component_change_state& state(std::size_t column, std::size_t row) const noexcept
+    {
+        return states_[column][row];
+    }
+
+    /** Appends a row whose component values are left for the caller to construct. */
+    std::size_t append(entity value)
+    {
+        const std::size_t row = entities_.size();
+        if (!columns_.empty() && row == chunks_.size() * chunk_rows_)
+            chunks_.push_back(static_cast<std::byte*>(resource_->allocate(chunk_size_, chunk_alignment_)));
+        entities_.push_back(value);
+        for (auto& states : states_)
+            states.emplace_back();
+        return row;
+    }
+
+    /**
+     * Moves `row` into `target`, relocating shared components and destroying the
+     * rest. Components only `target` has stay unconstructed for the caller.
+     * Returns the row in `target` and reports the entity moved into the hole.
+     */
+    std::size_t migrate(std::size_t row, archetype& target, entity& moved)
+    {
+        const std::size_t destination = target.append(entities_[row]);
+        for (std::size_t column = 0; column < columns_.size(); ++column)
+        {
+            const std::size_t target_column = target.column_index(types_[column]);
+            if (target_column == npos)
+            {
+                columns_[column]->destroy(value(column, row));
+                continue;
+            }
+            columns_[column]->relocate(target.value(target_column, destination), value(column, row));
+            target.state(target_column, destination) = states_[column][row];
+        }
+        moved = fill_hole(row);
+        return destination;
+    }
+
+    /** Destroys every component of `row`; returns the entity moved into the hole. */
+    entity erase(std::size_t row)
+    {
+        for (std::size_t column = 0; column < columns_.size(); ++column)
+            columns_[column]->destroy(value(column, row));
+        return fill_hole(row);
+    }
+
+    /** Copies every row into `target`, which must have the same columns and no rows. */
+    void copy_to(archetype& target) const
+    {
+        for (std::size_t row = 0; row < entities_.size(); ++row)
+        {
+            const std::size_t destination = target.append(entities_[row]);
+            for (std::size_t column = 0; column < columns_.size(); ++column)
+            {
+                columns_[column]->copy(target.value(column, destination), value(column, row));
+                target.state(column, destination) = states_[column][row];
+            }
+        }
+    }
+
+    /** Cached transition to the archetype with `type` added or removed. */
+    [[nodiscard]] std::uint32_t edge(component_type_id type, bool adding) const noexcept
+    {
+        for (const auto& cached : edges_)
+            if (cached.type == type && cached.adding == adding) return cached.target;
+        return no_edge;
+    }
+    void set_edge(component_type_id type, bool adding, std::uint32_t target)
+    {
+        edges_.push_back({type, target, adding});
+    }
+
+    static constexpr std::uint32_t no_edge = static_cast<std::uint32_t>(-1);
+
+private:
+    struct transition
+    {
+        component_type_id type{};
+        std::uint32_t target{};
+        bool adding{};
+    };
+
+    /** Relocates the last row into `row`, whose values are already gone. */
+    entity fill_hole(std::size_t row)
+    {
+        const std::size_t last = entities_.size() - 1;
+        entity moved{};
+        if (row != last)
+        {
+            for (std::size_t column = 0; column < columns_.size(); ++column)
+            {
+                columns_[column]->relocate(value(column, row), value(column, last));
+                states_[column][row] = states_[column][last];
+            }
+            entities_[row] = entities_[last];
+            moved = entities_[row];
+        }
+        entities_.pop_back();
+        for (auto& states : states_)
+            states.pop_back();
+        if (!columns_.empty() && entities_.size() + chunk_rows_ <= chunks_.size() * chunk_rows_)
+        {
+            resource_->deallocate(chunks_.back(), chunk_size_, chunk_alignment_);
+            chunks_.pop_back();
+        }
+        return moved;
+    }
+
+    std::pmr::memory_resource* resource_{};
+    std::vector<const component_operations*> columns_;
+    std::vector<component_type_id> types_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::pmr::vector<component_change_state>> states_;
+    std::pmr::vector<entity> entities_;
+    std::vector<std::byte*> chunks_;
+    std::vector<transition> edges_;
+    std::size_t chunk_rows_{chunk_bytes};
+    std::size_t chunk_size_{};
+    std::size_t chunk_alignment_{alignof(std::max_align_t)};
+};
+
+} // namespace arc::ecs
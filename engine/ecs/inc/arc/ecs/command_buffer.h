@@ -1,15 +1,17 @@
 #pragma once
 
 #include <arc/ecs/world.h>
+#include <arc/memory/memory.h>
 
 #include <algorithm>
 #include <atomic>
 #include <compare>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <span>
 #include <string>
-#include <unordered_map>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -34,18 +36,11 @@ public:
     entity_target(entity value) : immediate_(value) {}
     entity_target(deferred_entity value) : deferred_(value), is_deferred_(true) {}
 
-    entity resolve(const std::unordered_map<std::uint64_t, std::vector<entity>>& values) const noexcept
-    {
-        if (!is_deferred_) return immediate_;
-        const auto found = values.find(deferred_.buffer);
-        if (found == values.end() || deferred_.ordinal >= found->second.size()) return {};
-        return found->second[deferred_.ordinal];
-    }
-
 private:
     entity immediate_{};
     deferred_entity deferred_{};
     bool is_deferred_{};
+    friend class entity_command_buffer;
 };
 
 enum class command_error_code : std::uint8_t
@@ -74,8 +69,81 @@ struct [[nodiscard]] command_flush_result
     }
 };
 
+namespace detail
+{
+
+/** Behaviour shared by every command of one kind and component type; labels exist only in debug builds. */
+struct command_operations
+{
+    bool (*apply)(world& owner, entity value, void* payload){};
+    void (*destroy)(void* payload){};
+#if !defined(NDEBUG)
+    const char* label{};
+#endif
+};
+
+constexpr command_operations make_command_operations(bool (*apply)(world&, entity, void*), void (*destroy)(void*),
+                                                     const char* label) noexcept
+{
+#if !defined(NDEBUG)
+    return {apply, destroy, label};
+#else
+    (void)label;
+    return {apply, destroy};
+#endif
+}
+
+inline const char* command_label([[maybe_unused]] const command_operations& operations) noexcept
+{
+#if !defined(NDEBUG)
+    return operations.label;
+#else
+    return "command";
+#endif
+}
+
+template <class Payload>
+inline constexpr void (*destroy_command_payload)(void*) =
+    std::is_trivially_destructible_v<Payload> ? nullptr
+                                              : +[](void* payload) { std::destroy_at(static_cast<Payload*>(payload)); };
+
+inline constexpr command_operations create_command =
+    make_command_operations([](world&, entity, void*) { return true; }, nullptr, "create entity");
+
+inline constexpr command_operations destroy_command = make_command_operations(
+    [](world& owner, entity value, void*) { return owner.destroy(value); }, nullptr, "destroy entity");
+
+template <class T>
+inline constexpr command_operations add_command = make_command_operations(
+    [](world& owner, entity value, void* payload)
+    {
+        owner.emplace<T>(value, std::move(*static_cast<T*>(payload)));
+        return true;
+    },
+    destroy_command_payload<T>, "add component");
+
+template <class T>
+inline constexpr command_operations remove_command = make_command_operations(
+    [](world& owner, entity value, void*) { return owner.remove<T>(value); }, nullptr, "remove component");
+
+template <class T, class Function>
+inline constexpr command_operations patch_command = make_command_operations(
+    [](world& owner, entity value, void* payload)
+    {
+        T* component = owner.template try_get<T>(value);
+        if (!component) return false;
+        std::invoke(*static_cast<Function*>(payload), *component);
+        owner.template mark_dirty<T>(value);
+        return true;
+    },
+    destroy_command_payload<Function>, "patch component");
+
+} // namespace detail
+
 /**
- * Thread-local structural mutation recorder. Buffers are sorted by their
+ * Thread-local structural mutation recorder. Commands are encoded into a
+ * private arena as POD headers followed by in-place payloads, so recording
+ * reuses the arena's blocks once it has grown. Buffers are sorted by their
  * deterministic key before a phase flush.
  */
 class entity_command_buffer
@@ -90,69 +158,77 @@ public:
         friend constexpr auto operator<=>(sort_key, sort_key) noexcept = default;
     };
 
+    static constexpr std::size_t default_arena_capacity = 16u * 1024u;
+
     entity_command_buffer() : entity_command_buffer(sort_key{}) {}
 
-    explicit entity_command_buffer(sort_key key) : key_(key), id_(next_id()) {}
+    explicit entity_command_buffer(sort_key key) : key_(key), id_(next_id()), arena_(default_arena_capacity) {}
+
+    ~entity_command_buffer()
+    {
+        clear();
+    }
 
     entity_command_buffer(const entity_command_buffer&) = delete;
     entity_command_buffer& operator=(const entity_command_buffer&) = delete;
-    entity_command_buffer(entity_command_buffer&&) noexcept = default;
-    entity_command_buffer& operator=(entity_command_buffer&&) noexcept = default;
+
+    entity_command_buffer(entity_command_buffer&& other) noexcept
+        : key_(other.key_), id_(other.id_), created_(std::exchange(other.created_, 0)),
+          size_(std::exchange(other.size_, 0)), arena_(std::move(other.arena_)),
+          head_(std::exchange(other.head_, nullptr)), tail_(std::exchange(other.tail_, nullptr))
+    {
+    }
+
+    entity_command_buffer& operator=(entity_command_buffer&& other) noexcept
+    {
+        if (this == &other) return *this;
+        clear();
+        key_ = other.key_;
+        id_ = other.id_;
+        created_ = std::exchange(other.created_, 0);
+        size_ = std::exchange(other.size_, 0);
+        arena_ = std::move(other.arena_);
+        head_ = std::exchange(other.head_, nullptr);
+        tail_ = std::exchange(other.tail_, nullptr);
+        return *this;
+    }
 
     deferred_entity create()
     {
-        const deferred_entity result{id_, created_++};
-        commands_.push_back({[result](world& owner, resolver& values)
-                             {
-                                 auto& buffer_values = values[result.buffer];
-                                 if (buffer_values.size() <= result.ordinal) buffer_values.resize(result.ordinal + 1);
-                                 buffer_values[result.ordinal] = owner.create();
-                                 return true;
-                             },
-                             "create entity"});
+        const deferred_entity result{id_, created_};
+        record(detail::create_command, result);
+        ++created_;
         return result;
     }
 
     void destroy(entity_target target)
     {
-        record_target(target, "destroy entity", [](world& owner, entity value) { return owner.destroy(value); });
+        record(detail::destroy_command, target);
     }
 
     template <class T> void add(entity_target target, T component)
     {
-        record_target(target, "add component",
-                      [component = std::move(component)](world& owner, entity value) mutable
-                      {
-                          owner.emplace<T>(value, std::move(component));
-                          return true;
-                      });
+        record<T>(detail::add_command<T>, target, std::move(component));
     }
 
     template <class T> void remove(entity_target target)
     {
-        record_target(target, "remove component", [](world& owner, entity value) { return owner.remove<T>(value); });
+        record(detail::remove_command<T>, target);
     }
 
     template <class T, class Function> void patch(entity_target target, Function&& function)
     {
-        record_target(target, "patch component",
-                      [function = std::forward<Function>(function)](world& owner, entity value) mutable
-                      {
-                          T* component = owner.template try_get<T>(value);
-                          if (!component) return false;
-                          std::invoke(function, *component);
-                          owner.template mark_dirty<T>(value);
-                          return true;
-                      });
+        using payload = std::decay_t<Function>;
+        record<payload>(detail::patch_command<T, payload>, target, std::forward<Function>(function));
     }
 
     bool empty() const noexcept
     {
-        return commands_.empty();
+        return head_ == nullptr;
     }
     std::size_t size() const noexcept
     {
-        return commands_.size();
+        return size_;
     }
     sort_key key() const noexcept
     {
@@ -162,15 +238,21 @@ public:
     {
         return id_;
     }
+
+    /** Drops every recorded command and keeps the arena's blocks for the next recording. */
     void clear() noexcept
     {
-        commands_.clear();
+        for (command_header* current = head_; current; current = current->next)
+            if (current->operations->destroy) current->operations->destroy(current->payload);
+        head_ = tail_ = nullptr;
         created_ = 0;
+        size_ = 0;
+        arena_.reset();
     }
 
     command_flush_result flush(world& owner)
     {
-        std::vector<entity_command_buffer*> buffers{this};
+        entity_command_buffer* buffers[] = {this};
         return flush_ordered(owner, buffers);
     }
 
@@ -184,54 +266,117 @@ public:
         std::stable_sort(ordered.begin(), ordered.end(),
                          [](const auto* lhs, const auto* rhs) { return lhs->key_ < rhs->key_; });
 
+        // Deferred entities resolve through one flat array; each buffer owns a contiguous slice of it.
+        std::size_t deferred_count{};
+        for (entity_command_buffer* buffer : ordered)
+        {
+            buffer->resolved_base_ = deferred_count;
+            deferred_count += buffer->created_;
+        }
+        std::vector<entity> resolved(deferred_count);
+
         command_flush_result result;
-        resolver resolved;
         owner.begin_command_flush();
         std::size_t command_index{};
         for (entity_command_buffer* buffer : ordered)
         {
-            for (command& value : buffer->commands_)
+            for (command_header* current = buffer->head_; current; current = current->next)
             {
+                const detail::command_operations& operations = *current->operations;
                 try
                 {
-                    if (value.apply(owner, resolved))
+                    if (&operations == &detail::create_command)
+                    {
+                        resolved[buffer->resolved_base_ + current->target.deferred_.ordinal] = owner.create();
                         ++result.applied;
+                    }
+                    else if (const entity value = resolve(current->target, *buffer, ordered, resolved);
+                             value.valid() && owner.alive(value) && operations.apply(owner, value, current->payload))
+                    {
+                        ++result.applied;
+                    }
                     else
+                    {
                         result.errors.push_back({command_index, command_error_code::stale_entity,
-                                                 value.label + " targeted a stale entity or missing component"});
+                                                 std::string(detail::command_label(operations)) +
+                                                     " targeted a stale entity or missing component"});
+                    }
                 }
                 catch (const std::exception& exception)
                 {
-                    result.errors.push_back(
-                        {command_index, command_error_code::exception, value.label + ": " + exception.what()});
+                    result.errors.push_back({command_index, command_error_code::exception,
+                                             std::string(detail::command_label(operations)) + ": " + exception.what()});
                 }
                 ++command_index;
             }
-            buffer->commands_.clear();
-            buffer->created_ = 0;
         }
         owner.end_command_flush();
+        // Later buffers may still have resolved entities created by earlier ones, so clear only at the end.
+        for (entity_command_buffer* buffer : ordered)
+            buffer->clear();
         return result;
     }
 
 private:
-    using resolver = std::unordered_map<std::uint64_t, std::vector<entity>>;
-
-    struct command
+    /** Arena-resident header; the payload, if any, follows it in the same allocation. */
+    struct command_header
     {
-        std::function<bool(world&, resolver&)> apply;
-        std::string label;
+        command_header* next{};
+        const detail::command_operations* operations{};
+        entity_target target{entity{}};
+        void* payload{};
     };
 
-    template <class Function> void record_target(entity_target target, std::string label, Function&& function)
+    void record(const detail::command_operations& operations, entity_target target)
+    {
+        auto* header = static_cast<command_header*>(arena_.allocate(sizeof(command_header), alignof(command_header)));
+        link(std::construct_at(header, command_header{nullptr, &operations, target, nullptr}));
+    }
+
+    template <class Payload, class... Args>
+    void record(const detail::command_operations& operations, entity_target target, Args&&... args)
+    {
+        // Arena blocks are only max_align_t aligned, so over-aligned payloads reserve slack and align themselves.
+        constexpr bool over_aligned = alignof(Payload) > alignof(std::max_align_t);
+        constexpr std::size_t payload_offset =
+            over_aligned ? sizeof(command_header)
+                         : (sizeof(command_header) + alignof(Payload) - 1) / alignof(Payload) * alignof(Payload);
+        constexpr std::size_t bytes = payload_offset + sizeof(Payload) + (over_aligned ? alignof(Payload) - 1 : 0);
+        auto* memory = static_cast<std::byte*>(
+            arena_.allocate(bytes, over_aligned ? alignof(command_header)
+                                                : std::max(alignof(command_header), alignof(Payload))));
+        void* payload_memory = memory + payload_offset;
+        if constexpr (over_aligned)
+        {
+            std::size_t space = bytes - payload_offset;
+            payload_memory = std::align(alignof(Payload), sizeof(Payload), payload_memory, space);
+        }
+        Payload* payload = std::construct_at(static_cast<Payload*>(payload_memory), std::forward<Args>(args)...);
+        link(std::construct_at(reinterpret_cast<command_header*>(memory),
+                               command_header{nullptr, &operations, target, payload}));
+    }
+
+    void link(command_header* header) noexcept
     {
-        commands_.push_back(
-            {[target, function = std::forward<Function>(function)](world& owner, resolver& values) mutable
-             {
-                 const entity resolved = target.resolve(values);
-                 return resolved.valid() && owner.alive(resolved) && std::invoke(function, owner, resolved);
-             },
-             std::move(label)});
+        (tail_ ? tail_->next : head_) = header;
+        tail_ = header;
+        ++size_;
+    }
+
+    static entity resolve(const entity_target& target, const entity_command_buffer& current,
+                          std::span<entity_command_buffer* const> buffers, std::span<const entity> resolved) noexcept
+    {
+        if (!target.is_deferred_) return target.immediate_;
+        const deferred_entity value = target.deferred_;
+        const entity_command_buffer* owner = &current;
+        if (value.buffer != current.id_)
+        {
+            const auto found = std::find_if(buffers.begin(), buffers.end(),
+                                            [&](const auto* buffer) { return buffer->id_ == value.buffer; });
+            if (found == buffers.end()) return {};
+            owner = *found;
+        }
+        return value.ordinal < owner->created_ ? resolved[owner->resolved_base_ + value.ordinal] : entity{};
     }
 
     static std::uint64_t next_id() noexcept
@@ -243,7 +388,11 @@ private:
     sort_key key_{};
     std::uint64_t id_{};
     std::uint32_t created_{};
-    std::vector<command> commands_;
+    std::size_t size_{};
+    std::size_t resolved_base_{};
+    memory::linear_arena arena_;
+    command_header* head_{};
+    command_header* tail_{};
 };
 
 } // namespace arc::ecs
@@ -13,6 +13,7 @@
 #include <arc/ecs/prefab.h>
 #include <arc/ecs/reflection.h>
 #include <arc/ecs/replication.h>
+#include <arc/ecs/rollback.h>
 #include <arc/ecs/simulation.h>
 #include <arc/ecs/system.h>
 #include <arc/ecs/template.h>
@@ -11,11 +11,12 @@ struct persistent_id_component
     entity_guid value{};
 };
 
-/** Intrusive hierarchy links; traversal performs no allocation. */
+/** Intrusive hierarchy links; traversal performs no allocation and appending a child is O(1). */
 struct hierarchy_component
 {
     entity parent{};
     entity first_child{};
+    entity last_child{};
     entity previous_sibling{};
     entity next_sibling{};
     std::uint32_t child_count{};
@@ -52,7 +53,7 @@ template <> struct component_traits<hierarchy_component>
     static constexpr bool reflected = true;
     static constexpr std::string_view canonical_name = "arc.ecs.hierarchy";
     static constexpr component_type_id id{0xa7c0000000000000ull, 0x0000000000000002ull};
-    static constexpr std::array<component_field_descriptor, 5> fields{{
+    static constexpr std::array<component_field_descriptor, 6> fields{{
         {1,
          "parent",
          "Parent",
@@ -123,6 +124,20 @@ template <> struct component_traits<hierarchy_component>
          {},
          {},
          {}},
+        {6,
+         "last_child",
+         "Last Child",
+         reflected_field_kind::entity_reference,
+         reflected_field_flags::transient,
+         component_field_descriptor::invalid_offset,
+         0,
+         {},
+         {},
+         {},
+         {},
+         {},
+         {},
+         {}},
     }};
     static constexpr component_descriptor descriptor{
         id,     canonical_name, "Hierarchy", 1, sizeof(hierarchy_component), alignof(hierarchy_component),
@@ -206,6 +221,7 @@ inline void detach(world& owner, entity child) noexcept
     if (parent.valid())
     {
         auto& parent_links = owner.get<hierarchy_component>(parent);
+        if (parent_links.last_child == child) parent_links.last_child = previous;
         if (parent_links.child_count) --parent_links.child_count;
     }
     links->parent = {};
@@ -238,12 +254,19 @@ inline bool reparent(world& owner, entity child, entity parent = {}, entity befo
             parent_links.first_child = child;
         else
         {
-            entity tail = parent_links.first_child;
-            while (owner.get<hierarchy_component>(tail).next_sibling.valid())
-                tail = owner.get<hierarchy_component>(tail).next_sibling;
+            entity tail = parent_links.last_child;
+            const auto* tail_links = owner.try_get<hierarchy_component>(tail);
+            if (!tail_links || tail_links->parent != parent || tail_links->next_sibling.valid())
+            {
+                // Links written before last_child existed; find the tail once and cache it below.
+                tail = parent_links.first_child;
+                while (owner.get<hierarchy_component>(tail).next_sibling.valid())
+                    tail = owner.get<hierarchy_component>(tail).next_sibling;
+            }
             owner.get<hierarchy_component>(tail).next_sibling = child;
             child_links.previous_sibling = tail;
         }
+        parent_links.last_child = child;
     }
     else
     {
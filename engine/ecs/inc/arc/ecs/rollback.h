@@ -0,0 +1,280 @@
+#pragma once
+
+#include <arc/ecs/simulation.h>
+#include <arc/ecs/world.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace arc::ecs
+{
+
+/**
+ * Changes a sparse-set world recorded after one revision, read from its
+ * structural log and component change journals: entity creations and
+ * destructions in order, then the final value of every component touched.
+ */
+class world_delta
+{
+public:
+    [[nodiscard]] static world_delta capture(const world& source, change_revision since)
+    {
+        world_delta result;
+        std::unordered_map<component_type_id, std::vector<entity>, component_type_id_hash> touched;
+        const auto changes = source.structural_changes();
+        for (auto change = std::upper_bound(changes.begin(), changes.end(), since, revision_before<structural_change>);
+             change != changes.end(); ++change)
+        {
+            const std::span<const entity> covered = source.structural_entities(*change);
+            if (change->kind == structural_change_kind::entity_created ||
+                change->kind == structural_change_kind::entity_destroyed)
+            {
+                for (const entity value : covered)
+                    result.entities_.push_back({change->kind, value});
+                continue;
+            }
+            auto& entities = touched[change->component];
+            entities.insert(entities.end(), covered.begin(), covered.end());
+        }
+        for (const auto& [type, pool] : source.pools_)
+        {
+            const auto events = pool->change_events();
+            auto event = std::upper_bound(events.begin(), events.end(), since, revision_before<component_change>);
+            if (event == events.end()) continue;
+            auto& entities = touched[type];
+            for (; event != events.end(); ++event)
+                entities.push_back(event->value);
+        }
+
+        result.bytes_ = result.entities_.size() * sizeof(entity_operation);
+        for (auto& [type, entities] : touched)
+        {
+            const auto pool = source.pools_.find(type);
+            if (pool == source.pools_.end()) continue;
+            std::sort(entities.begin(), entities.end(), [](entity lhs, entity rhs)
+                      { return lhs.index != rhs.index ? lhs.index < rhs.index : lhs.generation < rhs.generation; });
+            entities.erase(std::unique(entities.begin(), entities.end()), entities.end());
+            auto values = pool->second->capture_values(entities);
+            result.bytes_ += values->bytes();
+            result.components_.emplace_back(type, std::move(values));
+        }
+        return result;
+    }
+
+    /**
+     * Replays the delta onto `target`, which must hold the state the delta was
+     * captured after. Entity slots come back identical because creation and
+     * destruction replay in their recorded order against the same free list.
+     */
+    void apply(world& target) const
+    {
+        for (const entity_operation& operation : entities_)
+        {
+            if (operation.kind == structural_change_kind::entity_destroyed)
+                target.destroy(operation.value);
+            else if (target.create() != operation.value)
+                throw std::logic_error("rollback replay diverged from the recorded entity sequence");
+        }
+        for (const auto& [type, values] : components_)
+        {
+            auto pool = target.pools_.find(type);
+            if (pool == target.pools_.end())
+                pool = target.pools_.emplace(type, values->make_pool(target.pool_resource(values->descriptor()))).first;
+            values->apply(*pool->second, target.next_revision());
+            for (const entity value : values->entities())
+                if (target.alive(value)) target.refresh_queries(value, type);
+        }
+    }
+
+    [[nodiscard]] std::size_t bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+private:
+    struct entity_operation
+    {
+        structural_change_kind kind{};
+        entity value{};
+    };
+
+    template <class Change> static bool revision_before(change_revision revision, const Change& change) noexcept
+    {
+        return revision < change.revision;
+    }
+
+    std::vector<entity_operation> entities_;
+    std::vector<std::pair<component_type_id, std::unique_ptr<const component_values>>> components_;
+    std::size_t bytes_{};
+};
+
+/**
+ * History of a world's last `depth` captured ticks for rollback. Each segment
+ * starts at a keyframe snapshot followed by per-tick deltas, so a restore
+ * replays fewer than `depth` deltas forward from its keyframe. Keyframes
+ * share unchanged pages with the one before; archetype-layout worlds and
+ * worlds replaced since the last capture always start a new keyframe.
+ */
+class rollback_ring
+{
+public:
+    explicit rollback_ring(std::size_t depth = 64) : depth_(std::max<std::size_t>(depth, 1)) {}
+
+    [[nodiscard]] std::size_t depth() const noexcept
+    {
+        return depth_;
+    }
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+    [[nodiscard]] simulation_tick_id oldest() const noexcept
+    {
+        return segments_.empty() ? simulation_tick_id{} : segments_.front().tick;
+    }
+    [[nodiscard]] simulation_tick_id newest() const noexcept
+    {
+        if (segments_.empty()) return {};
+        const segment& last = segments_.back();
+        return last.deltas.empty() ? last.tick : last.deltas.back().tick;
+    }
+
+    /** Bytes held: the oldest keyframe in full, later keyframes by the pages they added, and every delta. */
+    [[nodiscard]] std::size_t bytes() const noexcept
+    {
+        std::size_t result{};
+        for (const segment& current : segments_)
+        {
+            result += &current == &segments_.front() ? current.keyframe.total_bytes()
+                                                     : current.keyframe.incremental_bytes();
+            for (const frame& delta : current.deltas)
+                result += delta.changes.bytes();
+        }
+        return result;
+    }
+
+    /** Records `source` as of `tick`, which must be newer than every tick already held. */
+    void capture(const world& source, simulation_tick_id tick)
+    {
+        if (!empty() && tick <= newest()) throw std::invalid_argument("rollback ticks must increase");
+        const bool continues = !segments_.empty() && source.storage_id() == storage_id_ &&
+                               source.layout() == memory::component_layout::sparse_set &&
+                               source.revision() >= revision_ && segments_.back().size() < depth_;
+        if (continues)
+        {
+            segments_.back().deltas.push_back({tick, world_delta::capture(source, revision_)});
+        }
+        else
+        {
+            const bool related = !segments_.empty() && source.storage_id() == storage_id_;
+            segments_.push_back({tick, source.snapshot(related ? &segments_.back().keyframe : nullptr), {}});
+        }
+        storage_id_ = source.storage_id();
+        revision_ = source.revision();
+        ++size_;
+        // Whole segments go once the newer ones alone still cover `depth` ticks.
+        while (segments_.size() > 1 && size_ - segments_.front().size() >= depth_)
+        {
+            size_ -= segments_.front().size();
+            segments_.pop_front();
+        }
+    }
+
+    [[nodiscard]] bool contains(simulation_tick_id tick) const noexcept
+    {
+        const segment* owner = find(tick);
+        return owner && (owner->tick == tick || std::any_of(owner->deltas.begin(), owner->deltas.end(),
+                                                            [tick](const frame& delta) { return delta.tick == tick; }));
+    }
+
+    /** Rebuilds the world as captured at `tick` under a new storage id. */
+    [[nodiscard]] world restore(simulation_tick_id tick) const
+    {
+        if (!contains(tick)) throw std::out_of_range("rollback ring does not hold the requested tick");
+        const segment& owner = *find(tick);
+        world result(owner.keyframe);
+        for (const frame& delta : owner.deltas)
+        {
+            if (tick < delta.tick) break;
+            delta.changes.apply(result);
+        }
+        return result;
+    }
+
+    /** Forgets every tick after `tick`, as re-simulation from a restored tick will capture them again. */
+    void truncate_after(simulation_tick_id tick) noexcept
+    {
+        while (!segments_.empty() && tick < segments_.back().tick)
+        {
+            size_ -= segments_.back().size();
+            segments_.pop_back();
+        }
+        if (!segments_.empty())
+        {
+            auto& deltas = segments_.back().deltas;
+            while (!deltas.empty() && tick < deltas.back().tick)
+            {
+                deltas.pop_back();
+                --size_;
+            }
+        }
+        // The restored world is a different storage, so the next capture starts a keyframe.
+        storage_id_ = 0;
+    }
+
+    void clear() noexcept
+    {
+        segments_.clear();
+        size_ = 0;
+        storage_id_ = 0;
+        revision_ = 0;
+    }
+
+private:
+    struct frame
+    {
+        simulation_tick_id tick;
+        world_delta changes;
+    };
+
+    struct segment
+    {
+        simulation_tick_id tick;
+        world_snapshot keyframe;
+        std::vector<frame> deltas;
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return deltas.size() + 1;
+        }
+    };
+
+    [[nodiscard]] const segment* find(simulation_tick_id tick) const noexcept
+    {
+        const auto after = std::upper_bound(segments_.begin(), segments_.end(), tick,
+                                            [](simulation_tick_id value, const segment& current)
+                                            { return value < current.tick; });
+        return after == segments_.begin() ? nullptr : &*std::prev(after);
+    }
+
+    std::size_t depth_{};
+    std::deque<segment> segments_;
+    std::size_t size_{};
+    std::uint64_t storage_id_{};
+    change_revision revision_{};
+};
+
+} // namespace arc::ecs
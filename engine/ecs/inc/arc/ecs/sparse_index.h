@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace arc::ecs
+{
+
+/**
+ * Entity index to 32-bit dense position map for one component pool. Indices
+ * are split into 4 KiB pages, allocated the first time an index in their
+ * range is inserted, so a pool costs nothing for index ranges it never
+ * stores. Pages emptied by erase stay allocated until shrink_to_fit(), so
+ * churn across a page boundary does not allocate on every insert.
+ */
+class sparse_index
+{
+public:
+    static constexpr std::uint32_t npos = 0xffffffffu;
+    static constexpr std::size_t page_entries = 1024;
+    static constexpr std::size_t page_bytes = page_entries * sizeof(std::uint32_t);
+    static constexpr std::size_t page_alignment = 64;
+
+    explicit sparse_index(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : pages_(resource), counts_(resource)
+    {
+    }
+
+    ~sparse_index()
+    {
+        for (std::uint32_t* page : pages_)
+            if (page) pages_.get_allocator().resource()->deallocate(page, page_bytes, page_alignment);
+    }
+
+    sparse_index(const sparse_index&) = delete;
+    sparse_index& operator=(const sparse_index&) = delete;
+
+    /** Dense position of `index`, or npos. */
+    [[nodiscard]] std::uint32_t find(std::uint32_t index) const noexcept
+    {
+        const std::size_t page = index / page_entries;
+        return page < pages_.size() && pages_[page] ? pages_[page][index % page_entries] : npos;
+    }
+
+    /** Maps an index that is not present yet, allocating its page on first use. */
+    void insert(std::uint32_t index, std::uint32_t position)
+    {
+        const std::size_t page = index / page_entries;
+        if (page >= pages_.size())
+        {
+            pages_.resize(page + 1, nullptr);
+            counts_.resize(page + 1, 0);
+        }
+        if (!pages_[page])
+        {
+            auto* values = static_cast<std::uint32_t*>(
+                pages_.get_allocator().resource()->allocate(page_bytes, page_alignment));
+            std::fill_n(values, page_entries, npos);
+            pages_[page] = values;
+        }
+        pages_[page][index % page_entries] = position;
+        ++counts_[page];
+    }
+
+    /** Moves an index that is already present to a new dense position. */
+    void assign(std::uint32_t index, std::uint32_t position) noexcept
+    {
+        pages_[index / page_entries][index % page_entries] = position;
+    }
+
+    /** Unmaps a present index; its page is kept for reuse even when this was its last index. */
+    void erase(std::uint32_t index) noexcept
+    {
+        const std::size_t page = index / page_entries;
+        pages_[page][index % page_entries] = npos;
+        --counts_[page];
+    }
+
+    /** Releases pages that no index maps into. */
+    void shrink_to_fit() noexcept
+    {
+        for (std::size_t page = 0; page < pages_.size(); ++page)
+        {
+            if (!pages_[page] || counts_[page] != 0) continue;
+            pages_.get_allocator().resource()->deallocate(pages_[page], page_bytes, page_alignment);
+            pages_[page] = nullptr;
+        }
+    }
+
+    /** Pages currently allocated. */
+    [[nodiscard]] std::size_t page_count() const noexcept
+    {
+        return static_cast<std::size_t>(
+            std::count_if(pages_.begin(), pages_.end(), [](const std::uint32_t* page) { return page != nullptr; }));
+    }
+
+private:
+    std::pmr::vector<std::uint32_t*> pages_;
+    // Mapped indices per page; shrink_to_fit releases pages whose count is zero.
+    std::pmr::vector<std::uint16_t> counts_;
+};
+
+} // namespace arc::ecs
@@ -6,13 +6,18 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -61,6 +66,56 @@ inline constexpr std::array fixed_system_phases{
     system_phase::ai,       system_phase::replication};
 
 struct system_descriptor;
+class system_context;
+
+/** Per-chunk state owned by the scheduler and reused across runs. */
+struct system_chunk_state
+{
+    std::unique_ptr<entity_command_buffer> commands;
+    std::vector<std::pair<entity, component_type_id>> written;
+};
+
+/**
+ * One slice of a query handed to a single worker by system_context::par_chunks. Writes are
+ * checked against the system's declared access like system_context::write, but their dirty marks
+ * are applied once every chunk has finished.
+ */
+class system_chunk
+{
+public:
+    std::span<const entity> entities() const noexcept
+    {
+        return entities_;
+    }
+    std::size_t index() const noexcept
+    {
+        return index_;
+    }
+    entity_command_buffer& commands() noexcept
+    {
+        return *state_->commands;
+    }
+    const system_context& context() const noexcept
+    {
+        return *context_;
+    }
+
+    template <class T> const T* read(entity value) const;
+    template <class T> T* write(entity value);
+
+private:
+    system_chunk(system_context& context, system_chunk_state& state, std::span<const entity> entities,
+                 std::size_t index) noexcept
+        : context_(&context), state_(&state), entities_(entities), index_(index)
+    {
+    }
+
+    system_context* context_{};
+    system_chunk_state* state_{};
+    std::span<const entity> entities_;
+    std::size_t index_{};
+    friend class system_context;
+};
 
 class system_context
 {
@@ -150,22 +205,52 @@ public:
         return owner_->template try_get<T>(value);
     }
 
+    static constexpr std::size_t default_chunk_size = 1024;
+
+    /**
+     * Runs function(system_chunk&) across the job system for chunks of at most `chunk_size`
+     * entities of the prepared query `Specifications...`. Chunks never straddle an archetype and
+     * are cut the same way every run. Each chunk records into its own command buffer, ordered
+     * after this system's main buffer by chunk index. The query must be prepared and declared
+     * with query_read/query_write access matching the system descriptor.
+     */
+    template <class... Specifications, class Function>
+    void par_chunks(Function&& function, std::size_t chunk_size = default_chunk_size);
+
+    /** par_chunks that calls function(entity, system_chunk&) for every entity. */
+    template <class... Specifications, class Function>
+    void par_each(Function&& function, std::size_t chunk_size = default_chunk_size)
+    {
+        par_chunks<Specifications...>(
+            [&function](system_chunk& chunk)
+            {
+                for (const entity value : chunk.entities())
+                    function(value, chunk);
+            },
+            chunk_size);
+    }
+
 private:
     system_context(world& owner, entity_command_buffer& commands, const system_execution_info& execution,
-                   const system_descriptor& descriptor)
-        : owner_(&owner), commands_(&commands), descriptor_(&descriptor), execution_(execution),
-          delta_seconds_(execution.delta_seconds)
+                   const system_descriptor& descriptor, jobs::job_system& jobs,
+                   std::vector<system_chunk_state>& chunks)
+        : owner_(&owner), commands_(&commands), descriptor_(&descriptor), jobs_(&jobs), chunks_(&chunks),
+          execution_(execution), delta_seconds_(execution.delta_seconds)
     {
     }
 
     void require_access(component_type_id component, component_access_mode requested) const;
+    template <class Specification> void require_query_access() const;
 
     world* owner_{};
     entity_command_buffer* commands_{};
     const system_descriptor* descriptor_{};
+    jobs::job_system* jobs_{};
+    std::vector<system_chunk_state>* chunks_{};
     system_execution_info execution_{};
     float delta_seconds_{};
     friend class system_scheduler;
+    friend class system_chunk;
 };
 
 struct system_descriptor
@@ -192,17 +277,101 @@ inline void system_context::require_access(component_type_id component, componen
                                (requested == component_access_mode::write ? "write" : "read") + " component access");
 }
 
+template <class Specification> void system_context::require_query_access() const
+{
+    using component = typename Specification::component;
+    if constexpr (std::is_same_v<Specification, query_write<component>>)
+        require_access(component_type<component>(), component_access_mode::write);
+    else if constexpr (!std::is_same_v<Specification, query_exclude<component>>)
+        require_access(component_type<component>(), component_access_mode::read);
+}
+
+template <class... Specifications, class Function>
+void system_context::par_chunks(Function&& function, std::size_t chunk_size)
+{
+    (require_query_access<Specifications>(), ...);
+    if (!owner_->template query_prepared<Specifications...>())
+        throw std::logic_error("system '" + descriptor_->name + "' ran par_chunks over an unprepared query");
+
+    chunk_size = std::max<std::size_t>(chunk_size, 1);
+    std::vector<std::span<const entity>> slices;
+    owner_->template query<Specifications...>().for_each_span(
+        [&](std::span<const entity> values)
+        {
+            for (std::size_t first = 0; first < values.size(); first += chunk_size)
+                slices.push_back(values.subspan(first, std::min(chunk_size, values.size() - first)));
+        });
+    const entity_command_buffer::sort_key key = commands_->key();
+    while (chunks_->size() < slices.size())
+    {
+        const auto partition = static_cast<std::uint32_t>(chunks_->size() + 1);
+        chunks_->push_back({std::make_unique<entity_command_buffer>(
+                                entity_command_buffer::sort_key{key.phase, key.system, partition}),
+                            {}});
+    }
+
+    jobs_->parallel_for(0, slices.size(), 1,
+                        [&](std::size_t begin, std::size_t end)
+                        {
+                            for (std::size_t index = begin; index < end; ++index)
+                            {
+                                system_chunk chunk(*this, (*chunks_)[index], slices[index], index);
+                                function(chunk);
+                            }
+                        });
+
+    // Applying marks in chunk order keeps change revisions independent of worker timing.
+    for (std::size_t index = 0; index < slices.size(); ++index)
+    {
+        auto& written = (*chunks_)[index].written;
+        for (const auto& [value, component] : written)
+            owner_->mark_dirty(value, component);
+        written.clear();
+    }
+}
+
+template <class T> const T* system_chunk::read(entity value) const
+{
+    context_->require_access(component_type<T>(), component_access_mode::read);
+    return std::as_const(*context_->owner_).template try_get<T>(value);
+}
+
+template <class T> T* system_chunk::write(entity value)
+{
+    context_->require_access(component_type<T>(), component_access_mode::write);
+    T* component = context_->owner_->template try_get_untracked<T>(value);
+    if (component) state_->written.emplace_back(value, component_type<T>());
+    return component;
+}
+
 struct system_schedule_error
 {
     std::string system;
     std::string message;
 };
 
+/** A component two systems access with at least one write, which forces them into different waves. */
+struct system_access_conflict
+{
+    component_type_id component{};
+    component_access_mode first{};
+    component_access_mode second{};
+};
+
+/** Wall time of one system's execute call; `system` names the scheduler-owned descriptor. */
+struct system_timing
+{
+    std::string_view system;
+    std::uint64_t nanoseconds{};
+};
+
 struct [[nodiscard]] system_run_result
 {
     std::size_t systems_executed{};
     command_flush_result commands;
     std::vector<system_schedule_error> errors;
+    /** Every system that ran, in registration order; names stay valid while the scheduler is unchanged. */
+    std::vector<system_timing> timings;
 
     bool succeeded() const noexcept
     {
@@ -210,10 +379,22 @@ struct [[nodiscard]] system_run_result
     }
 };
 
-/** Dependency- and access-aware scheduler layered on ARC's work-stealing jobs. */
+/**
+ * Dependency- and access-aware scheduler layered on ARC's work-stealing jobs. Once frozen, each phase
+ * runs as precompiled dependency waves: independent systems of a wave share one parallel_for that the
+ * calling thread joins, and systems measured as tiny on the previous run are fused into one batch.
+ */
 class system_scheduler
 {
 public:
+    /** Systems are packed into one wave batch until their last measured run times reach this total. */
+    static constexpr std::uint64_t fused_batch_nanoseconds = 50'000;
+
+    system_scheduler() = default;
+
+    /** Access bitsets use the frozen registry's runtime indices; unregistered components follow them. */
+    explicit system_scheduler(const component_type_registry& registry) : registry_(&registry) {}
+
     bool add(system_descriptor descriptor)
     {
         if (frozen_ || descriptor.name.empty() || !descriptor.execute || index_.contains(descriptor.name)) return false;
@@ -264,6 +445,42 @@ public:
         return errors;
     }
 
+    /**
+     * Component accesses that keep two systems of one phase from sharing a wave, e.g. `first` writing a
+     * component `second` reads. Empty when they are compatible, unknown, or in different phases.
+     */
+    [[nodiscard]] std::vector<system_access_conflict> access_conflicts(std::string_view first, std::string_view second)
+    {
+        std::vector<system_access_conflict> result;
+        const auto lhs = index_.find(std::string(first));
+        const auto rhs = index_.find(std::string(second));
+        if (lhs == index_.end() || rhs == index_.end() || lhs->second == rhs->second) return result;
+        const system_phase phase = systems_[lhs->second].phase;
+        if (systems_[rhs->second].phase != phase) return result;
+
+        compiled_phase& schedule = phase_schedules_[static_cast<std::size_t>(phase)];
+        if (!schedule.compiled) compile_phase(phase, schedule);
+        const std::size_t words = schedule.access_words;
+        const std::uint64_t* left_reads = schedule.reads.data() + schedule.positions[lhs->second] * words;
+        const std::uint64_t* left_writes = schedule.writes.data() + schedule.positions[lhs->second] * words;
+        const std::uint64_t* right_reads = schedule.reads.data() + schedule.positions[rhs->second] * words;
+        const std::uint64_t* right_writes = schedule.writes.data() + schedule.positions[rhs->second] * words;
+        for (std::size_t word = 0; word < words; ++word)
+        {
+            for (std::uint64_t blocked = (left_writes[word] & (right_reads[word] | right_writes[word])) |
+                                         (left_reads[word] & right_writes[word]);
+                 blocked != 0; blocked &= blocked - 1)
+            {
+                const auto bit = static_cast<std::size_t>(std::countr_zero(blocked));
+                const auto mode = [mask = std::uint64_t{1} << bit](std::uint64_t writes)
+                { return writes & mask ? component_access_mode::write : component_access_mode::read; };
+                result.push_back({schedule.access_components[word * 64 + bit], mode(left_writes[word]),
+                                  mode(right_writes[word])});
+            }
+        }
+        return result;
+    }
+
     system_run_result run(world& owner, jobs::job_system& jobs, float delta_seconds)
     {
         system_execution_info execution{};
@@ -277,6 +494,8 @@ public:
             aggregate.systems_executed += phase_result.systems_executed;
             aggregate.errors.insert(aggregate.errors.end(), std::make_move_iterator(phase_result.errors.begin()),
                                     std::make_move_iterator(phase_result.errors.end()));
+            aggregate.timings.insert(aggregate.timings.end(), phase_result.timings.begin(),
+                                     phase_result.timings.end());
             aggregate.commands.applied += phase_result.commands.applied;
             aggregate.commands.errors.insert(aggregate.commands.errors.end(),
                                              std::make_move_iterator(phase_result.commands.errors.begin()),
@@ -296,8 +515,7 @@ public:
         result.errors = schedule.errors;
         if (!result.errors.empty()) return result;
 
-        for (jobs::job_handle& handle : schedule.handles)
-            handle = {};
+        const bool waves = frozen_ && schedule.waves_supported && (!schedule.main_thread || jobs.is_main_thread());
         {
             owner.begin_scheduled_execution();
             struct scheduled_execution_scope
@@ -309,81 +527,57 @@ public:
                 }
             } scheduled_scope{&owner};
 
-            try
-            {
-                for (const std::size_t index : schedule.execution_order)
-                {
-                    std::vector<jobs::job_handle>& prerequisites = schedule.prerequisites[index];
-                    prerequisites.clear();
-                    for (const std::size_t dependency : schedule.dependencies[index])
-                        prerequisites.push_back(schedule.handles[dependency]);
-
-                    system_descriptor& system = systems_[index];
-                    schedule.handles[index] =
-                        jobs.submit({.name = system.name,
-                                     .priority = system.priority,
-                                     .affinity = system.affinity,
-                                     .dependencies = {},
-                                     .dependency_view = prerequisites,
-                                     .parent = {},
-                                     .cancellation = {},
-                                     .dependency_policy = jobs::job_dependency_policy::cancel_on_failure},
-                                    [&owner, &system, buffer = schedule.command_buffers[index].get(), execution]()
-                                    {
-                                        system_context context(owner, *buffer, execution, system);
-                                        system.execute(context);
-                                    });
-                }
-
-                for (const std::size_t index : schedule.selected)
-                {
-                    const jobs::job_wait_result wait = schedule.handles[index].wait_result();
-                    if (wait.succeeded())
-                    {
-                        ++result.systems_executed;
-                        continue;
-                    }
+            if (waves)
+                run_waves(owner, jobs, schedule, execution, result);
+            else
+                submit_jobs(owner, jobs, schedule, execution, result);
+        }
 
-                    std::string message =
-                        wait.status == jobs::job_status::cancelled ? "system was cancelled" : "system execution failed";
-                    if (wait.exception)
-                    {
-                        try
-                        {
-                            std::rethrow_exception(wait.exception);
-                        }
-                        catch (const std::exception& error)
-                        {
-                            message += ": ";
-                            message += error.what();
-                        }
-                        catch (...)
-                        {
-                        }
-                    }
-                    result.errors.push_back({systems_[index].name, std::move(message)});
-                }
-            }
-            catch (const std::exception& error)
-            {
-                for (const jobs::job_handle& handle : schedule.handles)
-                    if (handle.valid()) (void)handle.wait_result();
-                result.errors.push_back({{}, std::string("system scheduling failed: ") + error.what()});
-            }
+        for (const std::size_t index : schedule.selected)
+        {
+            const system_outcome outcome = schedule.outcomes[index];
+            if (outcome == system_outcome::succeeded || outcome == system_outcome::failed)
+                result.timings.push_back({systems_[index].name, schedule.durations[index]});
         }
 
         if (!result.errors.empty())
         {
             for (const std::size_t index : schedule.selected)
+            {
                 schedule.command_buffers[index]->clear();
+                for (system_chunk_state& chunk : schedule.chunk_states[index])
+                {
+                    chunk.commands->clear();
+                    chunk.written.clear();
+                }
+            }
             return result;
         }
 
-        result.commands = entity_command_buffer::flush_ordered(owner, schedule.buffer_views);
+        std::vector<entity_command_buffer*>& flush_views = schedule.flush_views;
+        flush_views.clear();
+        for (const std::size_t index : schedule.selected)
+            for (system_chunk_state& chunk : schedule.chunk_states[index])
+                if (!chunk.commands->empty()) flush_views.push_back(chunk.commands.get());
+        if (flush_views.empty())
+        {
+            result.commands = entity_command_buffer::flush_ordered(owner, schedule.buffer_views);
+            return result;
+        }
+        flush_views.insert(flush_views.end(), schedule.buffer_views.begin(), schedule.buffer_views.end());
+        result.commands = entity_command_buffer::flush_ordered(owner, flush_views);
         return result;
     }
 
 private:
+    enum class system_outcome : std::uint8_t
+    {
+        pending,
+        succeeded,
+        failed,
+        cancelled
+    };
+
     struct compiled_phase
     {
         bool compiled{};
@@ -392,18 +586,270 @@ private:
         std::vector<std::size_t> execution_order;
         std::vector<std::unique_ptr<entity_command_buffer>> command_buffers;
         std::vector<entity_command_buffer*> buffer_views;
+        std::vector<entity_command_buffer*> flush_views;
+        std::vector<std::vector<system_chunk_state>> chunk_states;
         std::vector<jobs::job_handle> handles;
         std::vector<std::vector<jobs::job_handle>> prerequisites;
         std::vector<system_schedule_error> errors;
+        /** Per system index, rewritten by every run. */
+        std::vector<std::uint64_t> durations;
+        std::vector<system_outcome> outcomes;
+        std::vector<std::string> failures;
+        /** Wave w runs wave_systems[wave_offsets[w], wave_offsets[w + 1]), main-thread systems first. */
+        std::vector<std::size_t> wave_systems;
+        std::vector<std::size_t> wave_offsets;
+        std::vector<std::size_t> wave_main_counts;
+        std::vector<std::size_t> batch_offsets;
+        /** Read and write bitsets per phase position, access_words each; bit b stands for access_components[b]. */
+        std::vector<component_type_id> access_components;
+        std::size_t access_words{};
+        std::vector<std::uint64_t> reads;
+        std::vector<std::uint64_t> writes;
+        /** Phase position by system index. */
+        std::vector<std::size_t> positions;
+        bool waves_supported{};
+        bool main_thread{};
     };
 
+    void submit_jobs(world& owner, jobs::job_system& jobs, compiled_phase& schedule,
+                     const system_execution_info& execution, system_run_result& result)
+    {
+        for (jobs::job_handle& handle : schedule.handles)
+            handle = {};
+        for (const std::size_t index : schedule.selected)
+            schedule.outcomes[index] = system_outcome::pending;
+        try
+        {
+            for (const std::size_t index : schedule.execution_order)
+            {
+                std::vector<jobs::job_handle>& prerequisites = schedule.prerequisites[index];
+                prerequisites.clear();
+                for (const std::size_t dependency : schedule.dependencies[index])
+                    prerequisites.push_back(schedule.handles[dependency]);
+
+                system_descriptor& system = systems_[index];
+                schedule.handles[index] =
+                    jobs.submit({.name = system.name,
+                                 .priority = system.priority,
+                                 .affinity = system.affinity,
+                                 .dependencies = {},
+                                 .dependency_view = prerequisites,
+                                 .parent = {},
+                                 .cancellation = {},
+                                 .dependency_policy = jobs::job_dependency_policy::cancel_on_failure},
+                                [&owner, &system, &jobs, buffer = schedule.command_buffers[index].get(),
+                                 chunks = &schedule.chunk_states[index], duration = &schedule.durations[index],
+                                 execution]()
+                                {
+                                    system_context context(owner, *buffer, execution, system, jobs, *chunks);
+                                    execute_timed(system, context, *duration);
+                                });
+            }
+
+            for (const std::size_t index : schedule.selected)
+            {
+                const jobs::job_wait_result wait = schedule.handles[index].wait_result();
+                if (wait.succeeded())
+                {
+                    schedule.outcomes[index] = system_outcome::succeeded;
+                    ++result.systems_executed;
+                    continue;
+                }
+
+                const bool cancelled = wait.status == jobs::job_status::cancelled;
+                schedule.outcomes[index] = cancelled ? system_outcome::cancelled : system_outcome::failed;
+                std::string message = cancelled ? "system was cancelled" : "system execution failed";
+                if (wait.exception)
+                {
+                    try
+                    {
+                        std::rethrow_exception(wait.exception);
+                    }
+                    catch (const std::exception& error)
+                    {
+                        message += ": ";
+                        message += error.what();
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+                result.errors.push_back({systems_[index].name, std::move(message)});
+            }
+        }
+        catch (const std::exception& error)
+        {
+            for (const jobs::job_handle& handle : schedule.handles)
+                if (handle.valid()) (void)handle.wait_result();
+            result.errors.push_back({{}, std::string("system scheduling failed: ") + error.what()});
+        }
+    }
+
+    /** Runs a frozen phase wave by wave; a system whose dependency did not succeed is cancelled like a job. */
+    void run_waves(world& owner, jobs::job_system& jobs, compiled_phase& schedule,
+                   const system_execution_info& execution, system_run_result& result)
+    {
+        for (const std::size_t index : schedule.selected)
+            schedule.outcomes[index] = system_outcome::pending;
+        const auto run_system = [&](std::size_t index) noexcept
+        {
+            for (const std::size_t dependency : schedule.dependencies[index])
+            {
+                if (schedule.outcomes[dependency] == system_outcome::succeeded) continue;
+                schedule.outcomes[index] = system_outcome::cancelled;
+                return;
+            }
+            system_descriptor& system = systems_[index];
+            try
+            {
+                system_context context(owner, *schedule.command_buffers[index], execution, system, jobs,
+                                       schedule.chunk_states[index]);
+                execute_timed(system, context, schedule.durations[index]);
+                schedule.outcomes[index] = system_outcome::succeeded;
+                return;
+            }
+            catch (const std::exception& error)
+            {
+                schedule.failures[index] = std::string("system execution failed: ") + error.what();
+            }
+            catch (...)
+            {
+                schedule.failures[index] = "system execution failed";
+            }
+            schedule.outcomes[index] = system_outcome::failed;
+        };
+
+        try
+        {
+            for (std::size_t wave = 0; wave + 1 < schedule.wave_offsets.size(); ++wave)
+            {
+                const std::size_t begin = schedule.wave_offsets[wave];
+                const std::size_t workers = begin + schedule.wave_main_counts[wave];
+                const std::size_t end = schedule.wave_offsets[wave + 1];
+                for (std::size_t position = begin; position < workers; ++position)
+                    run_system(schedule.wave_systems[position]);
+                if (workers == end) continue;
+
+                // Pack consecutive systems until last run's cost reaches the target; unmeasured ones run alone.
+                auto& batches = schedule.batch_offsets;
+                batches.assign(1, workers);
+                std::uint64_t cost{};
+                for (std::size_t position = workers; position < end; ++position)
+                {
+                    const std::uint64_t duration = schedule.durations[schedule.wave_systems[position]];
+                    if (position != batches.back() && (duration == 0 || cost + duration > fused_batch_nanoseconds))
+                    {
+                        batches.push_back(position);
+                        cost = 0;
+                    }
+                    cost += duration == 0 ? fused_batch_nanoseconds : duration;
+                }
+                batches.push_back(end);
+
+                const auto run_batches = [&](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t batch = first; batch < last; ++batch)
+                        for (std::size_t position = batches[batch]; position < batches[batch + 1]; ++position)
+                            run_system(schedule.wave_systems[position]);
+                };
+                if (batches.size() == 2)
+                    run_batches(0, 1);
+                else
+                    jobs.parallel_for(0, batches.size() - 1, 1, run_batches);
+            }
+        }
+        catch (const std::exception& error)
+        {
+            result.errors.push_back({{}, std::string("system scheduling failed: ") + error.what()});
+            return;
+        }
+
+        for (const std::size_t index : schedule.selected)
+        {
+            switch (schedule.outcomes[index])
+            {
+                case system_outcome::succeeded:
+                    ++result.systems_executed;
+                    break;
+                case system_outcome::failed:
+                    result.errors.push_back({systems_[index].name, std::move(schedule.failures[index])});
+                    break;
+                default:
+                    result.errors.push_back({systems_[index].name, "system was cancelled"});
+                    break;
+            }
+        }
+    }
+
+    static void execute_timed(system_descriptor& system, system_context& context, std::uint64_t& duration)
+    {
+        const auto started = std::chrono::steady_clock::now();
+        const auto elapsed = [started]
+        {
+            return static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started)
+                    .count());
+        };
+        try
+        {
+            system.execute(context);
+        }
+        catch (...)
+        {
+            duration = elapsed();
+            throw;
+        }
+        duration = elapsed();
+    }
+
+    /** Groups the phase into waves by longest dependency path; systems of one wave never depend on each other. */
+    void compile_waves(compiled_phase& schedule) const
+    {
+        schedule.waves_supported = true;
+        std::vector<std::size_t> levels(systems_.size());
+        std::size_t wave_count{};
+        for (const std::size_t index : schedule.execution_order)
+        {
+            const jobs::job_affinity affinity = systems_[index].affinity;
+            if (affinity == jobs::job_affinity::main_thread)
+                schedule.main_thread = true;
+            else if (affinity != jobs::job_affinity::any_worker)
+                schedule.waves_supported = false;
+            for (const std::size_t dependency : schedule.dependencies[index])
+                levels[index] = std::max(levels[index], levels[dependency] + 1);
+            wave_count = std::max(wave_count, levels[index] + 1);
+        }
+
+        schedule.wave_offsets.assign(wave_count + 1, 0);
+        schedule.wave_main_counts.assign(wave_count, 0);
+        for (const std::size_t index : schedule.execution_order)
+            ++schedule.wave_offsets[levels[index] + 1];
+        for (std::size_t wave = 0; wave < wave_count; ++wave)
+            schedule.wave_offsets[wave + 1] += schedule.wave_offsets[wave];
+        schedule.wave_systems.resize(schedule.execution_order.size());
+        std::vector<std::size_t> cursor(schedule.wave_offsets.begin(), schedule.wave_offsets.end() - 1);
+        for (const bool main_thread : {true, false})
+        {
+            for (const std::size_t index : schedule.execution_order)
+            {
+                if ((systems_[index].affinity == jobs::job_affinity::main_thread) != main_thread) continue;
+                schedule.wave_systems[cursor[levels[index]]++] = index;
+                if (main_thread) ++schedule.wave_main_counts[levels[index]];
+            }
+        }
+    }
+
     void compile_phase(system_phase phase, compiled_phase& schedule)
     {
         schedule = {};
         schedule.dependencies.resize(systems_.size());
         schedule.command_buffers.resize(systems_.size());
+        schedule.chunk_states.resize(systems_.size());
         schedule.handles.resize(systems_.size());
         schedule.prerequisites.resize(systems_.size());
+        schedule.durations.resize(systems_.size());
+        schedule.outcomes.resize(systems_.size());
+        schedule.failures.resize(systems_.size());
         for (std::size_t index = 0; index < systems_.size(); ++index)
         {
             if (systems_[index].phase != phase) continue;
@@ -411,7 +857,8 @@ private:
             schedule.command_buffers[index] = std::make_unique<entity_command_buffer>(entity_command_buffer::sort_key{
                 static_cast<std::uint32_t>(phase), static_cast<std::uint32_t>(index), 0});
         }
-        build_phase_dependencies(phase, schedule.dependencies, schedule.errors);
+        build_access_sets(schedule);
+        build_phase_dependencies(phase, schedule);
         if (schedule.errors.empty() && has_cycle(schedule.dependencies))
             schedule.errors.push_back({{}, "system dependency graph contains a cycle"});
         if (schedule.errors.empty())
@@ -421,6 +868,7 @@ private:
                                                           schedule.execution_order.end(), [&](std::size_t index)
                                                           { return systems_[index].phase != phase; }),
                                            schedule.execution_order.end());
+            compile_waves(schedule);
         }
         for (const std::size_t index : schedule.selected)
         {
@@ -436,71 +884,94 @@ private:
             schedule.compiled = false;
     }
 
-    static bool conflicts(const system_descriptor& lhs, const system_descriptor& rhs)
+    /** Assigns each accessed component a bit and fills the per-system read and write sets. */
+    void build_access_sets(compiled_phase& schedule) const
     {
-        for (const component_access& left : lhs.components)
-            for (const component_access& right : rhs.components)
-                if (left.component == right.component &&
-                    (left.mode == component_access_mode::write || right.mode == component_access_mode::write))
-                    return true;
-        return false;
-    }
+        std::vector<component_type_id>& components = schedule.access_components;
+        const bool registered = registry_ && registry_->frozen();
+        if (registered)
+            for (runtime_component_index index = 0; index < registry_->size(); ++index)
+                components.push_back(registry_->descriptor(index)->id);
+        const std::size_t local_begin = components.size();
+        for (const std::size_t index : schedule.selected)
+            for (const component_access& access : systems_[index].components)
+                if (!registered || registry_->runtime_index(access.component) == invalid_runtime_component_index)
+                    components.push_back(access.component);
+        std::sort(components.begin() + static_cast<std::ptrdiff_t>(local_begin), components.end());
+        components.erase(std::unique(components.begin() + static_cast<std::ptrdiff_t>(local_begin), components.end()),
+                         components.end());
 
-    void build_dependencies(std::vector<std::vector<std::size_t>>& dependencies,
-                            std::vector<system_schedule_error>& errors) const
-    {
-        for (std::size_t index = 0; index < systems_.size(); ++index)
+        const std::size_t words = (components.size() + 63) / 64;
+        schedule.access_words = words;
+        schedule.reads.assign(schedule.selected.size() * words, 0);
+        schedule.writes.assign(schedule.selected.size() * words, 0);
+        schedule.positions.assign(systems_.size(), 0);
+        for (std::size_t position = 0; position < schedule.selected.size(); ++position)
         {
-            const system_descriptor& system = systems_[index];
-            for (const std::string& name : system.after)
-            {
-                const auto found = index_.find(name);
-                if (found == index_.end())
-                    errors.push_back({system.name, "unknown after dependency '" + name + "'"});
-                else
-                    dependencies[index].push_back(found->second);
-            }
-            for (const std::string& name : system.before)
+            const std::size_t index = schedule.selected[position];
+            schedule.positions[index] = position;
+            for (const component_access& access : systems_[index].components)
             {
-                const auto found = index_.find(name);
-                if (found == index_.end())
-                    errors.push_back({system.name, "unknown before dependency '" + name + "'"});
-                else
-                    dependencies[found->second].push_back(index);
+                std::size_t bit = registered ? registry_->runtime_index(access.component)
+                                             : invalid_runtime_component_index;
+                if (bit == invalid_runtime_component_index)
+                    bit = static_cast<std::size_t>(
+                        std::lower_bound(components.begin() + static_cast<std::ptrdiff_t>(local_begin),
+                                         components.end(), access.component) -
+                        components.begin());
+                auto& set = access.mode == component_access_mode::write ? schedule.writes : schedule.reads;
+                set[position * words + bit / 64] |= std::uint64_t{1} << (bit % 64);
             }
         }
+    }
 
-        for (std::size_t right = 0; right < systems_.size(); ++right)
+    /**
+     * Explicit ordering first, then one edge per conflicting pair in registration order unless the pair is
+     * already ordered transitively. Ancestor and descendant bitsets keep that test O(1) and drop redundant edges.
+     */
+    void build_phase_dependencies(system_phase phase, compiled_phase& schedule) const
+    {
+        std::vector<std::vector<std::size_t>>& dependencies = schedule.dependencies;
+        std::vector<system_schedule_error>& errors = schedule.errors;
+        const std::size_t count = schedule.selected.size();
+        const std::size_t words = (count + 63) / 64;
+        std::vector<std::uint64_t> ancestors(count * words);
+        std::vector<std::uint64_t> descendants(count * words);
+        const auto test = [words](const std::vector<std::uint64_t>& sets, std::size_t set, std::size_t bit)
+        { return (sets[set * words + bit / 64] >> (bit % 64) & 1u) != 0; };
+        const auto order = [&](std::size_t dependent, std::size_t prerequisite)
         {
-            for (std::size_t left = 0; left < systems_.size(); ++left)
+            const std::size_t after = schedule.positions[dependent];
+            const std::size_t before = schedule.positions[prerequisite];
+            if (test(ancestors, after, before)) return;
+            dependencies[dependent].push_back(prerequisite);
+            // Everything up to and including `before` now precedes `after` and everything after it.
+            for (std::size_t position = 0; position < count; ++position)
             {
-                if (left == right) continue;
-                if (systems_[left].phase < systems_[right].phase)
-                    dependencies[right].push_back(left);
-                else if (left < right && systems_[left].phase == systems_[right].phase &&
-                         conflicts(systems_[left], systems_[right]) && !depends_on(dependencies, left, right))
-                    dependencies[right].push_back(left);
+                if (position != after && !test(descendants, after, position)) continue;
+                for (std::size_t word = 0; word < words; ++word)
+                    ancestors[position * words + word] |= ancestors[before * words + word];
+                ancestors[position * words + before / 64] |= std::uint64_t{1} << (before % 64);
             }
-            auto& values = dependencies[right];
-            std::sort(values.begin(), values.end());
-            values.erase(std::unique(values.begin(), values.end()), values.end());
-        }
-    }
+            for (std::size_t position = 0; position < count; ++position)
+            {
+                if (position != before && !test(ancestors, before, position)) continue;
+                for (std::size_t word = 0; word < words; ++word)
+                    descendants[position * words + word] |= descendants[after * words + word];
+                descendants[position * words + after / 64] |= std::uint64_t{1} << (after % 64);
+            }
+        };
 
-    void build_phase_dependencies(system_phase phase, std::vector<std::vector<std::size_t>>& dependencies,
-                                  std::vector<system_schedule_error>& errors) const
-    {
-        for (std::size_t index = 0; index < systems_.size(); ++index)
+        for (const std::size_t index : schedule.selected)
         {
             const system_descriptor& system = systems_[index];
-            if (system.phase != phase) continue;
             for (const std::string& name : system.after)
             {
                 const auto found = index_.find(name);
                 if (found == index_.end())
                     errors.push_back({system.name, "unknown after dependency '" + name + "'"});
                 else if (systems_[found->second].phase == phase)
-                    dependencies[index].push_back(found->second);
+                    order(index, found->second);
                 else if (systems_[found->second].phase > phase)
                     errors.push_back({system.name, "after dependency '" + name + "' is in a later system phase"});
             }
@@ -510,22 +981,37 @@ private:
                 if (found == index_.end())
                     errors.push_back({system.name, "unknown before dependency '" + name + "'"});
                 else if (systems_[found->second].phase == phase)
-                    dependencies[found->second].push_back(index);
+                    order(found->second, index);
                 else if (systems_[found->second].phase < phase)
                     errors.push_back({system.name, "before dependency '" + name + "' is in an earlier system phase"});
             }
         }
 
-        for (std::size_t right = 0; right < systems_.size(); ++right)
+        const std::size_t access_words = schedule.access_words;
+        const auto conflicting = [&](std::size_t left, std::size_t right)
+        {
+            const std::uint64_t* left_reads = schedule.reads.data() + left * access_words;
+            const std::uint64_t* left_writes = schedule.writes.data() + left * access_words;
+            const std::uint64_t* right_reads = schedule.reads.data() + right * access_words;
+            const std::uint64_t* right_writes = schedule.writes.data() + right * access_words;
+            for (std::size_t word = 0; word < access_words; ++word)
+                if ((left_writes[word] & (right_reads[word] | right_writes[word])) |
+                    (left_reads[word] & right_writes[word]))
+                    return true;
+            return false;
+        };
+        for (std::size_t right = 0; right < count; ++right)
         {
-            if (systems_[right].phase != phase) continue;
             for (std::size_t left = 0; left < right; ++left)
             {
-                if (systems_[left].phase == phase && conflicts(systems_[left], systems_[right]) &&
-                    !depends_on(dependencies, left, right))
-                    dependencies[right].push_back(left);
+                // An explicit order running `right` first wins over registration order.
+                if (conflicting(left, right) && !test(ancestors, left, right))
+                    order(schedule.selected[right], schedule.selected[left]);
             }
-            auto& values = dependencies[right];
+        }
+        for (const std::size_t index : schedule.selected)
+        {
+            auto& values = dependencies[index];
             std::sort(values.begin(), values.end());
             values.erase(std::unique(values.begin(), values.end()), values.end());
         }
@@ -555,17 +1041,6 @@ private:
         return false;
     }
 
-    static bool depends_on(const std::vector<std::vector<std::size_t>>& dependencies, std::size_t system,
-                           std::size_t candidate, std::size_t depth = 0)
-    {
-        if (system >= dependencies.size() || depth >= dependencies.size()) return false;
-        for (const std::size_t dependency : dependencies[system])
-        {
-            if (dependency == candidate || depends_on(dependencies, dependency, candidate, depth + 1)) return true;
-        }
-        return false;
-    }
-
     static std::vector<std::size_t> topological_order(const std::vector<std::vector<std::size_t>>& dependencies)
     {
         std::vector<std::size_t> indegree(dependencies.size());
@@ -576,22 +1051,23 @@ private:
             for (const std::size_t dependency : dependencies[index])
                 dependents[dependency].push_back(index);
         }
+        // Min-heap, so ready systems leave in registration order.
         std::vector<std::size_t> ready;
         for (std::size_t index = 0; index < indegree.size(); ++index)
             if (indegree[index] == 0) ready.push_back(index);
         std::vector<std::size_t> result;
+        result.reserve(dependencies.size());
         while (!ready.empty())
         {
-            const std::size_t current = ready.front();
-            ready.erase(ready.begin());
+            std::pop_heap(ready.begin(), ready.end(), std::greater<>{});
+            const std::size_t current = ready.back();
+            ready.pop_back();
             result.push_back(current);
             for (const std::size_t dependent : dependents[current])
             {
-                if (--indegree[dependent] == 0)
-                {
-                    const auto insertion = std::lower_bound(ready.begin(), ready.end(), dependent);
-                    ready.insert(insertion, dependent);
-                }
+                if (--indegree[dependent] != 0) continue;
+                ready.push_back(dependent);
+                std::push_heap(ready.begin(), ready.end(), std::greater<>{});
             }
         }
         return result;
@@ -604,6 +1080,7 @@ private:
             index_.emplace(systems_[index].name, index);
     }
 
+    const component_type_registry* registry_{};
     std::vector<system_descriptor> systems_;
     std::unordered_map<std::string, std::size_t> index_;
     std::array<compiled_phase, static_cast<std::size_t>(system_phase::presentation_extraction) + 1> phase_schedules_;
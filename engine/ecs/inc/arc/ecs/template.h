@@ -4,6 +4,8 @@
 
 #include <functional>
 #include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -18,6 +20,8 @@ public:
     {
         component_type_id type{};
         std::function<void(entity_command_buffer&, entity_target)> construct;
+        /** Optional column-wise path for `world::create_batch`; without it each entity goes through `construct`. */
+        std::function<void(world&, std::span<const entity>)> construct_batch;
     };
 
     std::string name;
@@ -46,9 +50,10 @@ public:
 
     template <class T> entity_template_builder& component(T value = {})
     {
-        value_.components.push_back({component_type<T>(), [value = std::move(value)](entity_command_buffer& commands,
-                                                                                     entity_target target) mutable
-                                     { commands.add<T>(target, value); }});
+        value_.components.push_back(
+            {component_type<T>(),
+             [value](entity_command_buffer& commands, entity_target target) { commands.add<T>(target, value); },
+             [value](world& owner, std::span<const entity> targets) { owner.emplace_batch<T>(targets, value); }});
         return *this;
     }
 
@@ -67,4 +72,31 @@ private:
     entity_template value_;
 };
 
+inline void world::create_batch(const entity_template& prototype, std::size_t count, std::span<entity> out)
+{
+    with_deferred_query_refresh(
+        [&]
+        {
+            create_batch(count, out);
+            const std::span<const entity> created = out.first(count);
+            for (const entity_template::component_factory& component : prototype.components)
+            {
+                if (component.construct_batch)
+                {
+                    component.construct_batch(*this, created);
+                    continue;
+                }
+                entity_command_buffer commands;
+                for (const entity value : created)
+                    component.construct(commands, value);
+                const command_flush_result result = commands.flush(*this);
+                if (!result.errors.empty()) throw std::runtime_error(result.errors.front().message);
+            }
+            // Children are instantiated per root like `entity_template::instantiate`, leaving binding to the scene.
+            std::vector<entity> children(count);
+            for (const entity_template& child : prototype.children)
+                create_batch(child, count, children);
+        });
+}
+
 } // namespace arc::ecs
@@ -1,20 +1,25 @@
 #pragma once
 
+#include <arc/ecs/archetype.h>
 #include <arc/ecs/entity.h>
 #include <arc/ecs/reflection.h>
+#include <arc/ecs/sparse_index.h>
 #include <arc/memory/memory.h>
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <memory_resource>
 #include <span>
 #include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -37,12 +42,20 @@ enum class structural_change_kind : std::uint8_t
     component_removed
 };
 
+/**
+ * One structural edit. Batch operations coalesce an edit applied to many
+ * entities into a single range record; `world::structural_entities` lists
+ * the entities it covers, and `value` is the first of them.
+ */
 struct structural_change
 {
     change_revision revision{};
     structural_change_kind kind{};
     entity value{};
     component_type_id component{};
+    std::uint32_t count{1};
+    // Range records only: offset of the covered entities in the world's batch entity list.
+    std::uint32_t batch_offset{};
 };
 
 struct component_change
@@ -52,6 +65,53 @@ struct component_change
     std::uint64_t fields{};
 };
 
+/** How a component pool lays out its values. */
+enum class component_storage : std::uint8_t
+{
+    /** Values keep their address until removed; views follow one pointer per value. */
+    stable,
+    /** Values are packed in dense order in 16 KiB pages; removing one moves the last value into its slot. */
+    dense
+};
+
+/** Specialize with `storage = component_storage::dense` for components iterated far more than addressed. */
+template <class T> struct component_storage_traits
+{
+    static constexpr component_storage storage = component_storage::stable;
+};
+
+class component_pool_base;
+
+/**
+ * One pool's values captured page by page. Pages are immutable once captured
+ * and shared with later snapshots of the same pool until the pool touches them.
+ */
+class component_pool_snapshot
+{
+public:
+    virtual ~component_pool_snapshot() = default;
+    [[nodiscard]] virtual const component_descriptor& descriptor() const noexcept = 0;
+    [[nodiscard]] virtual std::unique_ptr<component_pool_base> restore(std::pmr::memory_resource* resource) const = 0;
+
+    std::uint64_t pool_id{};
+    std::size_t copied_bytes{};
+    std::size_t shared_bytes{};
+};
+
+/** Values of one component type for a set of entities, with the entities that lacked it. */
+class component_values
+{
+public:
+    virtual ~component_values() = default;
+    /** Writes the values into `pool`, which must store the same type, and removes it from the absent entities. */
+    virtual void apply(component_pool_base& pool, change_revision revision) const = 0;
+    [[nodiscard]] virtual const component_descriptor& descriptor() const noexcept = 0;
+    [[nodiscard]] virtual std::unique_ptr<component_pool_base> make_pool(std::pmr::memory_resource* resource) const = 0;
+    /** Every entity covered, present or absent. */
+    [[nodiscard]] virtual std::span<const entity> entities() const noexcept = 0;
+    [[nodiscard]] virtual std::size_t bytes() const noexcept = 0;
+};
+
 class component_pool_base
 {
 public:
@@ -61,28 +121,44 @@ public:
     virtual bool remove(entity value) = 0;
     [[nodiscard]] virtual bool contains(entity value) const noexcept = 0;
     [[nodiscard]] virtual std::span<const entity> entities() const noexcept = 0;
-    virtual void ensure_entity_capacity(std::size_t size) = 0;
     virtual void mark(entity value, change_revision revision, std::uint64_t fields) = 0;
     [[nodiscard]] virtual component_change change(entity value) const noexcept = 0;
     [[nodiscard]] virtual std::span<const component_change> change_events() const noexcept = 0;
     [[nodiscard]] virtual std::unique_ptr<component_pool_base> clone(std::pmr::memory_resource* resource) const = 0;
+    /** Captures the pool, sharing every page unchanged since `previous` when that came from this pool. */
+    [[nodiscard]] virtual std::shared_ptr<const component_pool_snapshot>
+    snapshot(const component_pool_snapshot* previous) const = 0;
+    /** Copies the values `entities` hold now and notes the entities without one. */
+    [[nodiscard]] virtual std::unique_ptr<component_values> capture_values(std::span<const entity> entities) const = 0;
+    /** Releases index pages that removals left empty. */
+    virtual void shrink_to_fit() noexcept = 0;
+
+protected:
+    static std::uint64_t next_pool_id() noexcept
+    {
+        static std::atomic<std::uint64_t> value{1};
+        return value.fetch_add(1, std::memory_order_relaxed);
+    }
 };
 
 template <class T> class component_pool final : public component_pool_base
 {
 public:
+    static constexpr bool dense_storage = component_storage_traits<T>::storage == component_storage::dense;
+
     explicit component_pool(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
         : resource_(resource ? resource : std::pmr::get_default_resource()), sparse_(resource_), entities_(resource_),
-          dense_(resource_), changes_(resource_), change_events_(resource_), pages_(resource_), free_slots_(resource_)
+          values_(resource_), metadata_(resource_), change_events_(resource_), pages_(resource_),
+          free_values_(resource_), page_versions_(resource_)
     {
     }
 
     ~component_pool() override
     {
-        for (T* value : dense_)
-            std::destroy_at(value);
-        for (slot* page : pages_)
-            resource_->deallocate(page, sizeof(slot) * page_size, alignof(slot));
+        for (std::size_t index = 0; index < entities_.size(); ++index)
+            std::destroy_at(&at(index));
+        for (std::byte* page : pages_)
+            resource_->deallocate(page, page_bytes, alignof(T));
     }
 
     component_pool(const component_pool&) = delete;
@@ -97,30 +173,73 @@ public:
             return {get(value), false};
         }
 
-        if (free_slots_.empty()) add_page();
-        slot* storage = free_slots_.back();
-        free_slots_.pop_back();
-        T* component = reinterpret_cast<T*>(storage->storage);
+        if (entities_.size() >= sparse_index::npos) throw std::length_error("component pool exceeds 32-bit indices");
+        T* component = allocate_value();
         std::construct_at(component, T{std::forward<Args>(args)...});
-        storage->occupied = true;
-        storage->revision = revision;
-        storage->fields = all_fields;
-
-        sparse_[value.index] = dense_.size();
+        if (entities_.size() / page_capacity == page_versions_.size()) page_versions_.push_back(0);
+        touch(entities_.size());
+        sparse_.insert(value.index, static_cast<std::uint32_t>(entities_.size()));
         entities_.push_back(value);
-        dense_.push_back(component);
-        changes_.push_back(storage);
+        if constexpr (!dense_storage) values_.push_back(component);
+        metadata_.push_back({revision, all_fields});
         change_events_.push_back({value, revision, all_fields});
         return {*component, true};
     }
 
+    /** Makes room for `additional` new values so a batch of emplaces allocates at most once per array. */
+    void reserve(std::size_t additional)
+    {
+        const std::size_t size = entities_.size() + additional;
+        entities_.reserve(size);
+        metadata_.reserve(size);
+        change_events_.reserve(change_events_.size() + additional);
+        if constexpr (dense_storage)
+        {
+            while (pages_.size() * page_capacity < size)
+                add_page();
+        }
+        else
+        {
+            values_.reserve(size);
+            while (free_values_.size() < additional)
+                add_page();
+        }
+    }
+
+    /** Value at a dense index, matching `entities()[index]`. */
+    [[nodiscard]] T& at(std::size_t index) noexcept
+    {
+        if constexpr (dense_storage)
+            return *value_address(index);
+        else
+            return *values_[index];
+    }
+    [[nodiscard]] const T& at(std::size_t index) const noexcept
+    {
+        return const_cast<component_pool&>(*this).at(index);
+    }
+
+    /** Values stored back to back from dense index `first`: the rest of its page, or one value when stable. */
+    [[nodiscard]] std::span<const T> contiguous(std::size_t first) const noexcept
+    {
+        if constexpr (dense_storage)
+        {
+            const std::size_t end = std::min(entities_.size(), (first / page_capacity + 1) * page_capacity);
+            return {value_address(first), end - first};
+        }
+        else
+        {
+            return {values_[first], 1};
+        }
+    }
+
     [[nodiscard]] T& get(entity value)
     {
-        return *dense_[sparse_[value.index]];
+        return at(sparse_.find(value.index));
     }
     [[nodiscard]] const T& get(entity value) const
     {
-        return *dense_[sparse_[value.index]];
+        return at(sparse_.find(value.index));
     }
     [[nodiscard]] T* try_get(entity value)
     {
@@ -135,34 +254,48 @@ public:
     {
         if (!contains(value)) return false;
 
-        const std::size_t removed = sparse_[value.index];
-        const std::size_t last = dense_.size() - 1;
-        T* removed_component = dense_[removed];
-        slot* removed_slot = changes_[removed];
+        const std::uint32_t removed = sparse_.find(value.index);
+        const std::size_t last = entities_.size() - 1;
+        touch(removed);
+        touch(last);
+        if constexpr (dense_storage)
+        {
+            T* hole = value_address(removed);
+            T* tail = value_address(last);
+            if (removed != last)
+            {
+                std::destroy_at(hole);
+                std::construct_at(hole, std::move(*tail));
+            }
+            std::destroy_at(tail);
+        }
+        else
+        {
+            T* removed_component = values_[removed];
+            values_[removed] = values_[last];
+            values_.pop_back();
+            std::destroy_at(removed_component);
+            free_values_.push_back(removed_component);
+        }
         if (removed != last)
         {
-            dense_[removed] = dense_[last];
-            changes_[removed] = changes_[last];
+            metadata_[removed] = metadata_[last];
             entities_[removed] = entities_[last];
-            sparse_[entities_[removed].index] = removed;
+            sparse_.assign(entities_[removed].index, removed);
         }
 
-        dense_.pop_back();
-        changes_.pop_back();
+        metadata_.pop_back();
         entities_.pop_back();
-        sparse_[value.index] = invalid_sparse;
-        std::destroy_at(removed_component);
-        removed_slot->occupied = false;
-        removed_slot->revision = 0;
-        removed_slot->fields = 0;
-        free_slots_.push_back(removed_slot);
+        if (entities_.size() % page_capacity == 0) page_versions_.pop_back();
+        sparse_.erase(value.index);
         return true;
     }
 
     [[nodiscard]] bool contains(entity value) const noexcept override
     {
-        return value.valid() && value.index < sparse_.size() && sparse_[value.index] != invalid_sparse &&
-               entities_[sparse_[value.index]] == value;
+        if (!value.valid()) return false;
+        const std::uint32_t position = sparse_.find(value.index);
+        return position != sparse_index::npos && entities_[position] == value;
     }
 
     [[nodiscard]] component_type_id type() const noexcept override
@@ -179,15 +312,12 @@ public:
         return {entities_.data(), entities_.size()};
     }
 
-    void ensure_entity_capacity(std::size_t size) override
-    {
-        if (sparse_.size() < size) sparse_.resize(size, invalid_sparse);
-    }
-
     void mark(entity value, change_revision revision, std::uint64_t fields) override
     {
         if (!contains(value)) return;
-        slot& metadata = *changes_[sparse_[value.index]];
+        const std::uint32_t position = sparse_.find(value.index);
+        touch(position);
+        value_metadata& metadata = metadata_[position];
         metadata.revision = revision;
         metadata.fields |= fields;
         change_events_.push_back({value, revision, fields});
@@ -196,7 +326,7 @@ public:
     [[nodiscard]] component_change change(entity value) const noexcept override
     {
         if (!contains(value)) return {};
-        const slot& metadata = *changes_[sparse_[value.index]];
+        const value_metadata& metadata = metadata_[sparse_.find(value.index)];
         return {value, metadata.revision, metadata.fields};
     }
 
@@ -205,17 +335,20 @@ public:
         return {change_events_.data(), change_events_.size()};
     }
 
+    void shrink_to_fit() noexcept override
+    {
+        sparse_.shrink_to_fit();
+    }
+
     [[nodiscard]] std::unique_ptr<component_pool_base> clone(std::pmr::memory_resource* resource) const override
     {
         auto result = std::make_unique<component_pool<T>>(resource);
-        result->ensure_entity_capacity(sparse_.size());
-        for (std::size_t index = 0; index < dense_.size(); ++index)
+        result->reserve(entities_.size());
+        for (std::size_t index = 0; index < entities_.size(); ++index)
         {
-            const slot& source = *changes_[index];
-            auto [_, inserted] = result->emplace(entities_[index], source.revision, *dense_[index]);
+            auto [_, inserted] = result->emplace(entities_[index], metadata_[index].revision, at(index));
             (void)inserted;
-            slot& destination = *result->changes_[index];
-            destination.fields = source.fields;
+            result->metadata_[index].fields = metadata_[index].fields;
         }
         // A cloned world is a new observation baseline. Retaining the complete
         // source journal makes editor/history snapshots progressively more
@@ -224,38 +357,191 @@ public:
         return result;
     }
 
+    [[nodiscard]] std::unique_ptr<component_values> capture_values(std::span<const entity> entities) const override
+    {
+        auto result = std::make_unique<entity_values>();
+        result->covered.assign(entities.begin(), entities.end());
+        for (const entity value : entities)
+        {
+            if (!contains(value)) continue;
+            result->present.push_back(value);
+            result->values.push_back(get(value));
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::shared_ptr<const component_pool_snapshot>
+    snapshot(const component_pool_snapshot* previous) const override
+    {
+        // Pool ids are unique per instance, so a matching id also guarantees the snapshot's value type.
+        const auto* earlier =
+            previous && previous->pool_id == pool_id_ ? static_cast<const pool_snapshot*>(previous) : nullptr;
+        auto result = std::make_shared<pool_snapshot>();
+        result->pool_id = pool_id_;
+        result->size = entities_.size();
+        result->pages.reserve(page_versions_.size());
+        for (std::size_t page = 0; page < page_versions_.size(); ++page)
+        {
+            if (earlier && page < earlier->pages.size() && earlier->pages[page]->version == page_versions_[page])
+            {
+                result->pages.push_back(earlier->pages[page]);
+                result->shared_bytes += earlier->pages[page]->bytes();
+                continue;
+            }
+            const std::size_t first = page * page_capacity;
+            const std::size_t last = std::min(entities_.size(), first + page_capacity);
+            auto copy = std::make_shared<snapshot_page>();
+            copy->version = page_versions_[page];
+            copy->entities.assign(entities_.begin() + first, entities_.begin() + last);
+            copy->metadata.assign(metadata_.begin() + first, metadata_.begin() + last);
+            copy->values.reserve(last - first);
+            for (std::size_t index = first; index < last; ++index)
+                copy->values.push_back(at(index));
+            result->copied_bytes += copy->bytes();
+            result->pages.push_back(std::move(copy));
+        }
+        return result;
+    }
+
 private:
-    static constexpr std::size_t invalid_sparse = static_cast<std::size_t>(-1);
-    static constexpr std::size_t page_size = 256;
+    static constexpr std::size_t page_capacity =
+        dense_storage ? std::bit_floor(std::max<std::size_t>(16384 / sizeof(T), 1)) : 256;
+    static constexpr std::size_t page_bytes = sizeof(T) * page_capacity;
     static constexpr std::uint64_t all_fields = ~std::uint64_t{};
 
-    struct alignas(alignof(T) > alignof(std::uint64_t) ? alignof(T) : alignof(std::uint64_t)) slot
+    struct value_metadata
     {
-        alignas(T) std::byte storage[sizeof(T)];
         change_revision revision{};
         std::uint64_t fields{};
-        bool occupied{};
     };
 
+    class entity_values final : public component_values
+    {
+    public:
+        void apply(component_pool_base& pool, change_revision revision) const override
+        {
+            auto& target = static_cast<component_pool<T>&>(pool);
+            std::size_t next{};
+            for (const entity value : covered)
+            {
+                if (next < present.size() && present[next] == value)
+                    target.emplace(value, revision, values[next++]);
+                else
+                    target.remove(value);
+            }
+        }
+        [[nodiscard]] const component_descriptor& descriptor() const noexcept override
+        {
+            return component_metadata<T>();
+        }
+        [[nodiscard]] std::unique_ptr<component_pool_base>
+        make_pool(std::pmr::memory_resource* resource) const override
+        {
+            return std::make_unique<component_pool<T>>(resource);
+        }
+        [[nodiscard]] std::span<const entity> entities() const noexcept override
+        {
+            return covered;
+        }
+        [[nodiscard]] std::size_t bytes() const noexcept override
+        {
+            return covered.size() * sizeof(entity) + present.size() * (sizeof(entity) + sizeof(T));
+        }
+
+        std::vector<entity> covered;
+        std::vector<entity> present;
+        std::vector<T> values;
+    };
+
+    /** Dense entries `[page * page_capacity, ...)` as they were at capture. */
+    struct snapshot_page
+    {
+        std::uint64_t version{};
+        std::vector<entity> entities;
+        std::vector<value_metadata> metadata;
+        std::vector<T> values;
+
+        [[nodiscard]] std::size_t bytes() const noexcept
+        {
+            return entities.size() * (sizeof(entity) + sizeof(value_metadata) + sizeof(T));
+        }
+    };
+
+    class pool_snapshot final : public component_pool_snapshot
+    {
+    public:
+        [[nodiscard]] const component_descriptor& descriptor() const noexcept override
+        {
+            return component_metadata<T>();
+        }
+        [[nodiscard]] std::unique_ptr<component_pool_base> restore(std::pmr::memory_resource* resource) const override
+        {
+            auto result = std::make_unique<component_pool<T>>(resource);
+            result->reserve(size);
+            for (const auto& page : pages)
+                for (std::size_t index = 0; index < page->entities.size(); ++index)
+                {
+                    result->emplace(page->entities[index], page->metadata[index].revision, page->values[index]);
+                    result->metadata_.back().fields = page->metadata[index].fields;
+                }
+            return result;
+        }
+
+        std::size_t size{};
+        std::vector<std::shared_ptr<const snapshot_page>> pages;
+    };
+
+    /** Gives the page holding dense `index` a new version so the next snapshot copies it. */
+    void touch(std::size_t index) noexcept
+    {
+        page_versions_[index / page_capacity] = ++version_;
+    }
+
+    [[nodiscard]] T* value_address(std::size_t index) const noexcept
+    {
+        return reinterpret_cast<T*>(pages_[index / page_capacity]) + index % page_capacity;
+    }
+
+    T* allocate_value()
+    {
+        if constexpr (dense_storage)
+        {
+            if (entities_.size() == pages_.size() * page_capacity) add_page();
+            return value_address(entities_.size());
+        }
+        else
+        {
+            if (free_values_.empty()) add_page();
+            T* result = free_values_.back();
+            free_values_.pop_back();
+            return result;
+        }
+    }
+
     void add_page()
     {
-        auto* page = static_cast<slot*>(resource_->allocate(sizeof(slot) * page_size, alignof(slot)));
+        auto* page = static_cast<std::byte*>(resource_->allocate(page_bytes, alignof(T)));
         pages_.push_back(page);
-        for (std::size_t index = 0; index < page_size; ++index)
+        if constexpr (!dense_storage)
         {
-            std::construct_at(page + index);
-            free_slots_.push_back(page + (page_size - index - 1));
+            for (std::size_t index = 0; index < page_capacity; ++index)
+                free_values_.push_back(reinterpret_cast<T*>(page) + (page_capacity - index - 1));
         }
     }
 
     std::pmr::memory_resource* resource_{};
-    std::pmr::vector<std::size_t> sparse_;
+    sparse_index sparse_;
     std::pmr::vector<entity> entities_;
-    std::pmr::vector<T*> dense_;
-    std::pmr::vector<slot*> changes_;
+    // Stable storage only: the address of each dense entry's value.
+    std::pmr::vector<T*> values_;
+    std::pmr::vector<value_metadata> metadata_;
     std::pmr::vector<component_change> change_events_;
-    std::pmr::vector<slot*> pages_;
-    std::pmr::vector<slot*> free_slots_;
+    std::pmr::vector<std::byte*> pages_;
+    std::pmr::vector<T*> free_values_;
+    // Version of each snapshot page of dense entries, bumped whenever an entry in it changes.
+    std::pmr::vector<std::uint64_t> page_versions_;
+    std::uint64_t version_{};
+    std::uint64_t pool_id_{next_pool_id()};
 };
 
 struct query_signature
@@ -301,14 +587,25 @@ struct query_signature_hash
 
 struct query_cache_entry
 {
-    explicit query_cache_entry(std::pmr::memory_resource* resource) : entities(resource) {}
+    explicit query_cache_entry(std::pmr::memory_resource* resource) : entities(resource), archetypes(resource) {}
 
     query_signature signature;
+    // Matching entities for sparse-set worlds, or matching archetype indices for archetype worlds.
     std::pmr::vector<entity> entities;
+    std::pmr::vector<std::uint32_t> archetypes;
+    // Sparse-set worlds only: pools for the required then excluded types, resolved on first use.
+    std::vector<const component_pool_base*> pools;
+    // Set while a deferred structural batch has touched one of the query's components.
+    bool refresh_pending{};
 };
 
 class world;
+class entity_template;
 
+/**
+ * Entities matched by a query. Sparse-set worlds iterate an entity list;
+ * archetype worlds iterate the rows of each matching archetype in turn.
+ */
 class query_entity_range
 {
 public:
@@ -322,60 +619,113 @@ public:
         iterator& operator++() noexcept;
         friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
         {
-            return lhs.index_ == rhs.index_ && lhs.range_ == rhs.range_;
+            return lhs.index_ == rhs.index_ && lhs.segment_ == rhs.segment_ && lhs.range_ == rhs.range_;
         }
 
     private:
-        iterator(const query_entity_range* range, std::size_t index) noexcept;
+        iterator(const query_entity_range* range, std::size_t segment, std::size_t index) noexcept;
         void advance() noexcept;
         const query_entity_range* range_{};
+        std::size_t segment_{};
         std::size_t index_{};
         friend class query_entity_range;
     };
 
     [[nodiscard]] iterator begin() const noexcept
     {
-        return iterator(this, 0);
+        return iterator(this, 0, 0);
     }
     [[nodiscard]] iterator end() const noexcept
     {
-        return iterator(this, source_.size());
+        return archetype_layout_ ? iterator(this, segment_count(), 0) : iterator(this, 0, source_.size());
     }
     [[nodiscard]] bool empty() const noexcept
     {
         return begin() == end();
     }
 
+    /**
+     * Visits the matched entities as contiguous spans: one per archetype, or the whole list of a prepared
+     * sparse-set query. Unprepared sparse-set ranges are filtered, so they visit one entity at a time.
+     */
+    template <class Function> void for_each_span(Function&& function) const
+    {
+        if (archetype_layout_)
+        {
+            for_each_archetype([&](const archetype& table) { function(table.entities()); });
+            return;
+        }
+        if (prepared_ || !signature_)
+        {
+            function(source_);
+            return;
+        }
+        for (auto current = begin(); current != end(); ++current)
+            function(source_.subspan(current.index_, 1));
+    }
+
 private:
-    query_entity_range(const world& owner, std::span<const entity> source, const query_signature* signature)
-        : owner_(&owner), source_(source), signature_(signature)
+    query_entity_range(const world& owner, std::span<const entity> source, const query_signature* signature,
+                       bool prepared)
+        : owner_(&owner), source_(source), signature_(signature), prepared_(prepared)
+    {
+    }
+    query_entity_range(const world& owner, std::span<const std::uint32_t> archetypes,
+                       const query_signature* signature, bool prepared)
+        : owner_(&owner), signature_(signature), archetypes_(archetypes), prepared_(prepared), archetype_layout_(true)
+    {
+    }
+
+    /** Archetypes visited: the prepared list, or every archetype filtered by the signature. */
+    [[nodiscard]] std::size_t segment_count() const noexcept;
+    [[nodiscard]] const archetype* segment(std::size_t index) const noexcept;
+    template <class Function> void for_each_archetype(Function&& function) const
     {
+        for (std::size_t index = 0; index < segment_count(); ++index)
+            if (const archetype* table = segment(index)) function(*table);
     }
+
     const world* owner_{};
     std::span<const entity> source_;
     const query_signature* signature_{};
+    std::span<const std::uint32_t> archetypes_;
+    // Prepared lists are maintained on every structural change, so their entries never need re-matching.
+    bool prepared_{};
+    bool archetype_layout_{};
     friend class world;
     template <class...> friend class basic_view;
 };
 
+/**
+ * Entities holding every listed component. `each` resolves the component pools once per call; a prepared
+ * sparse-set view visits its cached list in entity order, otherwise the smallest pool drives iteration over
+ * its contiguous value runs in dense order. Archetype worlds walk each matching chunk's component arrays.
+ */
 template <class... Components> class basic_view
 {
 public:
     [[nodiscard]] query_entity_range entities() const noexcept
     {
-        return query_entity_range(*owner_, source_, signature_);
+        return range_;
     }
 
     template <class Function> void each(Function&& function) const;
 
 private:
-    basic_view(const world& owner, std::span<const entity> source, const query_signature* signature)
-        : owner_(&owner), source_(source), signature_(signature)
+    using pool_pointers = std::tuple<const component_pool<std::remove_cv_t<Components>>*...>;
+
+    explicit basic_view(query_entity_range range, const component_pool_base* driver = nullptr)
+        : range_(range), driver_(driver)
     {
     }
-    const world* owner_{};
-    std::span<const entity> source_;
-    const query_signature* signature_{};
+
+    template <class Function> void each_archetype(Function& function) const;
+    template <std::size_t Driver, class Function, std::size_t... Index>
+    void each_driven(const pool_pointers& pools, Function& function, std::index_sequence<Index...>) const;
+
+    query_entity_range range_;
+    // Pool whose entity list is the range's source; null when the source is a prepared query list.
+    const component_pool_base* driver_{};
     friend class world;
 };
 
@@ -427,8 +777,8 @@ public:
     }
 
 private:
-    component_change_range(const component_pool<T>* pool, change_revision since)
-        : events_(pool ? pool->change_events() : std::span<const component_change>{}), since_(since)
+    component_change_range(std::span<const component_change> events, change_revision since)
+        : events_(events), since_(since)
     {
     }
     std::span<const component_change> events_;
@@ -436,27 +786,117 @@ private:
     friend class world;
 };
 
-/** Stable-address sparse-set ECS world with prepared allocation-free queries. */
+/**
+ * Immutable capture of a world for rollback and play-in-editor. Sparse-set
+ * pools are captured page by page, and a page unchanged since the previous
+ * snapshot of the same world is shared instead of copied. Archetype worlds are
+ * captured as a full copy. Restoring starts a fresh structural change log.
+ */
+class world_snapshot
+{
+public:
+    [[nodiscard]] std::size_t live_count() const noexcept
+    {
+        return live_count_;
+    }
+    /** Bytes this capture copied; pages shared with an earlier snapshot are not counted again. */
+    [[nodiscard]] std::size_t incremental_bytes() const noexcept
+    {
+        return incremental_bytes_;
+    }
+    /** Bytes the snapshot references, shared pages included. */
+    [[nodiscard]] std::size_t total_bytes() const noexcept
+    {
+        return total_bytes_;
+    }
+
+private:
+    [[nodiscard]] const component_pool_snapshot* find_pool(component_type_id type) const noexcept
+    {
+        const auto found = std::lower_bound(pools_.begin(), pools_.end(), type,
+                                            [](const auto& entry, component_type_id key) { return entry.first < key; });
+        return found != pools_.end() && found->first == type ? found->second.get() : nullptr;
+    }
+
+    std::shared_ptr<memory::world_memory_context> memory_;
+    std::vector<std::uint32_t> generations_;
+    std::vector<bool> alive_;
+    std::vector<std::uint32_t> free_list_;
+    // Sorted by component type.
+    std::vector<std::pair<component_type_id, std::shared_ptr<const component_pool_snapshot>>> pools_;
+    std::vector<query_signature> queries_;
+    std::shared_ptr<const world> archetype_copy_;
+    std::size_t live_count_{};
+    change_revision revision_{};
+    std::uint64_t storage_id_{};
+    std::size_t incremental_bytes_{};
+    std::size_t total_bytes_{};
+    friend class world;
+};
+
+/**
+ * ECS world with prepared allocation-free queries. Sparse-set worlds keep values stable-address unless
+ * stored dense; archetype worlds, selected through world_memory_context, group entities by component set.
+ */
 class world
 {
 public:
-    world() : memory_(std::make_shared<memory::world_memory_context>()) {}
+    world() : memory_(std::make_shared<memory::world_memory_context>())
+    {
+        initialize_layout();
+    }
 
-    explicit world(memory::memory_system& memory, std::uint64_t world_id = 0, memory::memory_budget budget = {})
-        : memory_(std::make_shared<memory::world_memory_context>(memory, world_id, budget))
+    explicit world(memory::memory_system& memory, std::uint64_t world_id = 0, memory::memory_budget budget = {},
+                   memory::component_layout layout = memory::component_layout::sparse_set)
+        : memory_(std::make_shared<memory::world_memory_context>(memory, world_id, budget, layout))
     {
+        initialize_layout();
     }
 
     world(const world& other)
         : memory_(other.memory_), generations_(other.generations_), alive_(other.alive_), free_list_(other.free_list_),
-          structural_changes_(other.structural_changes_), live_count_(other.live_count_), revision_(other.revision_)
+          structural_changes_(other.structural_changes_), structural_entities_(other.structural_entities_),
+          locations_(other.locations_),
+          archetype_index_(other.archetype_index_), live_count_(other.live_count_), revision_(other.revision_),
+          archetype_layout_(other.archetype_layout_)
     {
         for (const auto& [key, values] : other.pools_)
-            pools_.emplace(key, values->clone(memory_->component_resource()));
+            pools_.emplace(key, values->clone(pool_resource(values->descriptor())));
+        for (const auto& source : other.archetypes_)
+        {
+            std::vector<const component_operations*> columns(source->columns().begin(), source->columns().end());
+            const auto resource = memory_->component_resource();
+            auto& copy = *archetypes_.emplace_back(std::make_unique<archetype>(std::move(columns), resource));
+            source->copy_to(copy);
+            // Like a cloned pool, the copy starts a new journal holding each value's latest revision.
+            for (std::size_t column = 0; column < copy.columns().size(); ++column)
+            {
+                auto& journal = change_journal(copy.types()[column]);
+                for (std::size_t row = 0; row < copy.size(); ++row)
+                    journal.push_back({copy.entities()[row], copy.state(column, row).revision, all_component_fields});
+            }
+        }
         for (const auto& query : other.query_cache_)
             prepare_query(query->signature);
     }
 
+    /** Rebuilds the world captured by `snapshot` under a new storage id. */
+    explicit world(const world_snapshot& snapshot)
+        : memory_(snapshot.memory_), generations_(snapshot.generations_), alive_(snapshot.alive_),
+          free_list_(snapshot.free_list_), live_count_(snapshot.live_count_), revision_(snapshot.revision_)
+    {
+        if (snapshot.archetype_copy_)
+        {
+            world copy(*snapshot.archetype_copy_);
+            swap(copy);
+            return;
+        }
+        for (const auto& [type, values] : snapshot.pools_)
+            pools_.emplace(type, values->restore(pool_resource(values->descriptor())));
+        for (const query_signature& signature : snapshot.queries_)
+            prepare_query(signature);
+    }
+
     world& operator=(const world& other)
     {
         if (this == &other) return *this;
@@ -481,12 +921,30 @@ public:
         free_list_.swap(other.free_list_);
         pools_.swap(other.pools_);
         query_cache_.swap(other.query_cache_);
+        query_interest_.swap(other.query_interest_);
+        unconstrained_queries_.swap(other.unconstrained_queries_);
+        pending_queries_.swap(other.pending_queries_);
+        pending_query_entities_.swap(other.pending_query_entities_);
+        pending_query_marks_.swap(other.pending_query_marks_);
         structural_changes_.swap(other.structural_changes_);
+        structural_entities_.swap(other.structural_entities_);
+        archetypes_.swap(other.archetypes_);
+        locations_.swap(other.locations_);
+        archetype_index_.swap(other.archetype_index_);
+        change_journals_.swap(other.change_journals_);
         memory_.swap(other.memory_);
         std::swap(live_count_, other.live_count_);
         std::swap(revision_, other.revision_);
         std::swap(structural_lock_depth_, other.structural_lock_depth_);
         std::swap(flushing_commands_, other.flushing_commands_);
+        std::swap(query_refresh_deferrals_, other.query_refresh_deferrals_);
+        std::swap(archetype_layout_, other.archetype_layout_);
+        std::swap(storage_id_, other.storage_id_);
+    }
+
+    [[nodiscard]] memory::component_layout layout() const noexcept
+    {
+        return archetype_layout_ ? memory::component_layout::archetype : memory::component_layout::sparse_set;
     }
 
     [[nodiscard]] entity create()
@@ -503,14 +961,15 @@ public:
             index = static_cast<std::uint32_t>(generations_.size());
             generations_.push_back(1);
             alive_.push_back(false);
-            for (auto& [_, pool] : pools_)
-                pool->ensure_entity_capacity(generations_.size());
+            if (archetype_layout_) locations_.emplace_back();
         }
         alive_[index] = true;
         ++live_count_;
         const entity result{index, generations_[index]};
+        if (archetype_layout_)
+            locations_[index] = {.archetype = 0, .row = static_cast<std::uint32_t>(archetypes_[0]->append(result))};
         record_structural(structural_change_kind::entity_created, result, {});
-        refresh_queries(result);
+        refresh_queries(result, unconstrained_queries_);
         return result;
     }
 
@@ -518,9 +977,17 @@ public:
     {
         assert_structural_mutation_allowed();
         if (!alive(value)) return false;
+        if (archetype_layout_)
+        {
+            const entity_location location = locations_[value.index];
+            archetype& table = *archetypes_[location.archetype];
+            for (const component_type_id type : table.types())
+                record_structural(structural_change_kind::component_removed, value, type);
+            relocated(table.erase(location.row), location);
+        }
+        remove_from_queries(value);
         for (auto& [type, pool] : pools_)
             if (pool->remove(value)) record_structural(structural_change_kind::component_removed, value, type);
-        remove_from_queries(value);
         alive_[value.index] = false;
         ++generations_[value.index];
         free_list_.push_back(value.index);
@@ -529,6 +996,147 @@ public:
         return true;
     }
 
+    /**
+     * Creates `count` empty entities into the front of `out` with one range
+     * record, reusing free slots first. Query membership settles once.
+     */
+    void create_batch(std::size_t count, std::span<entity> out)
+    {
+        assert_structural_mutation_allowed();
+        if (out.size() < count) throw std::invalid_argument("create_batch output is smaller than the entity count");
+        const std::size_t fresh = count - std::min(count, free_list_.size());
+        generations_.reserve(generations_.size() + fresh);
+        alive_.reserve(alive_.size() + fresh);
+        if (archetype_layout_) locations_.reserve(locations_.size() + fresh);
+        for (std::size_t slot = 0; slot < count; ++slot)
+        {
+            std::uint32_t index{};
+            if (!free_list_.empty())
+            {
+                index = free_list_.back();
+                free_list_.pop_back();
+            }
+            else
+            {
+                index = static_cast<std::uint32_t>(generations_.size());
+                generations_.push_back(1);
+                alive_.push_back(false);
+                if (archetype_layout_) locations_.emplace_back();
+            }
+            alive_[index] = true;
+            out[slot] = {index, generations_[index]};
+            if (!archetype_layout_) continue;
+            locations_[index] = {.archetype = 0, .row = static_cast<std::uint32_t>(archetypes_[0]->append(out[slot]))};
+        }
+        live_count_ += count;
+        const std::span<const entity> created = out.first(count);
+        record_structural_range(next_revision(), structural_change_kind::entity_created, created, {});
+        with_deferred_query_refresh(
+            [&]
+            {
+                for (const entity value : created)
+                    refresh_queries(value, unconstrained_queries_);
+            });
+    }
+
+    /** Instantiates `prototype` `count` times, component by component; defined in template.h. */
+    void create_batch(const entity_template& prototype, std::size_t count, std::span<entity> out);
+
+    /**
+     * Adds a copy of `value` to every target as one range record, replacing
+     * existing components. Pool capacity grows once for the whole batch.
+     */
+    template <class T> void emplace_batch(std::span<const entity> targets, const T& value)
+    {
+        assert_structural_mutation_allowed();
+        for (const entity target : targets)
+            if (!alive(target)) throw std::invalid_argument("cannot add a component to a stale entity");
+        const change_revision change = next_revision();
+        const component_type_id type = component_type<T>();
+        std::vector<entity> added;
+        added.reserve(targets.size());
+        with_deferred_query_refresh(
+            [&]
+            {
+                if (!archetype_layout_) pool<T>().reserve(targets.size());
+                for (const entity target : targets)
+                {
+                    const bool inserted = archetype_layout_ ? place_archetype<T>(target, change, value).second
+                                                            : pool<T>().emplace(target, change, value).second;
+                    if (!inserted) continue;
+                    added.push_back(target);
+                    refresh_queries(target, type);
+                }
+            });
+        record_structural_range(change, structural_change_kind::component_added, added, type);
+    }
+
+    /**
+     * Destroys every live entity in `targets`, recording one range record per
+     * removed component type and one for the destroyed entities. Returns the
+     * number destroyed; stale handles are skipped.
+     */
+    std::size_t destroy_batch(std::span<const entity> targets)
+    {
+        assert_structural_mutation_allowed();
+        std::vector<entity> destroyed;
+        destroyed.reserve(targets.size());
+        // Clearing the alive flag up front also drops handles repeated in `targets`.
+        for (const entity value : targets)
+        {
+            if (!alive(value)) continue;
+            alive_[value.index] = false;
+            destroyed.push_back(value);
+        }
+        std::vector<entity> covered;
+        with_deferred_query_refresh(
+            [&]
+            {
+                if (archetype_layout_)
+                {
+                    // Rows leave their tables one by one; removals are grouped by type afterwards.
+                    std::vector<std::pair<component_type_id, entity>> removed;
+                    for (const entity value : destroyed)
+                    {
+                        const entity_location location = locations_[value.index];
+                        archetype& table = *archetypes_[location.archetype];
+                        for (const component_type_id type : table.types())
+                            removed.emplace_back(type, value);
+                        relocated(table.erase(location.row), location);
+                    }
+                    std::stable_sort(removed.begin(), removed.end(),
+                                     [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+                    for (std::size_t first = 0; first < removed.size();)
+                    {
+                        covered.clear();
+                        std::size_t last = first;
+                        for (; last < removed.size() && removed[last].first == removed[first].first; ++last)
+                            covered.push_back(removed[last].second);
+                        record_structural_range(next_revision(), structural_change_kind::component_removed, covered,
+                                                removed[first].first);
+                        first = last;
+                    }
+                }
+                for (const entity value : destroyed)
+                    remove_from_queries(value);
+                for (auto& [type, pool] : pools_)
+                {
+                    covered.clear();
+                    for (const entity value : destroyed)
+                        if (pool->remove(value)) covered.push_back(value);
+                    record_structural_range(next_revision(), structural_change_kind::component_removed, covered, type);
+                }
+                for (const entity value : destroyed)
+                {
+                    ++generations_[value.index];
+                    free_list_.push_back(value.index);
+                }
+                live_count_ -= destroyed.size();
+            });
+        record_structural_range(next_revision(), structural_change_kind::entity_destroyed, destroyed, {});
+        return destroyed.size();
+    }
+
     [[nodiscard]] bool alive(entity value) const noexcept
     {
         return value.valid() && value.index < generations_.size() && alive_[value.index] &&
@@ -552,6 +1160,13 @@ public:
         return *memory_;
     }
 
+    /** Releases memory component pools keep for reuse after removals. */
+    void shrink_to_fit() noexcept
+    {
+        for (auto& [type, pool] : pools_)
+            pool->shrink_to_fit();
+    }
+
     [[nodiscard]] std::vector<entity> entities_snapshot() const
     {
         std::vector<entity> result;
@@ -572,9 +1187,13 @@ public:
         assert_structural_mutation_allowed();
         if (!alive(value)) throw std::invalid_argument("cannot add a component to a stale entity");
         const change_revision change = next_revision();
+        if (archetype_layout_) return emplace_archetype<T>(value, change, std::forward<Args>(args)...);
         auto [component, inserted] = pool<T>().emplace(value, change, std::forward<Args>(args)...);
-        if (inserted) record_structural_at(change, structural_change_kind::component_added, value, component_type<T>());
-        refresh_queries(value);
+        if (inserted)
+        {
+            record_structural_at(change, structural_change_kind::component_added, value, component_type<T>());
+            refresh_queries(value, component_type<T>());
+        }
         return component;
     }
 
@@ -602,6 +1221,7 @@ public:
 
     template <class T> [[nodiscard]] const T* try_get(entity value) const
     {
+        if (archetype_layout_) return static_cast<const T*>(archetype_value(value, component_type<T>()));
         const auto* values = try_pool<T>();
         return values ? values->try_get(value) : nullptr;
     }
@@ -613,12 +1233,18 @@ public:
 
     [[nodiscard]] bool has(entity value, component_type_id type) const noexcept
     {
+        if (archetype_layout_) return alive(value) && archetypes_[locations_[value.index].archetype]->contains(type);
         const auto found = pools_.find(type);
         return found != pools_.end() && found->second->contains(value);
     }
 
     [[nodiscard]] component_change component_change_for(entity value, component_type_id type) const noexcept
     {
+        if (archetype_layout_)
+        {
+            const component_change_state* state = archetype_state(value, type);
+            return state ? component_change{value, state->revision, state->fields} : component_change{};
+        }
         const auto found = pools_.find(type);
         return found != pools_.end() ? found->second->change(value) : component_change{};
     }
@@ -632,18 +1258,42 @@ public:
     bool remove(entity value, component_type_id type)
     {
         assert_structural_mutation_allowed();
+        if (archetype_layout_)
+        {
+            if (!has(value, type)) return false;
+            const entity_location location = locations_[value.index];
+            move_entity(value, transition(location.archetype, type, nullptr));
+            record_structural(structural_change_kind::component_removed, value, type);
+            return true;
+        }
         const auto found = pools_.find(type);
         if (found == pools_.end() || !found->second->remove(value)) return false;
         record_structural(structural_change_kind::component_removed, value, type);
-        refresh_queries(value);
+        refresh_queries(value, type);
         return true;
     }
 
     template <class T> void mark_dirty(entity value, std::uint64_t fields = ~std::uint64_t{})
     {
+        if (archetype_layout_)
+        {
+            mark_archetype(value, component_type<T>(), next_revision(), fields);
+            return;
+        }
         if (auto* values = try_pool<T>()) values->mark(value, next_revision(), fields);
     }
 
+    void mark_dirty(entity value, component_type_id type, std::uint64_t fields = ~std::uint64_t{})
+    {
+        if (archetype_layout_)
+        {
+            mark_archetype(value, type, next_revision(), fields);
+            return;
+        }
+        if (const auto found = pools_.find(type); found != pools_.end())
+            found->second->mark(value, next_revision(), fields);
+    }
+
     template <class T, class Function> bool patch_field(entity value, component_field_id field, Function&& function)
     {
         T* component = try_get_untracked<T>(value);
@@ -652,13 +1302,26 @@ public:
         if (index == static_cast<std::size_t>(-1)) return false;
         std::forward<Function>(function)(*component);
         const std::uint64_t mask = index < 64 ? (std::uint64_t{1} << index) : ~std::uint64_t{};
-        pool<T>().mark(value, next_revision(), mask);
+        if (archetype_layout_)
+            mark_archetype(value, component_type<T>(), next_revision(), mask);
+        else
+            pool<T>().mark(value, next_revision(), mask);
         return true;
     }
 
     template <class T> [[nodiscard]] component_change_range<T> changes_since(change_cursor cursor) const noexcept
     {
-        return component_change_range<T>(try_pool<T>(), cursor.revision);
+        if (archetype_layout_)
+        {
+            const auto found = change_journals_.find(component_type<T>());
+            return component_change_range<T>(found != change_journals_.end()
+                                                  ? std::span<const component_change>(found->second)
+                                                  : std::span<const component_change>{},
+                                              cursor.revision);
+        }
+        const auto* values = try_pool<T>();
+        return component_change_range<T>(values ? values->change_events() : std::span<const component_change>{},
+                                         cursor.revision);
     }
 
     [[nodiscard]] std::span<const structural_change> structural_changes() const noexcept
@@ -666,19 +1329,89 @@ public:
         return {structural_changes_.data(), structural_changes_.size()};
     }
 
-    template <class... Components> void prepare_query()
+    /**
+     * Captures the world. With `previous` taken from this world, only component
+     * pages touched since then are copied; the rest are shared with it.
+     */
+    [[nodiscard]] world_snapshot snapshot(const world_snapshot* previous = nullptr) const
     {
-        query_signature signature = typed_signature<Components...>();
-        if (find_query(signature)) return;
-        auto entry = std::make_unique<query_cache_entry>(memory_->component_resource());
-        entry->signature = std::move(signature);
-        entry->entities.reserve(live_count_);
-        for (std::uint32_t index = 0; index < generations_.size(); ++index)
+        world_snapshot result;
+        result.memory_ = memory_;
+        result.live_count_ = live_count_;
+        result.revision_ = revision();
+        result.storage_id_ = storage_id_;
+        for (const auto& entry : query_cache_)
+            result.queries_.push_back(entry->signature);
+        if (archetype_layout_)
         {
-            const entity value{index, generations_[index]};
-            if (alive(value) && matches(value, entry->signature)) entry->entities.push_back(value);
+            result.archetype_copy_ = std::make_shared<const world>(*this);
+            for (const auto& table : archetypes_)
+            {
+                std::size_t row_bytes = sizeof(entity);
+                for (const auto* column : table->columns())
+                    row_bytes += column->size + sizeof(component_change_state);
+                result.total_bytes_ += table->size() * row_bytes;
+            }
+            result.incremental_bytes_ = result.total_bytes_;
+            return result;
         }
-        query_cache_.emplace_back(std::move(entry));
+
+        result.generations_ = generations_;
+        result.alive_ = alive_;
+        result.free_list_ = free_list_;
+        // Entity bookkeeping is small next to component data and is copied every time.
+        result.incremental_bytes_ =
+            generations_.size() * sizeof(std::uint32_t) + alive_.size() / 8 + free_list_.size() * sizeof(std::uint32_t);
+        result.total_bytes_ = result.incremental_bytes_;
+        const bool related = previous && previous->storage_id_ == storage_id_;
+        result.pools_.reserve(pools_.size());
+        for (const auto& [type, values] : pools_)
+        {
+            auto captured = values->snapshot(related ? previous->find_pool(type) : nullptr);
+            result.incremental_bytes_ += captured->copied_bytes;
+            result.total_bytes_ += captured->copied_bytes + captured->shared_bytes;
+            result.pools_.emplace_back(type, std::move(captured));
+        }
+        std::sort(result.pools_.begin(), result.pools_.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        return result;
+    }
+
+    /** Entities covered by `change`, which must come from this world's `structural_changes()`. */
+    [[nodiscard]] std::span<const entity> structural_entities(const structural_change& change) const noexcept
+    {
+        if (change.count == 1) return {&change.value, 1};
+        return std::span<const entity>(structural_entities_).subspan(change.batch_offset, change.count);
+    }
+
+    /** Revision of the latest recorded change to any `type` component, or zero if none has changed. */
+    [[nodiscard]] change_revision last_change(component_type_id type) const noexcept
+    {
+        std::span<const component_change> events;
+        if (archetype_layout_)
+        {
+            if (const auto found = change_journals_.find(type); found != change_journals_.end()) events = found->second;
+        }
+        else if (const auto found = pools_.find(type); found != pools_.end())
+        {
+            events = found->second->change_events();
+        }
+        return events.empty() ? change_revision{} : events.back().revision;
+    }
+
+    /**
+     * Identifies the component storage this world owns. Copying a world gives the copy a new identity, while
+     * moving or swapping carries it along with the storage, so cached component addresses stay valid exactly
+     * as long as the identity and the structural history match.
+     */
+    [[nodiscard]] std::uint64_t storage_id() const noexcept
+    {
+        return storage_id_;
+    }
+
+    template <class... Components> void prepare_query()
+    {
+        prepare_query(typed_signature<Components...>());
     }
 
     void prepare_query(query_signature signature)
@@ -687,20 +1420,26 @@ public:
         if (find_query(signature)) return;
         auto entry = std::make_unique<query_cache_entry>(memory_->component_resource());
         entry->signature = std::move(signature);
+        if (archetype_layout_)
+        {
+            for (std::uint32_t index = 0; index < archetypes_.size(); ++index)
+                if (matches(*archetypes_[index], entry->signature)) entry->archetypes.push_back(index);
+            query_cache_.emplace_back(std::move(entry));
+            return;
+        }
         entry->entities.reserve(live_count_);
         for (std::uint32_t index = 0; index < generations_.size(); ++index)
         {
             const entity value{index, generations_[index]};
             if (alive(value) && matches(value, entry->signature)) entry->entities.push_back(value);
         }
+        register_query_interest(*entry);
         query_cache_.emplace_back(std::move(entry));
     }
 
     [[nodiscard]] query_entity_range query(const query_signature& signature) const
     {
-        const auto* cached = find_query(signature);
-        return {*this, cached ? std::span<const entity>(cached->entities) : std::span<const entity>{},
-                cached ? &cached->signature : nullptr};
+        return prepared_range(find_query(signature));
     }
 
     template <class... Specifications> void prepare_typed_query()
@@ -710,23 +1449,29 @@ public:
 
     template <class... Specifications> [[nodiscard]] query_entity_range query() const
     {
-        const query_signature& signature = access_signature<Specifications...>();
-        if (const auto* cached = find_query(signature)) return {*this, cached->entities, &cached->signature};
-        return {*this, {}, nullptr};
+        return prepared_range(find_query(access_signature<Specifications...>()));
+    }
+
+    template <class... Specifications> [[nodiscard]] bool query_prepared() const noexcept
+    {
+        return find_query(access_signature<Specifications...>()) != nullptr;
     }
 
     template <class... Components> [[nodiscard]] basic_view<Components...> view() const
     {
         static_assert(sizeof...(Components) > 0);
         const query_signature& temporary = typed_signature<Components...>();
-        if (const auto* cached = find_query(temporary)) return {*this, cached->entities, &cached->signature};
+        if (const auto* cached = find_query(temporary)) return basic_view<Components...>(prepared_range(cached));
+        if (archetype_layout_)
+            return basic_view<Components...>(
+                query_entity_range(*this, std::span<const std::uint32_t>{}, &temporary, false));
 
         const component_pool_base* driver = nullptr;
         std::size_t smallest = static_cast<std::size_t>(-1);
         for (const component_type_id type : temporary.required)
         {
             const auto found = pools_.find(type);
-            if (found == pools_.end()) return {*this, {}, nullptr};
+            if (found == pools_.end()) return basic_view<Components...>(prepared_range(nullptr));
             const auto size = found->second->entities().size();
             if (size < smallest)
             {
@@ -734,12 +1479,15 @@ public:
                 smallest = size;
             }
         }
-        return {*this, driver ? driver->entities() : std::span<const entity>{}, &temporary};
+        return basic_view<Components...>(
+            query_entity_range(*this, driver ? driver->entities() : std::span<const entity>{}, &temporary, false),
+            driver);
     }
 
     [[nodiscard]] bool matches(entity value, const query_signature& signature) const noexcept
     {
         if (!alive(value)) return false;
+        if (archetype_layout_) return matches(*archetypes_[locations_[value.index].archetype], signature);
         for (const auto type : signature.required)
             if (!has(value, type)) return false;
         for (const auto type : signature.excluded)
@@ -761,19 +1509,42 @@ public:
     }
 
 private:
+    static constexpr std::uint64_t all_component_fields = ~std::uint64_t{};
+
+    struct entity_location
+    {
+        std::uint32_t archetype{};
+        std::uint32_t row{};
+    };
+
+    void initialize_layout()
+    {
+        archetype_layout_ = memory_->layout() == memory::component_layout::archetype;
+        // Archetype zero holds entities without components.
+        if (archetype_layout_)
+        {
+            archetypes_.push_back(std::make_unique<archetype>(std::vector<const component_operations*>{},
+                                                              memory_->component_resource()));
+            archetype_index_.emplace(std::vector<component_type_id>{}, 0);
+        }
+    }
+
     template <class T> component_pool<T>& pool()
     {
         const component_type_id key = component_type<T>();
         auto found = pools_.find(key);
         if (found == pools_.end())
         {
-            auto values = std::make_unique<component_pool<T>>(memory_->component_resource());
-            values->ensure_entity_capacity(generations_.size());
+            auto values = std::make_unique<component_pool<T>>(pool_resource(component_metadata<T>()));
             found = pools_.emplace(key, std::move(values)).first;
         }
-        auto& values = static_cast<component_pool<T>&>(*found->second);
-        values.ensure_entity_capacity(generations_.size());
-        return values;
+        return static_cast<component_pool<T>&>(*found->second);
+    }
+
+    /** Sparse-set pools allocate under a memory tag named after their component. */
+    [[nodiscard]] std::pmr::memory_resource* pool_resource(const component_descriptor& descriptor) const
+    {
+        return memory_->component_resource(memory::make_memory_tag(descriptor.canonical_name));
     }
 
     template <class T> component_pool<T>* try_pool()
@@ -790,10 +1561,144 @@ private:
 
     template <class T> T* try_get_untracked(entity value)
     {
+        if (archetype_layout_) return static_cast<T*>(archetype_value(value, component_type<T>()));
         auto* values = try_pool<T>();
         return values ? values->try_get(value) : nullptr;
     }
 
+    [[nodiscard]] void* archetype_value(entity value, component_type_id type) const noexcept
+    {
+        if (!alive(value)) return nullptr;
+        const entity_location location = locations_[value.index];
+        const archetype& table = *archetypes_[location.archetype];
+        const std::size_t column = table.column_index(type);
+        return column == archetype::npos ? nullptr : table.value(column, location.row);
+    }
+
+    [[nodiscard]] const component_change_state* archetype_state(entity value, component_type_id type) const noexcept
+    {
+        if (!alive(value)) return nullptr;
+        const entity_location location = locations_[value.index];
+        const archetype& table = *archetypes_[location.archetype];
+        const std::size_t column = table.column_index(type);
+        return column == archetype::npos ? nullptr : &table.state(column, location.row);
+    }
+
+    void mark_archetype(entity value, component_type_id type, change_revision revision, std::uint64_t fields)
+    {
+        auto* state = const_cast<component_change_state*>(archetype_state(value, type));
+        if (!state) return;
+        state->revision = revision;
+        state->fields |= fields;
+        change_journal(type).push_back({value, revision, fields});
+    }
+
+    template <class T, class... Args> T& emplace_archetype(entity value, change_revision change, Args&&... args)
+    {
+        auto [component, inserted] = place_archetype<T>(value, change, std::forward<Args>(args)...);
+        if (inserted) record_structural_at(change, structural_change_kind::component_added, value, component_type<T>());
+        return component;
+    }
+
+    /** Stores the component and moves the entity to its new archetype; the caller records the structural change. */
+    template <class T, class... Args>
+    std::pair<T&, bool> place_archetype(entity value, change_revision change, Args&&... args)
+    {
+        const component_type_id type = component_type<T>();
+        if (T* existing = static_cast<T*>(archetype_value(value, type)))
+        {
+            *existing = T{std::forward<Args>(args)...};
+            mark_archetype(value, type, change, all_component_fields);
+            return {*existing, false};
+        }
+        T created{std::forward<Args>(args)...};
+        const entity_location location = locations_[value.index];
+        const std::uint32_t target = transition(location.archetype, type, &component_operations::of<T>());
+        move_entity(value, target);
+        archetype& table = *archetypes_[target];
+        const std::size_t column = table.column_index(type);
+        const std::size_t row = locations_[value.index].row;
+        T* component = std::construct_at(static_cast<T*>(table.value(column, row)), std::move(created));
+        table.state(column, row) = {change, all_component_fields};
+        change_journal(type).push_back({value, change, all_component_fields});
+        return {*component, true};
+    }
+
+    /** Archetype reached from `source` by adding (`added` set) or removing `type`, created on first use. */
+    std::uint32_t transition(std::uint32_t source, component_type_id type, const component_operations* added)
+    {
+        const bool adding = added != nullptr;
+        if (const auto cached = archetypes_[source]->edge(type, adding); cached != archetype::no_edge) return cached;
+
+        std::vector<const component_operations*> columns;
+        for (const auto* column : archetypes_[source]->columns())
+            if (column->type != type) columns.push_back(column);
+        if (adding)
+            columns.insert(std::upper_bound(columns.begin(), columns.end(), type,
+                                            [](component_type_id key, const component_operations* column)
+                                            { return key < column->type; }),
+                           added);
+        std::vector<component_type_id> key;
+        for (const auto* column : columns)
+            key.push_back(column->type);
+
+        auto found = archetype_index_.find(key);
+        if (found == archetype_index_.end())
+        {
+            const auto index = static_cast<std::uint32_t>(archetypes_.size());
+            archetypes_.push_back(std::make_unique<archetype>(std::move(columns), memory_->component_resource()));
+            for (auto& entry : query_cache_)
+                if (matches(*archetypes_.back(), entry->signature)) entry->archetypes.push_back(index);
+            found = archetype_index_.emplace(std::move(key), index).first;
+        }
+        archetypes_[source]->set_edge(type, adding, found->second);
+        return found->second;
+    }
+
+    void move_entity(entity value, std::uint32_t target)
+    {
+        entity_location& location = locations_[value.index];
+        const entity_location previous = location;
+        entity moved{};
+        const std::size_t row = archetypes_[previous.archetype]->migrate(previous.row, *archetypes_[target], moved);
+        location = {.archetype = target, .row = static_cast<std::uint32_t>(row)};
+        relocated(moved, previous);
+    }
+
+    /** Points an entity that filled a vacated row at its new location. */
+    void relocated(entity moved, entity_location hole) noexcept
+    {
+        if (moved.valid()) locations_[moved.index] = hole;
+    }
+
+    std::pmr::vector<component_change>& change_journal(component_type_id type)
+    {
+        auto found = change_journals_.find(type);
+        if (found == change_journals_.end())
+            found = change_journals_.emplace(type, std::pmr::vector<component_change>(memory_->component_resource()))
+                        .first;
+        return found->second;
+    }
+
+    [[nodiscard]] static bool matches(const archetype& table, const query_signature& signature) noexcept
+    {
+        for (const auto type : signature.required)
+            if (!table.contains(type)) return false;
+        for (const auto type : signature.excluded)
+            if (table.contains(type)) return false;
+        return true;
+    }
+
+    [[nodiscard]] query_entity_range prepared_range(const query_cache_entry* cached) const noexcept
+    {
+        if (archetype_layout_)
+            return {*this,
+                    cached ? std::span<const std::uint32_t>(cached->archetypes) : std::span<const std::uint32_t>{},
+                    cached ? &cached->signature : nullptr, true};
+        return {*this, cached ? std::span<const entity>(cached->entities) : std::span<const entity>{},
+                cached ? &cached->signature : nullptr, true};
+    }
+
     template <class... Components> static const query_signature& typed_signature()
     {
         static const query_signature result = []
@@ -853,13 +1758,52 @@ private:
         return nullptr;
     }
 
-    void refresh_queries(entity value)
+    /**
+     * Sparse-set queries a component type can affect. `affected` lists every query
+     * naming the type; `anchored` lists those whose first required type it is, so
+     * each query holding an entity is reached exactly once through its components.
+     */
+    struct query_interest
     {
-        for (auto& entry : query_cache_)
+        std::vector<query_cache_entry*> affected;
+        std::vector<query_cache_entry*> anchored;
+    };
+
+    void register_query_interest(query_cache_entry& entry)
+    {
+        const query_signature& signature = entry.signature;
+        entry.pools.assign(signature.required.size() + signature.excluded.size(), nullptr);
+        if (signature.required.empty())
+            unconstrained_queries_.push_back(&entry);
+        else
+            query_interest_[signature.required.front()].anchored.push_back(&entry);
+        for (const component_type_id type : signature.required)
+            query_interest_[type].affected.push_back(&entry);
+        for (const component_type_id type : signature.excluded)
+            query_interest_[type].affected.push_back(&entry);
+    }
+
+    /** Re-tests `value` against the queries that name `type`, the only ones its change can affect. */
+    void refresh_queries(entity value, component_type_id type)
+    {
+        // Archetype worlds match queries per archetype, so membership follows the entity's row.
+        if (archetype_layout_) return;
+        const auto found = query_interest_.find(type);
+        if (found != query_interest_.end()) refresh_queries(value, found->second.affected);
+    }
+
+    void refresh_queries(entity value, std::span<query_cache_entry* const> entries)
+    {
+        if (archetype_layout_ || entries.empty()) return;
+        if (query_refresh_deferrals_ != 0)
         {
-            const bool should_contain = matches(value, entry->signature);
-            const auto found = std::lower_bound(entry->entities.begin(), entry->entities.end(), value,
-                                                [](entity lhs, entity rhs) { return lhs.index < rhs.index; });
+            defer_query_refresh(value.index, entries);
+            return;
+        }
+        for (query_cache_entry* entry : entries)
+        {
+            const bool should_contain = matches(value, *entry);
+            const auto found = lower_bound_index(entry->entities, value.index);
             const bool contains = found != entry->entities.end() && *found == value;
             if (should_contain && !contains)
                 entry->entities.insert(found, value);
@@ -868,16 +1812,125 @@ private:
         }
     }
 
+    /** Drops a live entity, still holding its components, from every query that contains it. */
     void remove_from_queries(entity value)
     {
-        for (auto& entry : query_cache_)
+        if (archetype_layout_) return;
+        const auto erase = [&](std::span<query_cache_entry* const> entries)
         {
-            const auto found = std::lower_bound(entry->entities.begin(), entry->entities.end(), value,
-                                                [](entity lhs, entity rhs) { return lhs.index < rhs.index; });
-            if (found != entry->entities.end() && *found == value) entry->entities.erase(found);
+            if (query_refresh_deferrals_ != 0)
+            {
+                if (!entries.empty()) defer_query_refresh(value.index, entries);
+                return;
+            }
+            for (query_cache_entry* entry : entries)
+            {
+                const auto found = lower_bound_index(entry->entities, value.index);
+                if (found != entry->entities.end() && *found == value) entry->entities.erase(found);
+            }
+        };
+        erase(unconstrained_queries_);
+        for (const auto& [type, pool] : pools_)
+        {
+            if (!pool->contains(value)) continue;
+            const auto found = query_interest_.find(type);
+            if (found != query_interest_.end()) erase(found->second.anchored);
+        }
+    }
+
+    /** Sparse-set membership test through the entry's cached pools; pools are never erased once created. */
+    [[nodiscard]] bool matches(entity value, query_cache_entry& entry) const noexcept
+    {
+        if (!alive(value)) return false;
+        const query_signature& signature = entry.signature;
+        const auto present = [&](std::size_t slot, component_type_id type)
+        {
+            const component_pool_base*& pool = entry.pools[slot];
+            if (!pool)
+            {
+                const auto found = pools_.find(type);
+                if (found == pools_.end()) return false;
+                pool = found->second.get();
+            }
+            return pool->contains(value);
+        };
+        for (std::size_t index = 0; index < signature.required.size(); ++index)
+            if (!present(index, signature.required[index])) return false;
+        for (std::size_t index = 0; index < signature.excluded.size(); ++index)
+            if (present(signature.required.size() + index, signature.excluded[index])) return false;
+        return true;
+    }
+
+    static std::pmr::vector<entity>::iterator lower_bound_index(std::pmr::vector<entity>& entities,
+                                                                 std::uint32_t index) noexcept
+    {
+        return std::lower_bound(entities.begin(), entities.end(), index,
+                                [](entity lhs, std::uint32_t rhs) { return lhs.index < rhs; });
+    }
+
+    void defer_query_refresh(std::uint32_t index, std::span<query_cache_entry* const> entries)
+    {
+        if (pending_query_marks_.size() <= index) pending_query_marks_.resize(generations_.size());
+        if (!pending_query_marks_[index])
+        {
+            pending_query_marks_[index] = true;
+            pending_query_entities_.push_back(index);
+        }
+        for (query_cache_entry* entry : entries)
+        {
+            if (entry->refresh_pending) continue;
+            entry->refresh_pending = true;
+            pending_queries_.push_back(entry);
         }
     }
 
+    /**
+     * Settles every query a deferred batch touched in one pass per query. Entity
+     * slots are re-read at their current generation, so a slot destroyed and
+     * reused inside the batch replaces its stale entry.
+     */
+    void apply_deferred_query_refresh()
+    {
+        std::sort(pending_query_entities_.begin(), pending_query_entities_.end());
+        std::vector<std::uint32_t> removals;
+        std::vector<entity> additions;
+        for (query_cache_entry* entry : pending_queries_)
+        {
+            entry->refresh_pending = false;
+            auto& entities = entry->entities;
+            removals.clear();
+            additions.clear();
+            for (const std::uint32_t index : pending_query_entities_)
+            {
+                const entity current{index, generations_[index]};
+                const bool should_contain = matches(current, *entry);
+                const auto found = lower_bound_index(entities, index);
+                if (found != entities.end() && found->index == index)
+                {
+                    if (should_contain)
+                        *found = current;
+                    else
+                        removals.push_back(index);
+                }
+                else if (should_contain)
+                {
+                    additions.push_back(current);
+                }
+            }
+            if (!removals.empty())
+                std::erase_if(entities, [&](entity value)
+                              { return std::binary_search(removals.begin(), removals.end(), value.index); });
+            if (additions.empty()) continue;
+            const auto middle = entities.insert(entities.end(), additions.begin(), additions.end());
+            std::inplace_merge(entities.begin(), middle, entities.end(),
+                               [](entity lhs, entity rhs) { return lhs.index < rhs.index; });
+        }
+        for (const std::uint32_t index : pending_query_entities_)
+            pending_query_marks_[index] = false;
+        pending_query_entities_.clear();
+        pending_queries_.clear();
+    }
+
     change_revision next_revision() noexcept
     {
         auto atomic_revision = std::atomic_ref<change_revision>(revision_);
@@ -897,19 +1950,59 @@ private:
         structural_changes_.push_back({revision, kind, value, component});
     }
 
+    void record_structural_range(change_revision revision, structural_change_kind kind,
+                                 std::span<const entity> values, component_type_id component)
+    {
+        if (values.empty()) return;
+        if (values.size() == 1)
+        {
+            record_structural_at(revision, kind, values.front(), component);
+            return;
+        }
+        const auto offset = static_cast<std::uint32_t>(structural_entities_.size());
+        structural_entities_.insert(structural_entities_.end(), values.begin(), values.end());
+        structural_changes_.push_back(
+            {revision, kind, values.front(), component, static_cast<std::uint32_t>(values.size()), offset});
+    }
+
+    static std::uint64_t next_storage_id() noexcept
+    {
+        static std::atomic<std::uint64_t> value{1};
+        return value.fetch_add(1, std::memory_order_relaxed);
+    }
+
     void assert_structural_mutation_allowed() const
     {
         if (structural_lock_depth_ != 0 && !flushing_commands_)
             throw std::logic_error("direct structural ECS mutation is forbidden during scheduled execution");
     }
 
+    /** Runs `function` with query maintenance deferred, settling every touched query once afterwards. */
+    template <class Function> void with_deferred_query_refresh(Function&& function)
+    {
+        ++query_refresh_deferrals_;
+        try
+        {
+            std::forward<Function>(function)();
+        }
+        catch (...)
+        {
+            if (--query_refresh_deferrals_ == 0) apply_deferred_query_refresh();
+            throw;
+        }
+        if (--query_refresh_deferrals_ == 0) apply_deferred_query_refresh();
+    }
+
+    /** Query membership is settled once when the flush ends rather than after every command. */
     void begin_command_flush() noexcept
     {
         flushing_commands_ = true;
+        ++query_refresh_deferrals_;
     }
-    void end_command_flush() noexcept
+    void end_command_flush()
     {
         flushing_commands_ = false;
+        if (--query_refresh_deferrals_ == 0) apply_deferred_query_refresh();
     }
 
     std::shared_ptr<memory::world_memory_context> memory_;
@@ -918,30 +2011,76 @@ private:
     std::vector<std::uint32_t> free_list_;
     std::unordered_map<component_type_id, std::unique_ptr<component_pool_base>, component_type_id_hash> pools_;
     std::vector<std::unique_ptr<query_cache_entry>> query_cache_;
+    // Sparse-set layout only: queries reachable per component type, queries with no required type, and the
+    // entity slots and queries a deferred structural batch still has to settle.
+    std::unordered_map<component_type_id, query_interest, component_type_id_hash> query_interest_;
+    std::vector<query_cache_entry*> unconstrained_queries_;
+    std::vector<query_cache_entry*> pending_queries_;
+    std::vector<std::uint32_t> pending_query_entities_;
+    std::vector<bool> pending_query_marks_;
     std::vector<structural_change> structural_changes_;
+    std::vector<entity> structural_entities_;
+    // Archetype layout only: tables by index, each live entity's row, and tables keyed by sorted component set.
+    std::vector<std::unique_ptr<archetype>> archetypes_;
+    std::vector<entity_location> locations_;
+    std::map<std::vector<component_type_id>, std::uint32_t> archetype_index_;
+    std::unordered_map<component_type_id, std::pmr::vector<component_change>, component_type_id_hash>
+        change_journals_;
     std::size_t live_count_{};
     change_revision revision_{};
     std::uint32_t structural_lock_depth_{};
+    std::uint32_t query_refresh_deferrals_{};
     bool flushing_commands_{};
+    bool archetype_layout_{};
+    std::uint64_t storage_id_{next_storage_id()};
+    friend class query_entity_range;
     friend class query_entity_range::iterator;
     friend class entity_command_buffer;
+    friend class system_chunk;
+    friend class world_delta;
+    template <class...> friend class basic_view;
 };
 
-inline query_entity_range::iterator::iterator(const query_entity_range* range, std::size_t index) noexcept
-    : range_(range), index_(index)
+inline query_entity_range::iterator::iterator(const query_entity_range* range, std::size_t segment,
+                                              std::size_t index) noexcept
+    : range_(range), segment_(segment), index_(index)
 {
     advance();
 }
 
+inline std::size_t query_entity_range::segment_count() const noexcept
+{
+    return prepared_ ? archetypes_.size() : owner_->archetypes_.size();
+}
+
+inline const archetype* query_entity_range::segment(std::size_t index) const noexcept
+{
+    if (prepared_) return owner_->archetypes_[archetypes_[index]].get();
+    const archetype* table = owner_->archetypes_[index].get();
+    return signature_ && world::matches(*table, *signature_) ? table : nullptr;
+}
+
 inline void query_entity_range::iterator::advance() noexcept
 {
-    if (!range_ || !range_->signature_) return;
+    if (!range_) return;
+    if (range_->archetype_layout_)
+    {
+        for (const auto count = range_->segment_count(); segment_ < count; ++segment_, index_ = 0)
+        {
+            const archetype* table = range_->segment(segment_);
+            if (table && index_ < table->size()) return;
+        }
+        index_ = 0;
+        return;
+    }
+    if (!range_->signature_ || range_->prepared_) return;
     while (index_ < range_->source_.size() && !range_->owner_->matches(range_->source_[index_], *range_->signature_))
         ++index_;
 }
 
 inline entity query_entity_range::iterator::operator*() const noexcept
 {
+    if (range_->archetype_layout_) return range_->segment(segment_)->entities()[index_];
     return range_->source_[index_];
 }
 
@@ -954,8 +2093,77 @@ inline query_entity_range::iterator& query_entity_range::iterator::operator++()
 
 template <class... Components> template <class Function> void basic_view<Components...>::each(Function&& function) const
 {
-    for (const entity value : entities())
-        std::forward<Function>(function)(value, std::as_const(*owner_).template get<Components>(value)...);
+    if (range_.archetype_layout_)
+    {
+        each_archetype(function);
+        return;
+    }
+    const pool_pointers pools{range_.owner_->template try_pool<std::remove_cv_t<Components>>()...};
+    [&]<std::size_t... Index>(std::index_sequence<Index...> indices)
+    {
+        if ((!std::get<Index>(pools) || ...)) return;
+        if (!driver_)
+        {
+            for (const entity value : range_.source_)
+                function(value, std::get<Index>(pools)->get(value)...);
+            return;
+        }
+        // A repeated component type resolves to the same pool; drive from its first occurrence only.
+        std::size_t driver_index = sizeof...(Components);
+        ((driver_index == sizeof...(Components) && std::get<Index>(pools) == driver_ ? driver_index = Index : 0), ...);
+        ((Index == driver_index ? each_driven<Index>(pools, function, indices) : void()), ...);
+    }(std::index_sequence_for<Components...>{});
+}
+
+template <class... Components>
+template <class Function>
+void basic_view<Components...>::each_archetype(Function& function) const
+{
+    range_.for_each_archetype(
+        [&](const archetype& table)
+        {
+            const std::array<std::size_t, sizeof...(Components)> columns{
+                table.column_index(component_type<Components>())...};
+            const std::span<const entity> values = table.entities();
+            for (std::size_t chunk = 0, first = 0; first < values.size(); ++chunk, first += table.chunk_rows())
+            {
+                const std::size_t rows = std::min(table.chunk_rows(), values.size() - first);
+                [&]<std::size_t... Index>(std::index_sequence<Index...>)
+                {
+                    const std::tuple arrays{
+                        table.template column_data<std::remove_cv_t<Components>>(columns[Index], chunk)...};
+                    for (std::size_t row = 0; row < rows; ++row)
+                        function(values[first + row], std::get<Index>(arrays)[row]...);
+                }(std::index_sequence_for<Components...>{});
+            }
+        });
+}
+
+template <class... Components>
+template <std::size_t Driver, class Function, std::size_t... Index>
+void basic_view<Components...>::each_driven(const pool_pointers& pools, Function& function,
+                                            std::index_sequence<Index...>) const
+{
+    const auto& driver = *std::get<Driver>(pools);
+    const std::span<const entity> values = driver.entities();
+    for (std::size_t first = 0; first < values.size();)
+    {
+        const auto run = driver.contiguous(first);
+        for (std::size_t offset = 0; offset < run.size(); ++offset)
+        {
+            const entity value = values[first + offset];
+            if (!((Index == Driver || std::get<Index>(pools)->contains(value)) && ...)) continue;
+            const auto component = [&]<std::size_t Current>() -> decltype(auto)
+            {
+                if constexpr (Current == Driver)
+                    return run[offset];
+                else
+                    return std::get<Current>(pools)->get(value);
+            };
+            function(value, component.template operator()<Index>()...);
+        }
+        first += run.size();
+    }
 }
 
 } // namespace arc::ecs
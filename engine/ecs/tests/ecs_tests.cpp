@@ -2,9 +2,12 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace arc::ecs::tests
@@ -24,10 +27,20 @@ struct velocity
 struct hidden
 {
 };
+
+struct packed_value
+{
+    std::uint32_t value{};
+};
 } // namespace arc::ecs::tests
 
 namespace arc::ecs
 {
+template <> struct component_storage_traits<tests::packed_value>
+{
+    static constexpr component_storage storage = component_storage::dense;
+};
+
 template <> struct component_traits<tests::position>
 {
     static constexpr bool reflected = true;
@@ -86,6 +99,126 @@ TEST_CASE("ECS entities and stable paged components")
     REQUIRE_FALSE(owner.alive(first));
 }
 
+TEST_CASE("Dense components stay packed and views walk them without lookups")
+{
+    world owner;
+    std::vector<entity> values;
+    for (std::uint32_t index = 0; index < 3000; ++index)
+    {
+        const entity value = owner.create();
+        owner.emplace<packed_value>(value, packed_value{index});
+        if (index % 3 == 0) owner.emplace<position>(value, position{static_cast<float>(index), 0.0f});
+        values.push_back(value);
+    }
+    std::uint64_t expected_all{};
+    std::uint64_t expected_joined{};
+    for (std::uint32_t index = 0; index < 3000; ++index)
+    {
+        if (index % 5 == 0)
+        {
+            REQUIRE(owner.remove<packed_value>(values[index]));
+            continue;
+        }
+        expected_all += index;
+        if (index % 3 == 0) expected_joined += index;
+    }
+    REQUIRE(std::as_const(owner).get<packed_value>(values[2999]).value == 2999);
+
+    std::uint64_t all{};
+    owner.view<packed_value>().each([&](entity, const packed_value& packed) { all += packed.value; });
+    REQUIRE(all == expected_all);
+
+    std::size_t mismatched{};
+    const auto joined_sum = [&]
+    {
+        std::uint64_t sum{};
+        std::vector<entity> order;
+        owner.view<position, packed_value>().each(
+            [&](entity value, const position& place, const packed_value& packed)
+            {
+                if (static_cast<std::uint32_t>(place.x) != packed.value) ++mismatched;
+                sum += packed.value;
+                order.push_back(value);
+            });
+        return std::pair{sum, order};
+    };
+    REQUIRE(joined_sum().first == expected_joined);
+    owner.prepare_query<position, packed_value>();
+    const auto [prepared_sum, prepared_order] = joined_sum();
+    REQUIRE(prepared_sum == expected_joined);
+    REQUIRE(std::is_sorted(prepared_order.begin(), prepared_order.end(),
+                           [](entity left, entity right) { return left.index < right.index; }));
+    REQUIRE(mismatched == 0);
+
+    const world copy(owner);
+    std::uint64_t copied{};
+    copy.view<packed_value>().each([&](entity, const packed_value& packed) { copied += packed.value; });
+    REQUIRE(copied == expected_all);
+}
+
+TEST_CASE("Archetype worlds keep entity, change and structural semantics")
+{
+    world owner(arc::memory::default_memory_system(), 0, {}, arc::memory::component_layout::archetype);
+    REQUIRE(owner.layout() == arc::memory::component_layout::archetype);
+    owner.prepare_query<position, velocity>();
+    std::vector<entity> values;
+    for (std::uint32_t index = 0; index < 3000; ++index)
+    {
+        const entity value = owner.create();
+        owner.emplace<packed_value>(value, packed_value{index});
+        owner.emplace<position>(value, position{static_cast<float>(index), 0.0f});
+        if (index % 2 == 0) owner.emplace<velocity>(value, velocity{1.0f, 0.0f});
+        values.push_back(value);
+    }
+    for (std::uint32_t index = 0; index < 3000; index += 10)
+        REQUIRE(owner.destroy(values[index]));
+    REQUIRE(owner.remove<velocity>(values[2]));
+    REQUIRE_FALSE(owner.has<velocity>(values[2]));
+    REQUIRE(owner.get<position>(values[2999]).x == 2999.0f);
+
+    std::size_t moving{};
+    std::size_t mismatched{};
+    owner.view<position, velocity>().each(
+        [&](entity value, const position& place, const velocity&)
+        {
+            if (std::as_const(owner).get<packed_value>(value).value != static_cast<std::uint32_t>(place.x))
+                ++mismatched;
+            ++moving;
+        });
+    REQUIRE(moving == 1500 - 300 - 1);
+    REQUIRE(mismatched == 0);
+    std::size_t listed{};
+    for (const entity value : owner.query<query_read<position>, query_write<velocity>>())
+        listed += owner.has<velocity>(value) ? 1 : 0;
+    REQUIRE(listed == moving);
+    owner.prepare_typed_query<query_read<position>, query_exclude<velocity>>();
+    listed = 0;
+    for (const entity value : owner.query<query_read<position>, query_exclude<velocity>>())
+        listed += owner.has<velocity>(value) ? 0 : 1;
+    REQUIRE(listed == 2700 - moving);
+
+    const change_cursor before{owner.revision()};
+    REQUIRE(owner.patch_field<position>(values[4], 2, [](position& place) { place.y = 3.0f; }));
+    std::size_t changed{};
+    for (const component_change change : owner.changes_since<position>(before))
+    {
+        REQUIRE(change.value == values[4]);
+        REQUIRE(change.fields == 2);
+        ++changed;
+    }
+    REQUIRE(changed == 1);
+    const auto structural_before = owner.structural_changes().size();
+    REQUIRE(owner.destroy(values[4]));
+    REQUIRE(owner.structural_changes().size() == structural_before + 4);
+
+    const world copy(owner);
+    REQUIRE(copy.live_count() == owner.live_count());
+    REQUIRE(std::as_const(copy).get<position>(values[2999]).x == 2999.0f);
+    std::size_t copied{};
+    copy.view<packed_value>().each([&](entity, const packed_value&) { ++copied; });
+    REQUIRE(copied == owner.live_count());
+}
+
 TEST_CASE("Prepared queries update after structural changes")
 {
     world owner;
@@ -124,6 +257,47 @@ TEST_CASE("Prepared queries support exclusions and optional declarations")
     REQUIRE(matched == std::vector<entity>{visible, excluded});
 }
 
+TEST_CASE("Command flushes settle prepared queries once per batch")
+{
+    world owner;
+    owner.prepare_query<position, velocity>();
+    owner.prepare_typed_query<query_exclude<hidden>>();
+    const entity stale = owner.create();
+    owner.emplace<position>(stale);
+    owner.emplace<velocity>(stale);
+    const entity kept = owner.create();
+    owner.emplace<position>(kept);
+
+    entity_command_buffer commands;
+    commands.destroy(stale);
+    const deferred_entity spawned = commands.create();
+    commands.add<position>(spawned, {});
+    commands.add<velocity>(spawned, {});
+    commands.add<velocity>(kept, {});
+    commands.add<hidden>(kept, {});
+    REQUIRE(commands.flush(owner).errors.empty());
+
+    const auto collect = [](const query_entity_range& range)
+    {
+        std::vector<entity> result;
+        for (const entity value : range)
+            result.push_back(value);
+        return result;
+    };
+    const entity reused{stale.index, stale.generation + 1};
+    REQUIRE(owner.alive(reused));
+    REQUIRE(collect(owner.query<query_read<position>, query_read<velocity>>()) ==
+            std::vector<entity>{reused, kept});
+    REQUIRE(collect(owner.query<query_exclude<hidden>>()) == std::vector<entity>{reused});
+
+    // A copy rebuilds its queries from scratch, so it is the reference for the incremental result.
+    const world rebuilt(owner);
+    REQUIRE(collect(rebuilt.query<query_read<position>, query_read<velocity>>()) ==
+            collect(owner.query<query_read<position>, query_read<velocity>>()));
+    owner.destroy(reused);
+    REQUIRE(collect(owner.query<query_exclude<hidden>>()).empty());
+}
+
 TEST_CASE("Frozen component registries assign deterministic compact indices")
 {
     component_type_registry first;
@@ -186,6 +360,105 @@ TEST_CASE("World move assignment keeps component storage resources alive")
     REQUIRE(query_count == 1);
 }
 
+TEST_CASE("World snapshots copy only component pages touched since the previous capture")
+{
+    world owner;
+    owner.prepare_query<packed_value>();
+    std::vector<entity> values;
+    for (std::uint32_t index = 0; index < 20000; ++index)
+    {
+        values.push_back(owner.create());
+        owner.emplace<packed_value>(values.back(), packed_value{index});
+        owner.emplace<position>(values.back(), position{static_cast<float>(index), 0.0f});
+    }
+
+    const world_snapshot first = owner.snapshot();
+    REQUIRE(first.incremental_bytes() == first.total_bytes());
+    owner.get<packed_value>(values[7]).value = 700;
+    const world_snapshot second = owner.snapshot(&first);
+    REQUIRE(second.total_bytes() == first.total_bytes());
+    REQUIRE(second.incremental_bytes() * 4 < second.total_bytes());
+
+    // Removal moves the last value into the hole, so the pages of both are copied again.
+    REQUIRE(owner.destroy(values[3]));
+    const world_snapshot third = owner.snapshot(&second);
+    REQUIRE(third.live_count() == values.size() - 1u);
+    REQUIRE(third.incremental_bytes() * 2 < third.total_bytes());
+
+    world restored(first);
+    REQUIRE(restored.get<packed_value>(values[7]).value == 7u);
+    REQUIRE(restored.alive(values[3]));
+    world modified(third);
+    REQUIRE(std::as_const(modified).get<packed_value>(values[7]).value == 700u);
+    REQUIRE_FALSE(modified.alive(values[3]));
+    REQUIRE(std::as_const(modified).get<packed_value>(values.back()).value == values.size() - 1u);
+    REQUIRE(modified.storage_id() != owner.storage_id());
+    std::size_t matched{};
+    for (const entity value : modified.query<query_read<packed_value>>())
+    {
+        (void)value;
+        ++matched;
+    }
+    REQUIRE(matched == values.size() - 1u);
+
+    // A snapshot of a different world shares nothing.
+    const world_snapshot unrelated = restored.snapshot(&third);
+    REQUIRE(unrelated.incremental_bytes() == unrelated.total_bytes());
+}
+
+TEST_CASE("Rollback rings replay per-tick deltas forward from their keyframes")
+{
+    world owner;
+    owner.prepare_query<packed_value>();
+    std::vector<entity> values;
+    for (std::uint32_t index = 0; index < 64; ++index)
+    {
+        values.push_back(owner.create());
+        owner.emplace<packed_value>(values.back(), packed_value{index});
+    }
+
+    rollback_ring ring(4);
+    std::vector<entity> spawned;
+    for (std::uint64_t tick = 1; tick <= 10; ++tick)
+    {
+        owner.get<packed_value>(values[tick]).value = static_cast<std::uint32_t>(tick * 100);
+        if (tick % 3 == 0) REQUIRE(owner.destroy(values[tick + 20]));
+        spawned.push_back(owner.create());
+        owner.emplace<position>(spawned.back(), position{static_cast<float>(tick), 0.0f});
+        ring.capture(owner, simulation_tick_id{tick});
+    }
+    REQUIRE(ring.newest() == simulation_tick_id{10});
+    REQUIRE(ring.size() >= ring.depth());
+    REQUIRE_FALSE(ring.contains(simulation_tick_id{1}));
+    REQUIRE_THROWS_AS(ring.restore(simulation_tick_id{1}), std::out_of_range);
+    REQUIRE_THROWS_AS(ring.capture(owner, simulation_tick_id{10}), std::invalid_argument);
+
+    world restored = ring.restore(simulation_tick_id{7});
+    REQUIRE(restored.storage_id() != owner.storage_id());
+    REQUIRE(std::as_const(restored).get<packed_value>(values[7]).value == 700u);
+    REQUIRE(std::as_const(restored).get<packed_value>(values[8]).value == 8u);
+    REQUIRE_FALSE(restored.alive(values[26]));
+    REQUIRE(restored.alive(values[29]));
+    REQUIRE(restored.alive(spawned[6]));
+    REQUIRE_FALSE(restored.alive(spawned[7]));
+    REQUIRE(std::as_const(restored).get<position>(spawned[6]).x == 7.0f);
+    std::size_t matched{};
+    for (const entity value : restored.query<query_read<packed_value>>())
+    {
+        (void)value;
+        ++matched;
+    }
+    REQUIRE(matched == values.size() - 2u);
+
+    // Re-simulating from a restored tick replaces the ticks after it.
+    ring.truncate_after(simulation_tick_id{7});
+    REQUIRE(ring.newest() == simulation_tick_id{7});
+    restored.get<packed_value>(values[8]).value = 8000;
+    ring.capture(restored, simulation_tick_id{8});
+    const world replayed = ring.restore(simulation_tick_id{8});
+    REQUIRE(replayed.get<packed_value>(values[8]).value == 8000u);
+}
+
 TEST_CASE("Field revisions preserve independent change cursors")
 {
     world owner;
@@ -243,6 +516,105 @@ TEST_CASE("Command buffers resolve deferred entities deterministically")
             std::as_const(owner).view<position>().entities().end());
 }
 
+TEST_CASE("Command buffers keep payloads in place and resolve across buffers")
+{
+    static int live{};
+    struct counted
+    {
+        counted() noexcept
+        {
+            ++live;
+        }
+        counted(const counted&) noexcept
+        {
+            ++live;
+        }
+        counted(counted&&) noexcept
+        {
+            ++live;
+        }
+        counted& operator=(const counted&) = default;
+        counted& operator=(counted&&) = default;
+        ~counted()
+        {
+            --live;
+        }
+        std::vector<int> values{1, 2, 3};
+    };
+
+    world owner;
+    {
+        entity_command_buffer discarded;
+        discarded.add<counted>(discarded.create(), counted{});
+        REQUIRE(live == 1);
+        discarded.clear();
+        REQUIRE(live == 0);
+        REQUIRE(discarded.empty());
+    }
+
+    entity_command_buffer spawner({1, 1, 0});
+    entity_command_buffer decorator({1, 2, 0});
+    const deferred_entity made = spawner.create();
+    spawner.add<counted>(made, counted{});
+    decorator.add<position>(made, position{4.0f, 0.0f});
+    decorator.patch<position>(made, [](position& value) { value.y = 5.0f; });
+    decorator.remove<velocity>(made);
+    REQUIRE(decorator.size() == 3);
+
+    std::vector<entity_command_buffer*> buffers{&decorator, &spawner};
+    const command_flush_result result = entity_command_buffer::flush_ordered(owner, buffers);
+    REQUIRE(result.applied == 4);
+    REQUIRE(result.errors.size() == 1);
+    REQUIRE(result.errors.front().code == command_error_code::stale_entity);
+    REQUIRE(live == 1);
+    const entity value = owner.entities().front();
+    REQUIRE(std::as_const(owner).get<position>(value).y == 5.0f);
+    REQUIRE(std::as_const(owner).get<counted>(value).values.size() == 3);
+    REQUIRE(spawner.empty());
+    REQUIRE(decorator.empty());
+    REQUIRE(owner.destroy(value));
+    REQUIRE(live == 0);
+}
+
+TEST_CASE("Command buffers align payloads stricter than the arena's blocks")
+{
+    struct alignas(64) wide_block
+    {
+        std::array<float, 16> values{};
+    };
+
+    world owner;
+    const entity value = owner.create();
+    owner.emplace<position>(value, position{});
+    // Several live arenas so at least one block starts off a 64-byte boundary.
+    std::vector<entity_command_buffer> buffers(4);
+    for (auto& commands : buffers)
+    {
+        for (int index = 0; index < 4; ++index)
+        {
+            commands.remove<velocity>(value);
+            wide_block captured;
+            captured.values[0] = 1.0f;
+            commands.patch<position>(
+                value,
+                [captured](position& target)
+                {
+                    // Read back through volatile so the check is not folded away by the type's alignment.
+                    const volatile std::uintptr_t address = reinterpret_cast<std::uintptr_t>(&captured);
+                    REQUIRE(address % alignof(wide_block) == 0);
+                    target.x += captured.values[0];
+                });
+        }
+    }
+    buffers.back().add<wide_block>(value, wide_block{});
+
+    std::size_t applied{};
+    for (auto& commands : buffers)
+        applied += commands.flush(owner).applied;
+    REQUIRE(applied == 17);
+    REQUIRE(std::as_const(owner).get<position>(value).x == 16.0f);
+}
+
 TEST_CASE("Command buffers support default and explicit sort keys")
 {
     entity_command_buffer default_buffer;
@@ -291,6 +663,76 @@ TEST_CASE("System scheduler orders write conflicts and permits commands")
     REQUIRE(owner.live_count() == 2);
 }
 
+TEST_CASE("Parallel chunks split prepared queries and flush their commands deterministically")
+{
+    arc::jobs::job_system jobs(arc::jobs::job_system_config{
+        .worker_count = 4, .run_inline = false, .io_worker_count = 0, .enable_render_thread = false});
+    for (const auto layout : {arc::memory::component_layout::sparse_set, arc::memory::component_layout::archetype})
+    {
+        world owner(arc::memory::default_memory_system(), 0, {}, layout);
+        owner.prepare_typed_query<query_write<position>, query_read<velocity>>();
+        std::vector<entity> values;
+        for (std::uint32_t index = 0; index < 5000; ++index)
+        {
+            const entity value = owner.create();
+            owner.emplace<position>(value, position{static_cast<float>(index), 0.0f});
+            if (index % 4 != 0) owner.emplace<velocity>(value, velocity{1.0f, 0.0f});
+            if (index % 8 == 1) owner.emplace<packed_value>(value, packed_value{index});
+            values.push_back(value);
+        }
+
+        system_scheduler scheduler;
+        std::atomic<std::size_t> visited{};
+        std::atomic<std::size_t> oversized{};
+        REQUIRE(scheduler.add({.name = "integrate",
+                               .components = {writes<position>(), reads<velocity>()},
+                               .execute = [&](system_context& context)
+                               {
+                                   context.commands().create();
+                                   context.par_each<query_write<position>, query_read<velocity>>(
+                                       [&](entity value, system_chunk& chunk)
+                                       {
+                                           chunk.write<position>(value)->x += chunk.read<velocity>(value)->x;
+                                           visited.fetch_add(1, std::memory_order_relaxed);
+                                           if (chunk.entities().size() > 256)
+                                               oversized.fetch_add(1, std::memory_order_relaxed);
+                                           if (std::as_const(context.owner()).has<packed_value>(value))
+                                               chunk.commands().add<hidden>(value, hidden{});
+                                       },
+                                       256);
+                               }}));
+        const change_cursor before{owner.revision()};
+        const system_run_result result = scheduler.run(owner, jobs, 1.0f / 60.0f);
+        REQUIRE(result.succeeded());
+        REQUIRE(visited.load() == 3750);
+        REQUIRE(oversized.load() == 0);
+        REQUIRE(result.commands.applied == 1 + 625);
+        REQUIRE(owner.live_count() == 5001);
+        std::size_t moved{};
+        for (std::uint32_t index = 0; index < 5000; ++index)
+        {
+            const float expected = static_cast<float>(index) + (index % 4 != 0 ? 1.0f : 0.0f);
+            if (std::as_const(owner).get<position>(values[index]).x == expected) ++moved;
+            REQUIRE(owner.has<hidden>(values[index]) == (index % 8 == 1));
+        }
+        REQUIRE(moved == 5000);
+        std::size_t changed{};
+        for (const component_change change : owner.changes_since<position>(before))
+            changed += change.value.valid() ? 1 : 0;
+        REQUIRE(changed == 3750);
+
+        system_scheduler invalid;
+        REQUIRE(invalid.add({.name = "undeclared",
+                             .components = {reads<position>(), reads<velocity>()},
+                             .execute = [](system_context& context)
+                             {
+                                 context.par_each<query_write<position>, query_read<velocity>>(
+                                     [](entity, system_chunk&) {});
+                             }}));
+        REQUIRE_FALSE(invalid.run(owner, jobs, 1.0f / 60.0f).succeeded());
+    }
+}
+
 TEST_CASE("System scheduler honors forward dependencies and validates declared access")
 {
     world owner;
@@ -348,6 +790,115 @@ TEST_CASE("System schedules freeze after validation and reject impossible phase
     REQUIRE_FALSE(invalid.frozen());
 }
 
+TEST_CASE("Frozen schedules run dependency waves and report per-system timings")
+{
+    arc::jobs::job_system jobs(arc::jobs::job_system_config{
+        .worker_count = 4, .run_inline = false, .io_worker_count = 0, .enable_render_thread = false});
+    world owner;
+    const entity value = owner.create();
+    owner.emplace<position>(value);
+    std::atomic<int> readers{};
+    std::atomic<int> misordered{};
+
+    system_scheduler scheduler;
+    REQUIRE(scheduler.add({.name = "source",
+                           .components = {writes<position>()},
+                           .execute = [&](system_context& context) { context.write<position>(value)->x += 1.0f; }}));
+    for (int index = 0; index < 8; ++index)
+    {
+        REQUIRE(scheduler.add({.name = "reader" + std::to_string(index),
+                               .components = {reads<position>()},
+                               .execute = [&](system_context& context)
+                               {
+                                   if (context.read<position>(value)->y != 0.0f) misordered.fetch_add(1);
+                                   readers.fetch_add(1);
+                                   context.commands().create();
+                               }}));
+    }
+    REQUIRE(scheduler.add({.name = "sink",
+                           .components = {writes<position>()},
+                           .execute = [&](system_context& context)
+                           {
+                               if (readers.load() % 8 != 0) misordered.fetch_add(1);
+                               context.write<position>(value)->y = context.read<position>(value)->x;
+                           }}));
+    REQUIRE(scheduler.freeze().empty());
+
+    for (int frame = 1; frame <= 3; ++frame)
+    {
+        owner.get<position>(value).y = 0.0f;
+        const system_run_result result = scheduler.run(owner, jobs, 1.0f / 60.0f);
+        REQUIRE(result.succeeded());
+        REQUIRE(result.systems_executed == 10);
+        REQUIRE(result.timings.size() == 10);
+        REQUIRE(result.timings.front().system == "source");
+        REQUIRE(result.timings.back().system == "sink");
+        REQUIRE(result.commands.applied == 8);
+        REQUIRE(std::as_const(owner).get<position>(value).y == static_cast<float>(frame));
+    }
+    REQUIRE(misordered.load() == 0);
+    REQUIRE(owner.live_count() == 25);
+
+    system_scheduler failing;
+    REQUIRE(failing.add({.name = "broken",
+                         .components = {writes<position>()},
+                         .execute = [](system_context&) { throw std::runtime_error("boom"); }}));
+    REQUIRE(failing.add({.name = "dependent", .after = {"broken"}, .execute = [](system_context&) {}}));
+    REQUIRE(failing.add({.name = "independent",
+                         .execute = [](system_context& context) { context.commands().create(); }}));
+    REQUIRE(failing.freeze().empty());
+    const system_run_result failed = failing.run(owner, jobs, 1.0f / 60.0f);
+    REQUIRE(failed.systems_executed == 1);
+    REQUIRE(failed.errors.size() == 2);
+    REQUIRE(failed.errors[0].system == "broken");
+    REQUIRE(failed.errors[0].message == "system execution failed: boom");
+    REQUIRE(failed.errors[1].message == "system was cancelled");
+    REQUIRE(failed.timings.size() == 2);
+    REQUIRE(owner.live_count() == 25);
+}
+
+TEST_CASE("System access bitsets explain the conflicts that separate systems")
+{
+    component_type_registry registry;
+    REQUIRE(registry.register_component<position>());
+    REQUIRE(registry.register_component<velocity>());
+    REQUIRE(registry.freeze());
+
+    world owner;
+    const entity value = owner.create();
+    owner.emplace<position>(value);
+    owner.emplace<velocity>(value, velocity{2.0f, 0.0f});
+    arc::jobs::job_system jobs(arc::jobs::job_system::single_threaded_config());
+    system_scheduler scheduler(registry);
+    std::vector<std::string> order;
+    const auto record = [&order](std::string name)
+    { return [&order, name](system_context&) { order.push_back(name); }; };
+    REQUIRE(scheduler.add({.name = "integrate",
+                           .components = {writes<position>(), reads<velocity>()},
+                           .execute = record("integrate")}));
+    REQUIRE(scheduler.add({.name = "steer", .components = {writes<velocity>()}, .execute = record("steer")}));
+    REQUIRE(scheduler.add({.name = "observe", .components = {reads<velocity>()}, .execute = record("observe")}));
+    REQUIRE(scheduler.add({.name = "flagged",
+                           .components = {reads<position>(), writes<packed_value>()},
+                           .before = {"integrate"},
+                           .execute = record("flagged")}));
+
+    const auto blocked = scheduler.access_conflicts("integrate", "steer");
+    REQUIRE(blocked.size() == 1);
+    REQUIRE(blocked.front().component == component_type<velocity>());
+    REQUIRE(blocked.front().first == component_access_mode::read);
+    REQUIRE(blocked.front().second == component_access_mode::write);
+    REQUIRE(scheduler.access_conflicts("integrate", "observe").empty());
+    const auto unregistered = scheduler.access_conflicts("flagged", "integrate");
+    REQUIRE(unregistered.size() == 1);
+    REQUIRE(unregistered.front().component == component_type<position>());
+    REQUIRE(unregistered.front().first == component_access_mode::read);
+
+    REQUIRE(scheduler.freeze().empty());
+    REQUIRE(scheduler.run(owner, jobs, 1.0f / 60.0f).succeeded());
+    REQUIRE(order == std::vector<std::string>{"flagged", "integrate", "steer", "observe"});
+}
+
 TEST_CASE("Intrusive hierarchy traverses without snapshots")
 {
     world owner;
@@ -365,6 +916,125 @@ TEST_CASE("Intrusive hierarchy traverses without snapshots")
         values.push_back(child);
     REQUIRE(values == std::vector<entity>{first, second});
     REQUIRE(is_descendant(owner, second, root));
+    REQUIRE(owner.get<hierarchy_component>(root).last_child == second);
+    detach(owner, second);
+    REQUIRE(owner.get<hierarchy_component>(root).last_child == first);
+}
+
+TEST_CASE("Batch spawns and destroys coalesce structural records in both layouts")
+{
+    entity_template prototype =
+        entity_template_builder("Crowd").component(position{2.0f, 3.0f}).component(velocity{1.0f, 0.0f}).build();
+    // A hand-written factory has no column-wise path and falls back to commands.
+    prototype.components.push_back({component_type<hidden>(), [](entity_command_buffer& commands, entity_target target)
+                                    { commands.add<hidden>(target, {}); }});
+
+    world sparse;
+    world archetypes(arc::memory::default_memory_system(), 0, {}, arc::memory::component_layout::archetype);
+    for (world* owner : {&sparse, &archetypes})
+    {
+        owner->prepare_query<position, velocity>();
+        owner->prepare_typed_query<query_read<position>, query_exclude<hidden>>();
+        const entity survivor = owner->create();
+        owner->emplace<position>(survivor);
+
+        const auto before = owner->structural_changes().size();
+        std::vector<entity> spawned(256);
+        owner->create_batch(prototype, spawned.size(), spawned);
+        const auto records = owner->structural_changes().subspan(before);
+        REQUIRE(owner->live_count() == spawned.size() + 1u);
+        REQUIRE(records.front().kind == structural_change_kind::entity_created);
+        REQUIRE(records.front().count == spawned.size());
+        REQUIRE(std::ranges::equal(owner->structural_entities(records.front()), spawned));
+        REQUIRE(records[1].kind == structural_change_kind::component_added);
+        REQUIRE(records[1].component == component_type<position>());
+        REQUIRE(owner->get<position>(spawned.back()).y == 3.0f);
+
+        std::size_t moving{};
+        for (const entity value : owner->query<query_read<position>, query_read<velocity>>())
+        {
+            (void)value;
+            ++moving;
+        }
+        REQUIRE(moving == spawned.size());
+        std::vector<entity> visible;
+        for (const entity value : owner->query<query_read<position>, query_exclude<hidden>>())
+            visible.push_back(value);
+        REQUIRE(visible == std::vector<entity>{survivor});
+
+        const auto before_destroy = owner->structural_changes().size();
+        spawned.push_back(entity{});
+        spawned.push_back(spawned.front());
+        REQUIRE(owner->destroy_batch(spawned) == spawned.size() - 2u);
+        const auto removals = owner->structural_changes().subspan(before_destroy);
+        REQUIRE(removals.size() == 4u);
+        REQUIRE(removals.back().kind == structural_change_kind::entity_destroyed);
+        REQUIRE(removals.back().count == spawned.size() - 2u);
+        REQUIRE(owner->live_count() == 1u);
+        REQUIRE(owner->query<query_read<position>, query_read<velocity>>().empty());
+    }
+}
+
+TEST_CASE("Sparse pools page their index lazily and report bytes under component tags")
+{
+    arc::memory::memory_system memory({.physical_memory_override = std::size_t{1} << 30,
+                                       .track_live_allocations = true,
+                                       .capture_call_stacks = false});
+    world owner(memory, 7);
+    std::vector<entity> crowd(100'000);
+    for (entity& value : crowd)
+    {
+        value = owner.create();
+        owner.emplace<position>(value);
+    }
+    const std::array rare{crowd[99'990], crowd[99'995], crowd[99'999]};
+    for (const entity value : rare)
+        owner.emplace<velocity>(value, velocity{1.0f, 0.0f});
+
+    const auto tag_bytes = [&memory](const component_descriptor& descriptor)
+    {
+        const auto tag = arc::memory::make_memory_tag(descriptor.canonical_name);
+        for (const auto& current : memory.snapshot().tags)
+            if (current.tag.id == tag.id && current.domain == arc::memory::memory_domain::components)
+                return current.bytes_outstanding;
+        return std::size_t{};
+    };
+    // Three high indices cost one index page, not a slot per entity in the world.
+    const std::size_t rare_bytes = tag_bytes(component_metadata<velocity>());
+    REQUIRE(rare_bytes > 0u);
+    REQUIRE(rare_bytes < 16u * 1024u);
+    REQUIRE(tag_bytes(component_metadata<position>()) > crowd.size() * sizeof(position));
+
+    // Emptied index pages are kept for the next insert until the world is asked to shrink.
+    for (const entity value : rare)
+        REQUIRE(owner.remove<velocity>(value));
+    REQUIRE(tag_bytes(component_metadata<velocity>()) == rare_bytes);
+    owner.shrink_to_fit();
+    REQUIRE(tag_bytes(component_metadata<velocity>()) <= rare_bytes - sparse_index::page_bytes);
+    REQUIRE(owner.get<position>(crowd.back()).x == 0.0f);
+
+    owner.destroy(crowd[99'999]);
+    const entity reused = owner.create();
+    REQUIRE(reused.index == crowd[99'999].index);
+    REQUIRE_FALSE(owner.has<position>(reused));
+    owner.emplace<velocity>(reused, velocity{2.0f, 0.0f});
+    REQUIRE(owner.get<velocity>(reused).x == 2.0f);
+
+    // Churn on both sides of a page boundary reuses the same pages.
+    sparse_index index;
+    const auto boundary = static_cast<std::uint32_t>(sparse_index::page_entries);
+    for (std::uint32_t round = 0; round < 64; ++round)
+    {
+        index.insert(boundary - 1, round);
+        index.insert(boundary, round);
+        REQUIRE(index.find(boundary) == round);
+        index.erase(boundary - 1);
+        index.erase(boundary);
+        REQUIRE(index.page_count() == 2u);
+    }
+    REQUIRE(index.find(boundary) == sparse_index::npos);
+    index.shrink_to_fit();
+    REQUIRE(index.page_count() == 0u);
 }
 
 TEST_CASE("Templates, prefab overrides, and regions expose stable contracts")
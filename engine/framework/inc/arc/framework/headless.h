@@ -4,6 +4,7 @@
 #include <arc/framework/runtime_world.h>
 
 #include <cstdint>
+#include <filesystem>
 #include <string>
 
 namespace arc::framework
@@ -16,6 +17,8 @@ struct headless_runtime_options
     runtime_world_role default_world_role{runtime_world_role::server};
     bool sleep_to_clock{true};
     bool enable_debug_time_controls{};
+    /** When set, the retained job timeline is written here as Chrome trace JSON after shutdown. */
+    std::filesystem::path job_trace_path;
 };
 
 struct [[nodiscard]] headless_runtime_result
@@ -8,6 +8,7 @@
 #include <compare>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -47,6 +48,13 @@ struct runtime_world_descriptor
     memory::memory_budget memory{};
     bool install_placeholder_systems{true};
     bool presentation_enabled{true};
+    /**
+     * The world reads and writes no other world's state while it runs, so
+     * consecutive isolated worlds in execution order tick concurrently on the
+     * job system with their own tick and frame arenas. Services its systems
+     * reach must tolerate concurrent callers.
+     */
+    bool isolated{};
 };
 
 struct world_snapshot_id
@@ -67,6 +75,7 @@ struct world_snapshot_metadata
     simulation_tick_id tick{};
     double simulation_time_seconds{};
     std::uint64_t world_epoch{};
+    /** Bytes the capture added; component pages shared with the world's previous snapshot are not counted. */
     std::size_t estimated_bytes{};
     std::string label;
 };
@@ -78,10 +87,22 @@ struct [[nodiscard]] world_snapshot_result
     std::string error;
 };
 
+/** Wall time one world spent in a fixed tick or presentation pass. */
+struct runtime_world_timing
+{
+    runtime_world_id world{};
+    std::uint64_t nanoseconds{};
+    std::size_t systems_executed{};
+    /** The world ran alongside other isolated worlds rather than alone. */
+    bool concurrent{};
+};
+
 struct [[nodiscard]] runtime_world_run_result
 {
     std::size_t systems_executed{};
     std::vector<ecs::system_schedule_error> errors;
+    /** One entry per world that was asked to run, in execution order. */
+    std::vector<runtime_world_timing> worlds;
 
     [[nodiscard]] bool succeeded() const noexcept
     {
@@ -186,6 +207,11 @@ private:
     simulation_tick_id last_completed_tick_{};
     std::uint64_t epoch_{1};
     std::string fault_message_;
+    std::optional<ecs::rollback_ring> rollback_;
+    memory::system_memory_resource tick_memory_resource_;
+    memory::system_memory_resource frame_memory_resource_;
+    memory::tick_arena tick_arena_;
+    memory::frame_arena frame_arena_;
 };
 
 class runtime_world_manager
@@ -221,6 +247,13 @@ public:
     void stop_all() noexcept;
     void pause_all() noexcept;
     void resume_all() noexcept;
+    /** Resets the frame arenas of isolated worlds; call where the shared frame arena is reset. */
+    void reset_frame_memory() noexcept;
+    /** Per-world breakdown of the most recent fixed tick. */
+    [[nodiscard]] const std::vector<runtime_world_timing>& last_fixed_timings() const noexcept
+    {
+        return last_fixed_timings_;
+    }
 
     void set_snapshot_budget(std::size_t bytes) noexcept;
     [[nodiscard]] world_snapshot_result capture_snapshot(runtime_world_id world, simulation_tick_id tick,
@@ -230,19 +263,36 @@ public:
                                                          runtime_service_registry* services = nullptr);
     [[nodiscard]] std::vector<world_snapshot_metadata> snapshots() const;
 
+    /**
+     * Keeps the entities of each world's last `ticks` completed fixed ticks as
+     * a keyframe and per-tick deltas; zero drops every world's history.
+     */
+    void set_rollback_depth(std::size_t ticks);
+    /**
+     * Rewinds a world's entities to a completed tick still in its history and
+     * forgets the ticks after it. Partitions and service state are not part
+     * of the history; use snapshots for those.
+     */
+    [[nodiscard]] world_snapshot_result rollback(runtime_world_id world, simulation_tick_id tick);
+
 private:
     struct stored_snapshot
     {
         world_snapshot_metadata metadata;
         runtime_world_descriptor descriptor;
-        ecs::world entities;
+        ecs::world_snapshot entities;
         ecs::world_partition partition;
         std::vector<runtime_service_snapshot> services;
         simulation_tick_id last_completed_tick{};
     };
 
+    using world_runner = std::function<runtime_world_run_result(runtime_world&, memory::tick_arena&,
+                                                                 memory::frame_arena&)>;
+
     [[nodiscard]] const std::vector<runtime_world*>& execution_order() const noexcept;
     void rebuild_execution_order();
+    runtime_world_run_result run_worlds(jobs::job_system& jobs, memory::tick_arena& tick_memory,
+                                        memory::frame_arena& frame_memory, const world_runner& run);
     void trim_snapshots();
 
     memory::memory_system* memory_{};
@@ -253,6 +303,8 @@ private:
     std::uint64_t next_snapshot_id_{1};
     std::size_t snapshot_budget_bytes_{};
     std::size_t snapshot_bytes_{};
+    std::size_t rollback_depth_{};
+    std::vector<runtime_world_timing> last_fixed_timings_;
     bool executing_{};
 };
 
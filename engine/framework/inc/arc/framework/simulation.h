@@ -35,6 +35,8 @@ struct simulation_config
     std::uint64_t process_seed{0x4152435f53454544ull};
     simulation_overrun_policy overrun_policy{simulation_overrun_policy::discard_excess};
     std::size_t snapshot_budget_bytes{};
+    /** Fixed ticks each world keeps for rollback; zero disables the history. */
+    std::size_t rollback_depth_ticks{};
     bool headless{};
     bool presentation_enabled{true};
     bool allow_headless_time_controls{};
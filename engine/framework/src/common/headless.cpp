@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <exception>
+#include <fstream>
 #include <thread>
 
 namespace arc::framework
@@ -53,6 +54,13 @@ headless_runtime_result run_headless(application& app, headless_runtime_options
             }
         }
         host.shutdown();
+        if (!options.job_trace_path.empty())
+        {
+            std::ofstream trace(options.job_trace_path, std::ios::binary | std::ios::trunc);
+            jobs::write_chrome_trace(trace, host.jobs().snapshot(true));
+            if (!trace && world_failure.empty())
+                world_failure = "failed to write job trace: " + options.job_trace_path.string();
+        }
         return {.succeeded = world_failure.empty(), .completed_ticks = completed, .error = std::move(world_failure)};
     }
     catch (const std::exception& error)
@@ -42,6 +42,7 @@ runtime::runtime(application& app, application_config config)
 {
     jobs_.register_main_thread();
     worlds_.set_snapshot_budget(config_.simulation.snapshot_budget_bytes);
+    worlds_.set_rollback_depth(config_.simulation.rollback_depth_ticks);
 }
 
 runtime::~runtime()
@@ -226,7 +227,9 @@ frame_time runtime::advance(double wall_delta_seconds)
     modules_.update(module_context_, current_time_);
     app_->on_update(current_time_);
     jobs_.pump_main_thread();
+    jobs_.flush_profile_events();
     frame_arena_.reset();
+    worlds_.reset_frame_memory();
     if (current_time_.completed_ticks != 0) sampled_input_.clear();
     ++current_time_.frame_index;
     return current_time_;
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <exception>
+#include <iterator>
 #include <stdexcept>
 #include <utility>
 
@@ -10,8 +13,6 @@ namespace arc::framework
 namespace
 {
 
-constexpr std::size_t estimated_entity_snapshot_bytes = 256;
-
 constexpr int role_order(runtime_world_role role) noexcept
 {
     switch (role)
@@ -73,7 +74,12 @@ private:
 
 runtime_world::runtime_world(memory::memory_system& memory, runtime_world_id id, runtime_world_descriptor descriptor)
     : id_(id), descriptor_(std::move(descriptor)), owned_entities_(memory, id.value, descriptor_.memory),
-      entities_(&owned_entities_)
+      entities_(&owned_entities_),
+      tick_memory_resource_(memory, memory::memory_domain::tick, memory::make_memory_tag("runtime.world.tick"),
+                            id.value),
+      frame_memory_resource_(memory, memory::memory_domain::frame, memory::make_memory_tag("runtime.world.frame"),
+                             id.value),
+      tick_arena_(32u * 1024u, &tick_memory_resource_), frame_arena_(64u * 1024u, &frame_memory_resource_)
 {
     if (descriptor_.name.empty()) descriptor_.name = "World " + std::to_string(id.value);
     if (descriptor_.seed == 0) descriptor_.seed = ecs::splitmix64(id.value);
@@ -235,6 +241,7 @@ runtime_world& runtime_world_manager::create(runtime_world_descriptor descriptor
     if (executing_) throw std::logic_error("runtime worlds may only be created at frame boundaries");
     const runtime_world_id id{next_world_id_++};
     auto value = std::make_unique<runtime_world>(*memory_, id, std::move(descriptor));
+    if (rollback_depth_ != 0) value->rollback_.emplace(rollback_depth_);
     runtime_world& result = *value;
     worlds_.push_back(std::move(value));
     rebuild_execution_order();
@@ -302,16 +309,20 @@ runtime_world_run_result runtime_world_manager::run_fixed(jobs::job_system& jobs
                                                           memory::tick_arena& tick_memory,
                                                           memory::frame_arena& frame_memory, std::uint64_t process_seed)
 {
-    runtime_world_run_result aggregate;
     execution_scope scope(executing_);
-    for (runtime_world* world : execution_order())
-    {
-        runtime_world_run_result result =
-            world->run_fixed(jobs, tick, services, input, tick_memory, frame_memory, process_seed);
-        aggregate.systems_executed += result.systems_executed;
-        aggregate.errors.insert(aggregate.errors.end(), std::make_move_iterator(result.errors.begin()),
-                                std::make_move_iterator(result.errors.end()));
-    }
+    runtime_world_run_result aggregate = run_worlds(
+        jobs, tick_memory, frame_memory,
+        [&](runtime_world& world, memory::tick_arena& world_tick_memory, memory::frame_arena& world_frame_memory)
+        {
+            runtime_world_run_result result =
+                world.run_fixed(jobs, tick, services, input, world_tick_memory, world_frame_memory, process_seed);
+            if (world.rollback_ && world.last_completed_tick_ == tick.id)
+                world.rollback_->capture(*world.entities_, tick.id);
+            // The caller resets the shared tick arena; a world's own slice is reset here.
+            if (&world_tick_memory != &tick_memory) world_tick_memory.reset();
+            return result;
+        });
+    last_fixed_timings_ = aggregate.worlds;
     return aggregate;
 }
 
@@ -321,16 +332,80 @@ runtime_world_manager::run_presentation(jobs::job_system& jobs, const simulation
                                         const simulation_input_snapshot* input, memory::tick_arena& tick_memory,
                                         memory::frame_arena& frame_memory, std::uint64_t process_seed)
 {
-    runtime_world_run_result aggregate;
     execution_scope scope(executing_);
-    for (runtime_world* world : execution_order())
+    return run_worlds(
+        jobs, tick_memory, frame_memory,
+        [&](runtime_world& world, memory::tick_arena& world_tick_memory, memory::frame_arena& world_frame_memory)
+        {
+            return world.run_presentation(jobs, tick, frame_delta_seconds, interpolation_alpha, services, input,
+                                          world_tick_memory, world_frame_memory, process_seed);
+        });
+}
+
+runtime_world_run_result runtime_world_manager::run_worlds(jobs::job_system& jobs, memory::tick_arena& tick_memory,
+                                                           memory::frame_arena& frame_memory, const world_runner& run)
+{
+    const std::vector<runtime_world*>& order = execution_order();
+    std::vector<runtime_world_run_result> results(order.size());
+    const auto run_one = [&](std::size_t index, bool concurrent)
+    {
+        runtime_world& world = *order[index];
+        const auto started = std::chrono::steady_clock::now();
+        // Concurrent worlds cannot share the caller's arenas, so each allocates from its own slice.
+        results[index] = concurrent ? run(world, world.tick_arena_, world.frame_arena_)
+                                    : run(world, tick_memory, frame_memory);
+        const auto elapsed = std::chrono::steady_clock::now() - started;
+        results[index].worlds.push_back(
+            {world.id_,
+             static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+             results[index].systems_executed, concurrent});
+    };
+
+    for (std::size_t begin = 0; begin < order.size();)
+    {
+        std::size_t end = begin + 1;
+        if (order[begin]->descriptor_.isolated)
+            while (end < order.size() && order[end]->descriptor_.isolated)
+                ++end;
+        if (end - begin == 1)
+        {
+            run_one(begin, false);
+            begin = end;
+            continue;
+        }
+
+        // The caller ticks the first isolated world itself while workers take the rest of the run.
+        std::vector<jobs::job_handle> handles;
+        handles.reserve(end - begin - 1);
+        for (std::size_t index = begin + 1; index < end; ++index)
+            handles.push_back(
+                jobs.submit({.name = "runtime world"}, [&run_one, index] { run_one(index, true); }));
+        std::exception_ptr failure;
+        try
+        {
+            run_one(begin, true);
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        for (const jobs::job_handle& handle : handles)
+        {
+            const jobs::job_wait_result waited = handle.wait_result();
+            if (!failure && waited.exception) failure = waited.exception;
+        }
+        if (failure) std::rethrow_exception(failure);
+        begin = end;
+    }
+
+    runtime_world_run_result aggregate;
+    aggregate.worlds.reserve(results.size());
+    for (runtime_world_run_result& result : results)
     {
-        runtime_world_run_result result =
-            world->run_presentation(jobs, tick, frame_delta_seconds, interpolation_alpha, services, input, tick_memory,
-                                    frame_memory, process_seed);
         aggregate.systems_executed += result.systems_executed;
         aggregate.errors.insert(aggregate.errors.end(), std::make_move_iterator(result.errors.begin()),
                                 std::make_move_iterator(result.errors.end()));
+        aggregate.worlds.insert(aggregate.worlds.end(), result.worlds.begin(), result.worlds.end());
     }
     return aggregate;
 }
@@ -359,6 +434,12 @@ void runtime_world_manager::resume_all() noexcept
         world->resume();
 }
 
+void runtime_world_manager::reset_frame_memory() noexcept
+{
+    for (auto& world : worlds_)
+        world->frame_arena_.reset();
+}
+
 void runtime_world_manager::set_snapshot_budget(std::size_t bytes) noexcept
 {
     snapshot_budget_bytes_ = bytes;
@@ -385,22 +466,26 @@ world_snapshot_result runtime_world_manager::capture_snapshot(runtime_world_id w
     for (const runtime_service_snapshot& snapshot : service_snapshots)
         service_bytes += snapshot.bytes.size();
 
-    world_snapshot_metadata metadata{
-        .id = {next_snapshot_id_++},
-        .world = world_id,
-        .tick = tick,
-        .simulation_time_seconds = simulation_time_seconds,
-        .world_epoch = world->epoch_,
-        .estimated_bytes = std::max<std::size_t>(estimated_entity_snapshot_bytes,
-                                                 world->entities_->live_count() * estimated_entity_snapshot_bytes) +
-                           service_bytes,
-        .label = std::move(label)};
+    // Component pages untouched since this world's latest snapshot are shared with it rather than copied.
+    const auto previous =
+        std::find_if(snapshots_.rbegin(), snapshots_.rend(),
+                     [world_id](const stored_snapshot& value) { return value.metadata.world == world_id; });
+    ecs::world_snapshot entities =
+        world->entities_->snapshot(previous != snapshots_.rend() ? &previous->entities : nullptr);
+
+    world_snapshot_metadata metadata{.id = {next_snapshot_id_++},
+                                     .world = world_id,
+                                     .tick = tick,
+                                     .simulation_time_seconds = simulation_time_seconds,
+                                     .world_epoch = world->epoch_,
+                                     .estimated_bytes = entities.incremental_bytes() + service_bytes,
+                                     .label = std::move(label)};
     if (snapshot_budget_bytes_ != 0 && metadata.estimated_bytes > snapshot_budget_bytes_)
         return {false, {}, "snapshot exceeds the configured snapshot budget"};
 
     stored_snapshot snapshot{.metadata = metadata,
                              .descriptor = world->descriptor_,
-                             .entities = *world->entities_,
+                             .entities = std::move(entities),
                              .partition = world->partition_,
                              .services = std::move(service_snapshots),
                              .last_completed_tick = world->last_completed_tick_};
@@ -430,12 +515,13 @@ world_snapshot_result runtime_world_manager::restore_snapshot(world_snapshot_id
 
     try
     {
-        ecs::world staged = found->entities;
+        ecs::world staged(found->entities);
         ecs::world_partition staged_partition = found->partition;
         world->entities_->swap(staged);
         world->partition_ = std::move(staged_partition);
         world->descriptor_.seed = found->descriptor.seed;
         world->last_completed_tick_ = found->last_completed_tick;
+        if (world->rollback_) world->rollback_->truncate_after(found->last_completed_tick);
         if (services) services->restore_deterministic_state(world->id_.value, found->services);
         ++world->epoch_;
         world->fault_message_.clear();
@@ -459,6 +545,48 @@ std::vector<world_snapshot_metadata> runtime_world_manager::snapshots() const
     return result;
 }
 
+void runtime_world_manager::set_rollback_depth(std::size_t ticks)
+{
+    rollback_depth_ = ticks;
+    for (auto& world : worlds_)
+    {
+        if (ticks == 0)
+            world->rollback_.reset();
+        else if (!world->rollback_ || world->rollback_->depth() != ticks)
+            world->rollback_.emplace(ticks);
+    }
+}
+
+world_snapshot_result runtime_world_manager::rollback(runtime_world_id world_id, simulation_tick_id tick)
+{
+    if (executing_) return {false, {}, "worlds may only be rolled back at a phase boundary"};
+    runtime_world* world = find(world_id);
+    if (!world) return {false, {}, "runtime world does not exist"};
+    if (!world->rollback_ || !world->rollback_->contains(tick))
+        return {false, {}, "rollback history does not hold the requested tick"};
+
+    try
+    {
+        ecs::world staged = world->rollback_->restore(tick);
+        world->entities_->swap(staged);
+        world->rollback_->truncate_after(tick);
+        world->last_completed_tick_ = tick;
+        ++world->epoch_;
+        world->fault_message_.clear();
+        if (world->state_ == runtime_world_state::faulted) world->state_ = runtime_world_state::paused;
+        return {true,
+                {.world = world_id,
+                 .tick = tick,
+                 .world_epoch = world->epoch_,
+                 .estimated_bytes = world->rollback_->bytes()},
+                {}};
+    }
+    catch (const std::exception& error)
+    {
+        return {false, {}, error.what()};
+    }
+}
+
 void runtime_world_manager::trim_snapshots()
 {
     if (snapshot_budget_bytes_ == 0)
@@ -469,7 +597,20 @@ void runtime_world_manager::trim_snapshots()
     }
     while (!snapshots_.empty() && snapshot_bytes_ > snapshot_budget_bytes_)
     {
-        snapshot_bytes_ -= snapshots_.front().metadata.estimated_bytes;
+        const stored_snapshot& oldest = snapshots_.front();
+        snapshot_bytes_ -= oldest.metadata.estimated_bytes;
+        // Pages the trimmed snapshot shared with its successor stay resident and are now charged to it.
+        const auto successor =
+            std::find_if(std::next(snapshots_.begin()), snapshots_.end(), [&oldest](const stored_snapshot& value)
+                         { return value.metadata.world == oldest.metadata.world; });
+        if (successor != snapshots_.end())
+        {
+            std::size_t resident = successor->entities.total_bytes();
+            for (const runtime_service_snapshot& service : successor->services)
+                resident += service.bytes.size();
+            snapshot_bytes_ += resident - successor->metadata.estimated_bytes;
+            successor->metadata.estimated_bytes = resident;
+        }
         snapshots_.pop_front();
     }
 }
@@ -622,6 +622,135 @@ TEST_CASE("runtime world snapshots restore state atomically")
     host.shutdown();
 }
 
+TEST_CASE("runtime snapshots charge only component pages changed since the previous capture")
+{
+    recording_application app;
+    arc::framework::application_config config{};
+    config.simulation.snapshot_budget_bytes = 64u * 1024u * 1024u;
+    arc::framework::runtime host(app, config);
+    arc::framework::runtime_world& world =
+        host.worlds().create({.name = "Incremental snapshots", .install_placeholder_systems = false});
+    std::vector<arc::ecs::entity> entities;
+    for (int index = 0; index < 10000; ++index)
+    {
+        entities.push_back(world.entities().create());
+        world.entities().emplace<counter_component>(entities.back(), counter_component{index});
+    }
+    host.start();
+
+    const arc::framework::world_snapshot_result first = host.capture_snapshot(world.id(), "first");
+    REQUIRE(first.succeeded);
+    world.entities().get<counter_component>(entities.front()).value = -1;
+    const arc::framework::world_snapshot_result second = host.capture_snapshot(world.id(), "second");
+    REQUIRE(second.succeeded);
+    REQUIRE(second.metadata.estimated_bytes * 2 < first.metadata.estimated_bytes);
+
+    // Trimming the first snapshot charges its shared pages to the survivor.
+    host.worlds().set_snapshot_budget(first.metadata.estimated_bytes + 1u);
+    const auto remaining = host.worlds().snapshots();
+    REQUIRE(remaining.size() == 1u);
+    REQUIRE(remaining.front().id == second.metadata.id);
+    REQUIRE(remaining.front().estimated_bytes >= first.metadata.estimated_bytes);
+
+    REQUIRE(host.restore_snapshot(second.metadata.id).succeeded);
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entities.front()).value == -1);
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entities.back()).value == 9999);
+    host.shutdown();
+}
+
+TEST_CASE("runtime worlds roll back to completed ticks held in their delta history")
+{
+    recording_application app;
+    arc::framework::application_config config{};
+    config.simulation.rollback_depth_ticks = 4;
+    arc::framework::runtime host(app, config);
+    arc::framework::runtime_world& world =
+        host.worlds().create({.name = "Rollback world", .install_placeholder_systems = false});
+    const arc::ecs::entity entity = world.entities().create();
+    world.entities().emplace<counter_component>(entity, counter_component{0});
+    REQUIRE(world.systems().add({.name = "Count ticks",
+                                 .phase = arc::ecs::system_phase::gameplay_commands,
+                                 .execute = [entity](arc::ecs::system_context& context)
+                                 {
+                                     context.commands().patch<counter_component>(
+                                         entity, [](counter_component& value) { ++value.value; });
+                                 }}));
+    host.start();
+    std::vector<arc::framework::simulation_tick_id> ticks;
+    for (int index = 0; index < 10; ++index)
+    {
+        REQUIRE(host.advance(1.0 / 60.0).completed_ticks == 1);
+        ticks.push_back(world.last_completed_tick());
+    }
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entity).value == 10);
+    REQUIRE_FALSE(host.worlds().rollback(world.id(), ticks.front()).succeeded);
+
+    const std::uint64_t epoch = world.epoch();
+    const arc::framework::world_snapshot_result rewound = host.worlds().rollback(world.id(), ticks[7]);
+    REQUIRE(rewound.succeeded);
+    REQUIRE(rewound.metadata.world_epoch == epoch + 1u);
+    REQUIRE(world.last_completed_tick() == ticks[7]);
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entity).value == 8);
+    REQUIRE_FALSE(host.worlds().rollback(world.id(), ticks[8]).succeeded);
+
+    // Ticks simulated after a rollback extend the truncated history.
+    REQUIRE(host.advance(1.0 / 60.0).completed_ticks == 1);
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entity).value == 9);
+    REQUIRE(host.worlds().rollback(world.id(), ticks[6]).succeeded);
+    REQUIRE(std::as_const(world.entities()).get<counter_component>(entity).value == 7);
+    host.shutdown();
+}
+
+TEST_CASE("isolated runtime worlds tick concurrently on their own arenas with ordered results")
+{
+    recording_application app;
+    arc::framework::runtime host(app);
+    std::vector<arc::framework::runtime_world*> worlds;
+    std::array<const void*, 5> tick_memory{};
+    std::array<int, 5> ticks{};
+    for (std::size_t index = 0; index < 5; ++index)
+    {
+        // The server world is not isolated, so it runs alone ahead of the four concurrent clients.
+        const bool isolated = index != 0;
+        const auto role =
+            isolated ? arc::framework::runtime_world_role::client : arc::framework::runtime_world_role::server;
+        worlds.push_back(&host.worlds().create({.name = "Match " + std::to_string(index),
+                                                .role = role,
+                                                .install_placeholder_systems = false,
+                                                .isolated = isolated}));
+        const auto record = [&tick_memory, &ticks, index](arc::ecs::system_context& context)
+        {
+            tick_memory[index] = context.tick_memory();
+            ++ticks[index];
+        };
+        REQUIRE(worlds.back()->systems().add(
+            {.name = "Tick", .phase = arc::ecs::system_phase::movement, .execute = record}));
+    }
+    host.start();
+    for (int frame = 0; frame < 3; ++frame)
+        REQUIRE(host.advance(1.0 / 60.0).completed_ticks == 1);
+
+    REQUIRE(ticks == std::array<int, 5>{3, 3, 3, 3, 3});
+    REQUIRE(tick_memory[0] == &host.tick_memory());
+    for (std::size_t index = 1; index < 5; ++index)
+    {
+        REQUIRE(tick_memory[index] != &host.tick_memory());
+        for (std::size_t other = index + 1; other < 5; ++other)
+            REQUIRE(tick_memory[index] != tick_memory[other]);
+    }
+
+    const auto& timings = host.worlds().last_fixed_timings();
+    const std::vector<arc::framework::runtime_world_id> order = host.worlds().ordered_worlds();
+    REQUIRE(timings.size() == order.size());
+    for (std::size_t index = 0; index < timings.size(); ++index)
+    {
+        REQUIRE(timings[index].world == order[index]);
+        REQUIRE(timings[index].systems_executed == 1u);
+        REQUIRE(timings[index].concurrent == (order[index] != worlds.front()->id()));
+    }
+    host.shutdown();
+}
+
 TEST_CASE("runtime snapshots include registered deterministic service state")
 {
     class snapshot_application final : public recording_application
@@ -6,6 +6,8 @@
 
 #include <arc/memory/memory.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -14,6 +16,9 @@
 #include <cstdint>
 #include <exception>
 #include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -46,6 +51,15 @@ enum class job_affinity : std::uint8_t
     io_thread
 };
 
+/** Placement request relative to the data a job's parent touched. */
+enum class job_locality : std::uint8_t
+{
+    any,
+    // Prefer workers sharing an L3 cache with the worker that ran the parent
+    // (or, without a parent, the submitting job).
+    near_parent
+};
+
 enum class job_status : std::uint8_t
 {
     invalid,
@@ -86,6 +100,87 @@ namespace detail
 struct cancellation_state;
 struct job_state;
 
+void retain(job_state* state) noexcept;
+void release(job_state* state) noexcept;
+
+/**
+ * Intrusive strong reference to a pooled job state. The count lives in the
+ * state itself, so copies cost one atomic and moves cost nothing.
+ */
+class job_state_ref
+{
+public:
+    job_state_ref() noexcept = default;
+
+    explicit job_state_ref(job_state* state) noexcept : state_(state)
+    {
+        if (state_) retain(state_);
+    }
+
+    /** Takes over a reference previously given up with detach(). */
+    [[nodiscard]] static job_state_ref adopt(job_state* state) noexcept
+    {
+        job_state_ref result;
+        result.state_ = state;
+        return result;
+    }
+
+    ~job_state_ref()
+    {
+        if (state_) release(state_);
+    }
+
+    job_state_ref(const job_state_ref& other) noexcept : job_state_ref(other.state_) {}
+
+    job_state_ref(job_state_ref&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+    job_state_ref& operator=(const job_state_ref& other) noexcept
+    {
+        job_state_ref(other).swap(*this);
+        return *this;
+    }
+
+    job_state_ref& operator=(job_state_ref&& other) noexcept
+    {
+        job_state_ref(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(job_state_ref& other) noexcept
+    {
+        std::swap(state_, other.state_);
+    }
+
+    /** Gives up ownership without releasing; pair with adopt(). */
+    [[nodiscard]] job_state* detach() noexcept
+    {
+        return std::exchange(state_, nullptr);
+    }
+
+    [[nodiscard]] job_state* get() const noexcept
+    {
+        return state_;
+    }
+
+    job_state* operator->() const noexcept
+    {
+        return state_;
+    }
+
+    job_state& operator*() const noexcept
+    {
+        return *state_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return state_ != nullptr;
+    }
+
+private:
+    job_state* state_{};
+};
+
 class task_callable
 {
 public:
@@ -259,7 +354,7 @@ public:
 #if defined(ARC_ENABLE_JOB_COROUTINES)
     struct awaiter
     {
-        std::shared_ptr<detail::job_state> state;
+        detail::job_state_ref state;
         [[nodiscard]] bool await_ready() const noexcept;
         void await_suspend(std::coroutine_handle<> continuation);
         void await_resume() const;
@@ -268,8 +363,8 @@ public:
 #endif
 
 private:
-    explicit job_handle(std::shared_ptr<detail::job_state> state) noexcept;
-    std::shared_ptr<detail::job_state> state_;
+    explicit job_handle(detail::job_state_ref state) noexcept;
+    detail::job_state_ref state_;
     friend class job_system;
     friend struct job_descriptor;
 };
@@ -284,6 +379,7 @@ struct job_descriptor
     job_handle parent;
     cancellation_token cancellation;
     job_dependency_policy dependency_policy{job_dependency_policy::cancel_on_failure};
+    job_locality locality{job_locality::any};
 };
 
 struct job_profile_event
@@ -299,6 +395,28 @@ struct job_profile_event
     std::uint64_t completed_nanoseconds{};
 };
 
+/** A general worker took a job queued for another worker or another L3 domain. */
+struct job_steal_event
+{
+    /** Victim value for jobs taken from another domain's near_parent injection queue. */
+    static constexpr std::uint32_t domain_queue = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint64_t sequence{};
+    std::uint64_t thread_id{};
+    std::uint32_t thief_worker{};
+    std::uint32_t victim_worker{domain_queue};
+    std::uint32_t victim_l3_domain{};
+    std::uint64_t timestamp_nanoseconds{};
+};
+
+/** A finished prerequisite releasing one of its dependents. */
+struct job_dependency_edge
+{
+    std::uint64_t prerequisite_sequence{};
+    std::uint64_t dependent_sequence{};
+    std::uint64_t released_nanoseconds{};
+};
+
 struct job_system_snapshot
 {
     std::uint64_t sequence{};
@@ -311,10 +429,39 @@ struct job_system_snapshot
     std::uint64_t submitted{};
     std::uint64_t completed{};
     std::uint64_t stolen{};
+    /** Steals split by whether the thief shares the victim's L3 cache; cross-NUMA steals are also cross-L3. */
+    std::uint64_t stolen_same_l3{};
+    std::uint64_t stolen_cross_l3{};
+    std::uint64_t stolen_cross_numa{};
     std::uint64_t cancelled{};
     std::uint64_t failed{};
+    /** Parked workers that were notified but found no work once awake. */
+    std::uint64_t spurious_wakeups{};
     std::uint64_t dropped_profile_events{};
+    /** Completed jobs, ordered by completion time within each flush. */
     std::vector<job_profile_event> recent_events;
+    std::vector<job_steal_event> recent_steals;
+    std::vector<job_dependency_edge> recent_dependencies;
+};
+
+/** Logical CPU and the cache and memory domains it shares with its neighbours. */
+struct cpu_info
+{
+    std::uint32_t id{};
+    std::uint32_t package{};
+    std::uint32_t l3_domain{};
+    std::uint32_t numa_node{};
+};
+
+/** CPU layout used to place workers and order steals. Domains are dense indices starting at zero. */
+struct cpu_topology
+{
+    std::vector<cpu_info> cpus;
+    std::size_t l3_domain_count{};
+    std::size_t numa_node_count{};
+
+    /** Reads /sys/devices/system/cpu on Linux; elsewhere reports one domain spanning every hardware thread. */
+    [[nodiscard]] static cpu_topology discover();
 };
 
 struct job_system_config
@@ -323,8 +470,16 @@ struct job_system_config
     bool run_inline{};
     std::size_t io_worker_count{2};
     bool enable_render_thread{true};
+    /** Events of each kind retained between snapshots; zero disables profiling. */
     std::size_t profile_event_capacity{8192};
     memory::memory_system* memory{};
+    /** Pins each general worker to the CPU it was placed on. */
+    bool pin_workers{};
+    /**
+     * Overrides discovery; workers fill L3 domains in order, wrapping when they outnumber CPUs. Domain and node ids
+     * are renumbered densely, so sparse ids or stale counts are accepted.
+     */
+    const cpu_topology* topology{};
 };
 
 template <class T> class [[nodiscard]] job_future
@@ -707,28 +862,54 @@ public:
 
     void wait_all(const std::vector<job_handle>& handles) const;
 
+    /**
+     * Invokes function(chunk_begin, chunk_end) over [begin, end) in chunks of at most grain_size. The calling thread
+     * works through the range itself and only splits off the upper half when an idle worker could take it, so an
+     * uncontended loop runs serially with no job submissions.
+     */
     template <class Function>
     void parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size, Function&& function)
     {
         if (begin >= end) return;
-        grain_size = std::max<std::size_t>(grain_size, 1);
-        std::vector<job_handle> handles;
-        handles.reserve((end - begin + grain_size - 1) / grain_size);
-        for (std::size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain_size)
+        const auto body = [&function](std::size_t chunk_begin, std::size_t chunk_end)
         {
-            const std::size_t chunk_end = std::min(end, chunk_begin + grain_size);
-            handles.push_back(submit({.name = "parallel_for",
-                                      .priority = job_priority::normal,
-                                      .affinity = job_affinity::any_worker,
-                                      .dependencies = {},
-                                      .dependency_view = {},
-                                      .parent = {},
-                                      .cancellation = {},
-                                      .dependency_policy = job_dependency_policy::cancel_on_failure},
-                                     [chunk_begin, chunk_end, &function]()
-                                     { std::invoke(function, chunk_begin, chunk_end); }));
-        }
-        wait_all(handles);
+            std::invoke(function, chunk_begin, chunk_end);
+            return range_unit{};
+        };
+        const auto combine = [](range_unit, range_unit) { return range_unit{}; };
+        const range_unit identity{};
+        const reduce_context<range_unit, decltype(body), decltype(combine)> context{
+            .name = "parallel_for",
+            .grain_size = std::max<std::size_t>(grain_size, 1),
+            .identity = identity,
+            .body = body,
+            .combine = combine};
+        (void)reduce_range(context, begin, end);
+    }
+
+    /**
+     * Folds body(chunk_begin, chunk_end) results with combine, splitting like parallel_for. Partial results are
+     * combined in index order, so combine must be associative but need not be commutative.
+     */
+    template <class T, class Body, class Combine>
+    [[nodiscard]] T parallel_reduce(std::size_t begin, std::size_t end, std::size_t grain_size, T identity, Body&& body,
+                                    Combine&& combine)
+    {
+        if (begin >= end) return identity;
+        const reduce_context<T, std::decay_t<Body>, std::decay_t<Combine>> context{
+            .name = "parallel_reduce",
+            .grain_size = std::max<std::size_t>(grain_size, 1),
+            .identity = identity,
+            .body = body,
+            .combine = combine};
+        return reduce_range(context, begin, end);
+    }
+
+    /** Quicksort that partitions only while workers are idle and otherwise falls back to std::sort. */
+    template <class RandomIt, class Compare = std::less<>>
+    void parallel_sort(RandomIt first, RandomIt last, Compare compare = {}, std::size_t grain_size = 2048)
+    {
+        sort_range(first, last, compare, std::max<std::size_t>(grain_size, 2));
     }
 
     std::size_t pump_main_thread(std::size_t maximum_jobs = static_cast<std::size_t>(-1));
@@ -740,19 +921,151 @@ public:
     void shutdown(job_shutdown_mode mode = job_shutdown_mode::drain);
     [[nodiscard]] std::size_t worker_count() const noexcept;
     [[nodiscard]] std::size_t io_worker_count() const noexcept;
+    [[nodiscard]] const cpu_topology& topology() const noexcept;
+    /** CPU the general worker was placed on; meaningful for scheduling even when workers are not pinned. */
+    [[nodiscard]] const cpu_info& worker_cpu(std::size_t worker_index) const;
     [[nodiscard]] bool run_inline() const noexcept;
+    /**
+     * Moves events recorded by each executor since the last flush into the retained history.
+     * Call once per frame; rings that fill up between flushes drop their newest events.
+     */
+    void flush_profile_events() const;
     [[nodiscard]] job_system_snapshot snapshot(bool consume_events = false) const;
 
 private:
+    /** Ranges split at most once per level, so 64 levels cover any size_t range. */
+    static constexpr std::size_t max_range_splits = 64;
+
+    struct range_unit
+    {
+    };
+
+    static job_descriptor range_job(std::string_view name) noexcept
+    {
+        return {.name = name,
+                .priority = job_priority::normal,
+                .affinity = job_affinity::any_worker,
+                .dependencies = {},
+                .dependency_view = {},
+                .parent = {},
+                .cancellation = {},
+                .dependency_policy = job_dependency_policy::cancel_on_failure};
+    }
+
+    /** True when an idle worker exists and the caller has nothing queued that it could take instead. */
+    [[nodiscard]] bool range_split_wanted() const noexcept;
+
+    /** Joins spawned range jobs newest first, keeping the first failure, since they all reference this frame. */
+    template <class OnSuccess>
+    static void join_range_jobs(std::span<job_handle> spawned, std::exception_ptr& failure, OnSuccess&& on_success)
+    {
+        for (std::size_t index = spawned.size(); index-- > 0;)
+        {
+            const auto result = spawned[index].wait_result();
+            if (!failure && result.exception) failure = result.exception;
+            if (!failure && result.status == job_status::cancelled) failure = std::make_exception_ptr(job_cancelled());
+            if (!failure && result.succeeded()) on_success(index);
+        }
+    }
+
+    /** Shared by every split of one parallel_reduce so spawned closures stay within the inline task storage. */
+    template <class T, class Body, class Combine> struct reduce_context
+    {
+        std::string_view name;
+        std::size_t grain_size{};
+        const T& identity;
+        const Body& body;
+        const Combine& combine;
+    };
+
+    template <class T, class Body, class Combine>
+    T reduce_range(const reduce_context<T, Body, Combine>& context, std::size_t begin, std::size_t end)
+    {
+        std::array<job_handle, max_range_splits> spawned;
+        std::array<std::optional<T>, max_range_splits> partials;
+        std::size_t split_count{};
+        std::optional<T> value(context.identity);
+        std::exception_ptr failure;
+        try
+        {
+            while (end - begin > context.grain_size)
+            {
+                if (split_count < max_range_splits && range_split_wanted())
+                {
+                    const std::size_t middle = begin + (end - begin) / 2;
+                    auto* partial = &partials[split_count];
+                    spawned[split_count++] =
+                        submit(range_job(context.name), [this, &context, middle, end, partial]
+                               { partial->emplace(reduce_range(context, middle, end)); });
+                    end = middle;
+                    continue;
+                }
+                value.emplace(context.combine(std::move(*value), context.body(begin, begin + context.grain_size)));
+                begin += context.grain_size;
+            }
+            value.emplace(context.combine(std::move(*value), context.body(begin, end)));
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        join_range_jobs(std::span(spawned.data(), split_count), failure, [&](std::size_t index)
+                        { value.emplace(context.combine(std::move(*value), std::move(*partials[index]))); });
+        if (failure) std::rethrow_exception(failure);
+        return std::move(*value);
+    }
+
+    template <class RandomIt, class Compare>
+    void sort_range(RandomIt first, RandomIt last, const Compare& compare, std::size_t grain_size)
+    {
+        std::array<job_handle, max_range_splits> spawned;
+        std::size_t split_count{};
+        std::exception_ptr failure;
+        try
+        {
+            while (static_cast<std::size_t>(last - first) > grain_size && split_count < max_range_splits &&
+                   range_split_wanted())
+            {
+                // Three-way partition around a median-of-three pivot; equal keys are already in place.
+                auto middle = first + (last - first) / 2;
+                auto back = std::prev(last);
+                if (compare(*middle, *first)) std::iter_swap(middle, first);
+                if (compare(*back, *middle)) std::iter_swap(back, middle);
+                if (compare(*middle, *first)) std::iter_swap(middle, first);
+                const auto pivot = *middle;
+                const auto below = [&](const auto& value) { return compare(value, pivot); };
+                const auto not_above = [&](const auto& value) { return !compare(pivot, value); };
+                const auto lower = std::partition(first, last, below);
+                const auto upper = std::partition(lower, last, not_above);
+                spawned[split_count++] = submit(range_job("parallel_sort"), [this, upper, last, &compare, grain_size]
+                                                { sort_range(upper, last, compare, grain_size); });
+                last = lower;
+            }
+            std::sort(first, last, compare);
+        }
+        catch (...)
+        {
+            failure = std::current_exception();
+        }
+        join_range_jobs(std::span(spawned.data(), split_count), failure, [](std::size_t) {});
+        if (failure) std::rethrow_exception(failure);
+    }
+
     job_handle submit_erased(job_descriptor descriptor, detail::task_callable function, bool detached);
-    job_wait_result wait_for(const std::shared_ptr<detail::job_state>& state) const noexcept;
-    void add_coroutine_continuation(const std::shared_ptr<detail::job_state>& state,
-                                    std::coroutine_handle<> continuation);
+    job_wait_result wait_for(const detail::job_state_ref& state) const noexcept;
+    void add_coroutine_continuation(const detail::job_state_ref& state, std::coroutine_handle<> continuation);
 
     std::unique_ptr<implementation> implementation_;
     friend class job_handle;
 };
 
+/**
+ * Writes the snapshot's events as Chrome trace event JSON, readable by chrome://tracing and Perfetto.
+ * Jobs become slices on their executing thread, queue latency an async span per job, dependency edges
+ * flow arrows and steals instant events on the thief's thread.
+ */
+void write_chrome_trace(std::ostream& output, const job_system_snapshot& snapshot);
+
 template <class Function> [[nodiscard]] job_handle submit(job_system& jobs, Function&& function)
 {
     return jobs.submit(std::forward<Function>(function));
@@ -766,4 +1079,19 @@ void parallel_for(job_system& jobs, std::size_t begin, std::size_t end, std::siz
     jobs.parallel_for(begin, end, grain_size, std::forward<Function>(function));
 }
 
+template <class T, class Body, class Combine>
+[[nodiscard]] T parallel_reduce(job_system& jobs, std::size_t begin, std::size_t end, std::size_t grain_size,
+                                T identity, Body&& body, Combine&& combine)
+{
+    return jobs.parallel_reduce(begin, end, grain_size, std::move(identity), std::forward<Body>(body),
+                                std::forward<Combine>(combine));
+}
+
+template <class RandomIt, class Compare = std::less<>>
+void parallel_sort(job_system& jobs, RandomIt first, RandomIt last, Compare compare = {},
+                   std::size_t grain_size = 2048)
+{
+    jobs.parallel_sort(first, last, std::move(compare), grain_size);
+}
+
 } // namespace arc::jobs
@@ -0,0 +1,294 @@
+#include <arc/jobs/jobs.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace arc::jobs
+{
+namespace
+{
+
+const char* priority_name(job_priority value) noexcept
+{
+    switch (value)
+    {
+        case job_priority::critical:
+            return "critical";
+        case job_priority::high:
+            return "high";
+        case job_priority::normal:
+            return "normal";
+        case job_priority::low:
+            return "low";
+        case job_priority::background:
+            return "background";
+        case job_priority::count:
+            break;
+    }
+    return "unknown";
+}
+
+const char* affinity_name(job_affinity value) noexcept
+{
+    switch (value)
+    {
+        case job_affinity::any_worker:
+            return "any_worker";
+        case job_affinity::main_thread:
+            return "main_thread";
+        case job_affinity::render_thread:
+            return "render_thread";
+        case job_affinity::io_thread:
+            return "io_thread";
+    }
+    return "unknown";
+}
+
+const char* status_name(job_status value) noexcept
+{
+    switch (value)
+    {
+        case job_status::invalid:
+            return "invalid";
+        case job_status::waiting_dependencies:
+            return "waiting_dependencies";
+        case job_status::queued:
+            return "queued";
+        case job_status::running:
+            return "running";
+        case job_status::waiting_children:
+            return "waiting_children";
+        case job_status::succeeded:
+            return "succeeded";
+        case job_status::failed:
+            return "failed";
+        case job_status::cancelled:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+/** Streams trace events, keeping timestamps exact by printing nanoseconds as fixed-point microseconds. */
+class trace_writer
+{
+public:
+    trace_writer(std::ostream& output, std::uint64_t origin) : output_(output), origin_(origin) {}
+
+    void begin_event(std::string_view phase, std::string_view name, std::string_view category, std::size_t thread,
+                     std::uint64_t timestamp)
+    {
+        output_ << (first_ ? "\n" : ",\n") << "{\"ph\":\"" << phase << "\",\"name\":";
+        first_ = false;
+        write_string(name);
+        output_ << ",\"cat\":\"" << category << "\",\"pid\":1,\"tid\":" << thread << ",\"ts\":";
+        write_microseconds(timestamp - std::min(timestamp, origin_));
+    }
+
+    void field(std::string_view key, std::uint64_t value)
+    {
+        output_ << ",\"" << key << "\":" << value;
+    }
+
+    void field(std::string_view key, std::string_view value)
+    {
+        output_ << ",\"" << key << "\":";
+        write_string(value);
+    }
+
+    void duration(std::uint64_t nanoseconds)
+    {
+        output_ << ",\"dur\":";
+        write_microseconds(nanoseconds);
+    }
+
+    void begin_args()
+    {
+        output_ << ",\"args\":{";
+        first_arg_ = true;
+    }
+
+    void arg(std::string_view key, std::uint64_t value)
+    {
+        output_ << (first_arg_ ? "\"" : ",\"") << key << "\":" << value;
+        first_arg_ = false;
+    }
+
+    void arg(std::string_view key, std::string_view value)
+    {
+        output_ << (first_arg_ ? "\"" : ",\"") << key << "\":";
+        write_string(value);
+        first_arg_ = false;
+    }
+
+    void end_args()
+    {
+        output_ << '}';
+    }
+
+    void end_event()
+    {
+        output_ << '}';
+    }
+
+private:
+    void write_microseconds(std::uint64_t nanoseconds)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%llu.%03u", static_cast<unsigned long long>(nanoseconds / 1000),
+                      static_cast<unsigned>(nanoseconds % 1000));
+        output_ << buffer;
+    }
+
+    void write_string(std::string_view value)
+    {
+        output_ << '"';
+        for (const char character : value)
+        {
+            const auto code = static_cast<unsigned char>(character);
+            if (character == '"' || character == '\\')
+            {
+                output_ << '\\' << character;
+            }
+            else if (code < 0x20)
+            {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(code));
+                output_ << escaped;
+            }
+            else
+            {
+                output_ << character;
+            }
+        }
+        output_ << '"';
+    }
+
+    std::ostream& output_;
+    std::uint64_t origin_{};
+    bool first_{true};
+    bool first_arg_{};
+};
+
+} // namespace
+
+void write_chrome_trace(std::ostream& output, const job_system_snapshot& snapshot)
+{
+    // Timestamps are relative to the earliest event so microsecond values stay exact as doubles.
+    std::uint64_t origin = std::numeric_limits<std::uint64_t>::max();
+    const auto observe = [&origin](std::uint64_t timestamp)
+    {
+        if (timestamp != 0) origin = std::min(origin, timestamp);
+    };
+    for (const auto& event : snapshot.recent_events)
+    {
+        observe(event.queued_nanoseconds);
+        observe(event.started_nanoseconds);
+        observe(event.completed_nanoseconds);
+    }
+    for (const auto& steal : snapshot.recent_steals)
+        observe(steal.timestamp_nanoseconds);
+    if (origin == std::numeric_limits<std::uint64_t>::max()) origin = 0;
+
+    // Thread ids are hashes; trace viewers want small track numbers.
+    std::unordered_map<std::uint64_t, std::size_t> tracks;
+    const auto track = [&tracks](std::uint64_t thread_id)
+    { return tracks.try_emplace(thread_id, tracks.size() + 1).first->second; };
+    std::unordered_map<std::uint64_t, const job_profile_event*> by_sequence;
+    for (const auto& event : snapshot.recent_events)
+        by_sequence.emplace(event.sequence, &event);
+
+    trace_writer writer(output, origin);
+    output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    writer.begin_event("M", "process_name", "__metadata", 0, origin);
+    writer.begin_args();
+    writer.arg("name", "arc jobs");
+    writer.end_args();
+    writer.end_event();
+
+    for (const auto& event : snapshot.recent_events)
+    {
+        const auto thread = track(event.thread_id);
+        if (event.started_nanoseconds == 0)
+        {
+            // Cancelled before it ran; mark where it was retired.
+            writer.begin_event("i", event.name, "job", thread, event.completed_nanoseconds);
+            writer.field("s", "t");
+        }
+        else
+        {
+            writer.begin_event("X", event.name, "job", thread, event.started_nanoseconds);
+            writer.duration(event.completed_nanoseconds - std::min(event.completed_nanoseconds,
+                                                                   event.started_nanoseconds));
+        }
+        writer.begin_args();
+        writer.arg("sequence", event.sequence);
+        writer.arg("priority", priority_name(event.priority));
+        writer.arg("affinity", affinity_name(event.affinity));
+        writer.arg("status", status_name(event.status));
+        if (event.started_nanoseconds >= event.queued_nanoseconds && event.queued_nanoseconds != 0)
+            writer.arg("queued_nanoseconds", event.started_nanoseconds - event.queued_nanoseconds);
+        writer.end_args();
+        writer.end_event();
+
+        if (event.queued_nanoseconds == 0 || event.started_nanoseconds < event.queued_nanoseconds) continue;
+        writer.begin_event("b", event.name, "queue", thread, event.queued_nanoseconds);
+        writer.field("id", event.sequence);
+        writer.end_event();
+        writer.begin_event("e", event.name, "queue", thread, event.started_nanoseconds);
+        writer.field("id", event.sequence);
+        writer.end_event();
+    }
+
+    std::uint64_t flow_id{};
+    for (const auto& edge : snapshot.recent_dependencies)
+    {
+        const auto prerequisite = by_sequence.find(edge.prerequisite_sequence);
+        const auto dependent = by_sequence.find(edge.dependent_sequence);
+        if (prerequisite == by_sequence.end() || dependent == by_sequence.end()) continue;
+        const auto& from = *prerequisite->second;
+        const auto& to = *dependent->second;
+        if (from.started_nanoseconds == 0 || to.started_nanoseconds == 0) continue;
+        ++flow_id;
+        // Flow ends bind to the slice enclosing their timestamp, so anchor both at slice starts.
+        writer.begin_event("s", "dependency", "dependency", track(from.thread_id), from.started_nanoseconds);
+        writer.field("id", flow_id);
+        writer.end_event();
+        writer.begin_event("f", "dependency", "dependency", track(to.thread_id), to.started_nanoseconds);
+        writer.field("id", flow_id);
+        writer.field("bp", "e");
+        writer.end_event();
+    }
+
+    for (const auto& steal : snapshot.recent_steals)
+    {
+        writer.begin_event("i", "steal", "steal", track(steal.thread_id), steal.timestamp_nanoseconds);
+        writer.field("s", "t");
+        writer.begin_args();
+        writer.arg("sequence", steal.sequence);
+        writer.arg("thief_worker", steal.thief_worker);
+        if (steal.victim_worker == job_steal_event::domain_queue)
+            writer.arg("victim", "domain_queue");
+        else
+            writer.arg("victim_worker", steal.victim_worker);
+        writer.arg("victim_l3_domain", steal.victim_l3_domain);
+        writer.end_args();
+        writer.end_event();
+    }
+
+    for (std::size_t thread = 1; thread <= tracks.size(); ++thread)
+    {
+        writer.begin_event("M", "thread_name", "__metadata", thread, origin);
+        writer.begin_args();
+        writer.arg("name", "jobs thread " + std::to_string(thread));
+        writer.end_args();
+        writer.end_event();
+    }
+    output << "\n]}\n";
+}
+
+} // namespace arc::jobs
@@ -3,11 +3,30 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
+#include <cstdlib>
 #include <deque>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <map>
 #include <random>
 #include <thread>
+#include <tuple>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace arc::jobs
 {
@@ -16,6 +35,9 @@ namespace
 
 constexpr std::size_t priority_count = static_cast<std::size_t>(job_priority::count);
 constexpr std::size_t fairness_quota = 8;
+constexpr std::size_t idle_spin_count = 64;
+constexpr std::uint32_t no_domain = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t no_worker = std::numeric_limits<std::uint32_t>::max();
 using clock_type = std::chrono::steady_clock;
 
 std::uint64_t now_nanoseconds() noexcept
@@ -37,7 +59,143 @@ struct thread_worker_context
 };
 
 thread_local thread_worker_context worker_context{};
-thread_local std::weak_ptr<detail::job_state> current_job_state;
+thread_local detail::job_state* current_job_state{};
+
+constexpr std::uint32_t completion_done = 1;
+constexpr std::uint32_t completion_sleeping = 2;
+
+/** Sleeps while word still holds expected, until woken or the timeout elapses. */
+void wait_on_word(std::atomic_uint32_t& word, std::uint32_t expected, std::chrono::microseconds timeout) noexcept
+{
+#if defined(_WIN32)
+    const auto milliseconds = std::max<std::chrono::milliseconds::rep>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count(), 1);
+    WaitOnAddress(&word, &expected, sizeof(expected), static_cast<DWORD>(milliseconds));
+#elif defined(__linux__)
+    const auto count = timeout.count();
+    timespec remaining{.tv_sec = static_cast<time_t>(count / 1000000),
+                       .tv_nsec = static_cast<long>(count % 1000000) * 1000};
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &remaining, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected)
+        std::this_thread::sleep_for(std::min(timeout, std::chrono::microseconds(100)));
+#endif
+}
+
+void wake_word(std::atomic_uint32_t& word) noexcept
+{
+#if defined(_WIN32)
+    WakeByAddressAll(&word);
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, std::numeric_limits<int>::max(),
+            nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+#if defined(__linux__)
+std::string read_first_line(const std::filesystem::path& path)
+{
+    std::ifstream stream(path);
+    std::string line;
+    std::getline(stream, line);
+    return line;
+}
+
+std::vector<std::filesystem::path> list_directory(const std::filesystem::path& path)
+{
+    std::vector<std::filesystem::path> result;
+    std::error_code error;
+    for (std::filesystem::directory_iterator entry(path, error), end; !error && entry != end; entry.increment(error))
+        result.push_back(entry->path());
+    return result;
+}
+
+std::optional<std::uint32_t> numbered_entry(std::string_view name, std::string_view prefix)
+{
+    if (name.size() <= prefix.size() || name.substr(0, prefix.size()) != prefix) return std::nullopt;
+    std::uint32_t value{};
+    for (const char character : name.substr(prefix.size()))
+    {
+        if (character < '0' || character > '9') return std::nullopt;
+        value = value * 10 + static_cast<std::uint32_t>(character - '0');
+    }
+    return value;
+}
+
+/** CPUs are grouped by the shared_cpu_list of their L3 cache, falling back to the package without one. */
+cpu_topology discover_linux_topology()
+{
+    struct raw_cpu
+    {
+        std::uint32_t id{};
+        std::uint32_t package{};
+        std::string l3_key;
+        std::uint32_t numa_node{};
+    };
+
+    std::vector<raw_cpu> raw;
+    for (const auto& entry : list_directory("/sys/devices/system/cpu"))
+    {
+        const auto id = numbered_entry(entry.filename().string(), "cpu");
+        if (!id) continue;
+        // Offline CPUs expose no topology directory.
+        const auto package = read_first_line(entry / "topology" / "physical_package_id");
+        if (package.empty()) continue;
+
+        raw_cpu cpu{.id = *id, .package = 0, .l3_key = {}, .numa_node = 0};
+        cpu.package = static_cast<std::uint32_t>(std::strtoul(package.c_str(), nullptr, 10));
+        for (const auto& cache : list_directory(entry / "cache"))
+        {
+            if (read_first_line(cache / "level") != "3") continue;
+            cpu.l3_key = read_first_line(cache / "shared_cpu_list");
+            break;
+        }
+        if (cpu.l3_key.empty()) cpu.l3_key = "package " + package;
+        for (const auto& node : list_directory(entry))
+        {
+            if (const auto numa_node = numbered_entry(node.filename().string(), "node"))
+            {
+                cpu.numa_node = *numa_node;
+                break;
+            }
+        }
+        raw.push_back(std::move(cpu));
+    }
+    std::sort(raw.begin(), raw.end(), [](const raw_cpu& left, const raw_cpu& right) { return left.id < right.id; });
+
+    cpu_topology result;
+    std::map<std::string, std::uint32_t> l3_domains;
+    std::map<std::uint32_t, std::uint32_t> numa_nodes;
+    for (const auto& cpu : raw)
+    {
+        const auto l3_count = static_cast<std::uint32_t>(l3_domains.size());
+        const auto node_count = static_cast<std::uint32_t>(numa_nodes.size());
+        const auto l3 = l3_domains.emplace(cpu.l3_key, l3_count).first->second;
+        const auto node = numa_nodes.emplace(cpu.numa_node, node_count).first->second;
+        result.cpus.push_back({.id = cpu.id, .package = cpu.package, .l3_domain = l3, .numa_node = node});
+    }
+    result.l3_domain_count = l3_domains.size();
+    result.numa_node_count = numa_nodes.size();
+    return result;
+}
+#endif
+
+void pin_current_thread(std::uint32_t cpu) noexcept
+{
+#if defined(_WIN32)
+    if (cpu < 64) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu);
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
 
 } // namespace
 
@@ -49,8 +207,22 @@ struct cancellation_state
     std::atomic_bool cancelled{};
 };
 
+/** Entry on a job's waiter list: either a dependent job or a suspended coroutine. */
+struct job_link
+{
+    job_link* next{};
+    job_state* dependent{};
+    std::coroutine_handle<> continuation;
+};
+
+struct job_state_cache;
+
 struct job_state
 {
+    std::atomic_uint32_t references{};
+    // completion_done once the job is complete; completion_sleeping while a
+    // waiter may be blocked on the word and the completer must wake it.
+    std::atomic_uint32_t completion{};
     job_system* scheduler{};
     std::string name;
     job_priority priority{job_priority::normal};
@@ -58,7 +230,7 @@ struct job_state
     job_dependency_policy dependency_policy{job_dependency_policy::cancel_on_failure};
     cancellation_token cancellation;
     task_callable function;
-    std::weak_ptr<job_state> parent;
+    job_state_ref parent;
     std::atomic_size_t unfinished{1};
     // Submission owns one sentinel count until every prerequisite is
     // registered, preventing early prerequisites from releasing the task.
@@ -66,28 +238,551 @@ struct job_state
     std::atomic_bool dependency_failed{};
     std::atomic<job_status> status{job_status::waiting_dependencies};
     std::exception_ptr exception;
-    mutable std::mutex mutex;
-    std::condition_variable completion;
-    std::vector<std::shared_ptr<job_state>> dependents;
-    std::vector<std::coroutine_handle<>> continuations;
+    // Dependents and continuations push themselves lock-free; completion
+    // swaps in a closed marker so late arrivals see the job as finished.
+    std::atomic<job_link*> waiters{};
+    // Links this job threads onto its prerequisites' waiter lists. Sized once
+    // per submission and kept across reuse so steady state never allocates.
+    std::vector<job_link> links;
     bool detached{};
     std::uint64_t sequence{};
     std::uint64_t queued_time{};
     std::uint64_t started_time{};
     std::uint64_t completed_time{};
     std::uint64_t execution_thread{};
+    // General worker that ran the job, and the L3 domain a near_parent job asked for.
+    std::uint32_t execution_worker{no_worker};
+    std::uint32_t preferred_l3{no_domain};
+    job_state_cache* home{};
+    job_state* next_free{};
+
+    void reset() noexcept
+    {
+        completion.store(0, std::memory_order_relaxed);
+        scheduler = nullptr;
+        name.clear();
+        priority = job_priority::normal;
+        affinity = job_affinity::any_worker;
+        dependency_policy = job_dependency_policy::cancel_on_failure;
+        cancellation = {};
+        function = {};
+        parent = {};
+        unfinished.store(1, std::memory_order_relaxed);
+        pending_dependencies.store(1, std::memory_order_relaxed);
+        dependency_failed.store(false, std::memory_order_relaxed);
+        status.store(job_status::waiting_dependencies, std::memory_order_relaxed);
+        exception = nullptr;
+        waiters.store(nullptr, std::memory_order_relaxed);
+        links.clear();
+        detached = false;
+        sequence = 0;
+        queued_time = 0;
+        started_time = 0;
+        completed_time = 0;
+        execution_thread = 0;
+        execution_worker = no_worker;
+        preferred_l3 = no_domain;
+    }
+};
+
+class job_state_pool;
+
+/** Free lists owned by one worker, or shared by every non-worker thread under the pool mutex. */
+struct job_state_cache
+{
+    job_state_pool* pool{};
+    job_state* available{};
+    // States released on other threads come home here; the owner takes the
+    // whole list at once, so pushes never race a pop and ABA cannot occur.
+    alignas(64) std::atomic<job_state*> returned{};
 };
 
+/**
+ * Slab allocator for job states. States are constructed once per slab and
+ * recycled in place, keeping their name and link capacity. The pool outlives
+ * its job_system while any handle still references one of its states.
+ */
+class job_state_pool
+{
+public:
+    job_state_pool(memory::memory_system& memory, std::size_t worker_count)
+        : backing_(memory, memory::memory_domain::jobs, memory::make_memory_tag("jobs.state")),
+          caches_(worker_count + 1)
+    {
+        for (auto& cache : caches_)
+            cache.pool = this;
+    }
+
+    ~job_state_pool()
+    {
+        for (job_state* slab : slabs_)
+        {
+            for (std::size_t index = 0; index < slab_states; ++index)
+                slab[index].~job_state();
+            backing_.deallocate(slab, sizeof(job_state) * slab_states, alignof(job_state));
+        }
+    }
+
+    job_state_pool(const job_state_pool&) = delete;
+    job_state_pool& operator=(const job_state_pool&) = delete;
+
+    /** worker_index selects the calling worker's cache; anything else uses the shared cache. */
+    job_state* acquire(std::size_t worker_index)
+    {
+        job_state* state{};
+        if (worker_index < caches_.size() - 1)
+        {
+            state = take(caches_[worker_index]);
+        }
+        else
+        {
+            std::lock_guard lock(shared_mutex_);
+            state = take(caches_.back());
+        }
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        return state;
+    }
+
+    static void recycle(job_state* state) noexcept
+    {
+        job_state_cache& home = *state->home;
+        job_state_pool* pool = home.pool;
+        job_state* head = home.returned.load(std::memory_order_relaxed);
+        do
+        {
+            state->next_free = head;
+        } while (!home.returned.compare_exchange_weak(head, state, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+        pool->release_reference();
+    }
+
+    /** Drops the owning job_system's reference or one recycled state's. */
+    void release_reference() noexcept
+    {
+        if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+    }
+
+private:
+    static constexpr std::size_t slab_states = 64;
+
+    job_state* take(job_state_cache& cache)
+    {
+        if (!cache.available) cache.available = cache.returned.exchange(nullptr, std::memory_order_acquire);
+        if (!cache.available) grow(cache);
+        job_state* state = cache.available;
+        cache.available = state->next_free;
+        state->next_free = nullptr;
+        return state;
+    }
+
+    void grow(job_state_cache& cache)
+    {
+        std::lock_guard lock(slabs_mutex_);
+        slabs_.reserve(slabs_.size() + 1);
+        auto* slab = static_cast<job_state*>(backing_.allocate(sizeof(job_state) * slab_states, alignof(job_state)));
+        for (std::size_t index = 0; index < slab_states; ++index)
+        {
+            auto* state = new (slab + index) job_state();
+            state->home = &cache;
+            state->next_free = index + 1 < slab_states ? slab + index + 1 : nullptr;
+        }
+        slabs_.push_back(slab);
+        cache.available = slab;
+    }
+
+    memory::system_memory_resource backing_;
+    std::vector<job_state_cache> caches_;
+    std::mutex shared_mutex_;
+    std::mutex slabs_mutex_;
+    std::vector<job_state*> slabs_;
+    // One count for the owning job_system plus one per state handed out.
+    std::atomic_size_t outstanding_{1};
+};
+
+void retain(job_state* state) noexcept
+{
+    state->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void release(job_state* state) noexcept
+{
+    if (state->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    state->reset();
+    job_state_pool::recycle(state);
+}
+
 } // namespace detail
 
+namespace
+{
+
+/**
+ * Chase-Lev work-stealing deque using the weak-memory-model formulation of
+ * Le et al. The owning worker pushes and takes at the bottom without locking;
+ * thieves take from the top with a single compare-exchange. Retired rings stay
+ * alive until the deque is destroyed so a racing thief never reads freed slots.
+ */
+class work_stealing_deque
+{
+public:
+    work_stealing_deque()
+    {
+        rings_.push_back(std::make_unique<ring>(initial_capacity));
+        ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    /** Owner only. */
+    void push(detail::job_state* state)
+    {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        ring* values = ring_.load(std::memory_order_relaxed);
+        if (bottom - top > values->mask)
+        {
+            rings_.push_back(values->grow(top, bottom));
+            values = rings_.back().get();
+            ring_.store(values, std::memory_order_release);
+        }
+        values->store(bottom, state);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    /** Owner only; LIFO so recently spawned work runs while its data is still cached. */
+    detail::job_state* pop() noexcept
+    {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        ring* values = ring_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = top_.load(std::memory_order_relaxed);
+        if (top > bottom)
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        detail::job_state* result = values->load(bottom);
+        if (top == bottom)
+        {
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                result = nullptr;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    /** Any thread; FIFO so thieves take the oldest, typically largest, work. */
+    detail::job_state* steal() noexcept
+    {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) return nullptr;
+        detail::job_state* result = ring_.load(std::memory_order_acquire)->load(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return result;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+    }
+
+private:
+    static constexpr std::int64_t initial_capacity = 256;
+
+    struct ring
+    {
+        explicit ring(std::int64_t capacity)
+            : mask(capacity - 1),
+              slots(std::make_unique<std::atomic<detail::job_state*>[]>(static_cast<std::size_t>(capacity)))
+        {
+        }
+
+        void store(std::int64_t index, detail::job_state* state) noexcept
+        {
+            slots[static_cast<std::size_t>(index & mask)].store(state, std::memory_order_relaxed);
+        }
+
+        detail::job_state* load(std::int64_t index) const noexcept
+        {
+            return slots[static_cast<std::size_t>(index & mask)].load(std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<ring> grow(std::int64_t top, std::int64_t bottom) const
+        {
+            auto result = std::make_unique<ring>((mask + 1) * 2);
+            for (std::int64_t index = top; index < bottom; ++index)
+                result->store(index, load(index));
+            return result;
+        }
+
+        std::int64_t mask{};
+        std::unique_ptr<std::atomic<detail::job_state*>[]> slots;
+    };
+
+    alignas(64) std::atomic<std::int64_t> top_{};
+    alignas(64) std::atomic<std::int64_t> bottom_{};
+    std::atomic<ring*> ring_{};
+    std::vector<std::unique_ptr<ring>> rings_;
+};
+
+/**
+ * Idle threads of one executor. Each thread parks on its own futex word, and
+ * producers wake exactly one parked thread per new job instead of broadcasting.
+ * Producers skip the lock entirely while nobody is parked.
+ */
+class parking_lot
+{
+public:
+    explicit parking_lot(std::size_t count)
+    {
+        slots_.reserve(count);
+        parked_.reserve(count);
+        for (std::size_t index = 0; index < count; ++index)
+            slots_.push_back(std::make_unique<slot>());
+    }
+
+    /**
+     * Parks the calling thread unless ready() reports work after registration.
+     * Returns true when a notification woke the thread.
+     */
+    template <class Ready> bool park(std::size_t index, const Ready& ready)
+    {
+        slot& self = *slots_[index];
+        {
+            std::lock_guard lock(mutex_);
+            self.state.store(slot_parked, std::memory_order_relaxed);
+            parked_.push_back(index);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Pairs with the fence in wake(): either the producer sees this thread
+        // parked, or this thread sees the producer's job in ready().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) wait_on_word(self.state, slot_parked, park_timeout);
+        return unpark(index);
+    }
+
+    /** Wakes up to count parked threads, most recently parked first since their caches are warmest. */
+    void wake(std::size_t count = 1)
+    {
+        for (; count != 0; --count)
+            if (!wake_preferring([](std::size_t) { return true; })) return;
+    }
+
+    /** Wakes one parked thread, choosing one that satisfies prefer(index) when any does. */
+    template <class Prefer> bool wake_preferring(const Prefer& prefer)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return false;
+        slot* target{};
+        {
+            std::lock_guard lock(mutex_);
+            if (parked_.empty()) return false;
+            auto chosen = std::find_if(parked_.rbegin(), parked_.rend(), prefer);
+            if (chosen == parked_.rend()) chosen = parked_.rbegin();
+            target = slots_[*chosen].get();
+            parked_.erase(std::next(chosen).base());
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            target->state.store(slot_notified, std::memory_order_release);
+        }
+        wake_word(target->state);
+        return true;
+    }
+
+    void wake_all()
+    {
+        wake(slots_.size());
+    }
+
+private:
+    static constexpr std::uint32_t slot_running = 0;
+    static constexpr std::uint32_t slot_parked = 1;
+    static constexpr std::uint32_t slot_notified = 2;
+    // Parked threads re-check their queues this often even without a notification.
+    static constexpr std::chrono::milliseconds park_timeout{50};
+
+    struct slot
+    {
+        alignas(64) std::atomic_uint32_t state{slot_running};
+    };
+
+    bool unpark(std::size_t index)
+    {
+        slot& self = *slots_[index];
+        std::lock_guard lock(mutex_);
+        if (self.state.load(std::memory_order_acquire) == slot_notified)
+        {
+            self.state.store(slot_running, std::memory_order_relaxed);
+            return true;
+        }
+        // Still registered: the wait timed out, returned early, or work was already visible.
+        parked_.erase(std::find(parked_.begin(), parked_.end(), index));
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        self.state.store(slot_running, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::vector<std::unique_ptr<slot>> slots_;
+    std::mutex mutex_;
+    std::vector<std::size_t> parked_;
+    std::atomic_size_t sleepers_{};
+};
+
+/**
+ * Bounded single-producer ring of profiling events. The owning executor fills
+ * slots in place, reusing their storage, and the collector copies them out at
+ * frame boundaries. A full ring rejects the event instead of blocking.
+ */
+template <class Event> class profile_ring
+{
+public:
+    explicit profile_ring(std::size_t capacity)
+        : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 2))), mask_(slots_.size() - 1)
+    {
+    }
+
+    template <class Fill> bool push(const Fill& fill)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots_.size()) return false;
+        fill(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <class Sink> void drain(const Sink& sink)
+    {
+        const auto head = head_.load(std::memory_order_acquire);
+        auto tail = tail_.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail)
+            sink(slots_[tail & mask_]);
+        tail_.store(tail, std::memory_order_release);
+    }
+
+private:
+    std::vector<Event> slots_;
+    std::size_t mask_{};
+    alignas(64) std::atomic_size_t head_{};
+    alignas(64) std::atomic_size_t tail_{};
+};
+
+/** Profiling rings written by a single executor thread. */
+struct profile_producer
+{
+    explicit profile_producer(std::size_t capacity) : jobs(capacity), steals(capacity), dependencies(capacity) {}
+
+    profile_ring<job_profile_event> jobs;
+    profile_ring<job_steal_event> steals;
+    profile_ring<job_dependency_edge> dependencies;
+};
+
+detail::job_state_ref adopt_queued(detail::job_state* state) noexcept
+{
+    return detail::job_state_ref::adopt(state);
+}
+
+/** Marks a waiter list as closed; nothing is ever linked behind it. */
+detail::job_link closed_waiters;
+
+/** Returns false when the job already completed and will not visit the link. */
+bool push_waiter(detail::job_state& state, detail::job_link* link) noexcept
+{
+    detail::job_link* head = state.waiters.load(std::memory_order_acquire);
+    do
+    {
+        if (head == &closed_waiters) return false;
+        link->next = head;
+    } while (!state.waiters.compare_exchange_weak(head, link, std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+}
+
+} // namespace
+
 struct job_system::implementation
 {
+    /**
+     * Per-worker priority lanes. Only the owning worker pushes or pops; other
+     * workers and shutdown steal, so no operation takes a lock.
+     */
+    struct worker_queue
+    {
+        std::array<work_stealing_deque, priority_count> priorities;
+
+        /** The deque carries the reference as a raw pointer until a pop or steal adopts it. */
+        void push(detail::job_state_ref state)
+        {
+            priorities[static_cast<std::size_t>(state->priority)].push(state.get());
+            (void)state.detach();
+        }
+
+        detail::job_state_ref pop_local(std::size_t& high_priority_streak)
+        {
+            if (high_priority_streak >= fairness_quota)
+            {
+                for (std::size_t priority = 1; priority < priority_count; ++priority)
+                {
+                    if (priorities[priority].size() == 0) continue;
+                    if (auto* value = priorities[priority].pop())
+                    {
+                        high_priority_streak = 0;
+                        return adopt_queued(value);
+                    }
+                }
+            }
+            for (std::size_t priority = 0; priority < priority_count; ++priority)
+            {
+                if (priorities[priority].size() == 0) continue;
+                if (auto* value = priorities[priority].pop())
+                {
+                    high_priority_streak =
+                        priority <= static_cast<std::size_t>(job_priority::high) ? high_priority_streak + 1 : 0;
+                    return adopt_queued(value);
+                }
+            }
+            return {};
+        }
+
+        detail::job_state_ref steal()
+        {
+            for (auto& queue : priorities)
+            {
+                if (queue.size() == 0) continue;
+                if (auto* value = queue.steal()) return adopt_queued(value);
+            }
+            return {};
+        }
+
+        std::size_t size() const
+        {
+            std::size_t result{};
+            for (const auto& queue : priorities)
+                result += queue.size();
+            return result;
+        }
+
+        std::vector<detail::job_state_ref> take_all()
+        {
+            std::vector<detail::job_state_ref> result;
+            for (auto& queue : priorities)
+                while (queue.size() != 0)
+                    if (auto* value = queue.steal()) result.push_back(adopt_queued(value));
+            return result;
+        }
+    };
+
+    /** Multi-producer queue for injection and the dedicated main, render, and IO executors. */
     struct work_queue
     {
         mutable std::mutex mutex;
-        std::array<std::deque<std::shared_ptr<detail::job_state>>, priority_count> priorities;
+        std::array<std::deque<detail::job_state_ref>, priority_count> priorities;
 
-        void push(std::shared_ptr<detail::job_state> state, bool local)
+        void push(detail::job_state_ref state, bool local)
         {
             std::lock_guard lock(mutex);
             auto& queue = priorities[static_cast<std::size_t>(state->priority)];
@@ -97,7 +792,7 @@ struct job_system::implementation
                 queue.push_front(std::move(state));
         }
 
-        std::shared_ptr<detail::job_state> pop_local(std::size_t& high_priority_streak)
+        detail::job_state_ref pop_local(std::size_t& high_priority_streak)
         {
             std::lock_guard lock(mutex);
             std::size_t first = 0;
@@ -126,7 +821,7 @@ struct job_system::implementation
             return {};
         }
 
-        std::shared_ptr<detail::job_state> steal()
+        detail::job_state_ref steal()
         {
             std::lock_guard lock(mutex);
             for (auto& queue : priorities)
@@ -148,10 +843,10 @@ struct job_system::implementation
             return result;
         }
 
-        std::vector<std::shared_ptr<detail::job_state>> take_all()
+        std::vector<detail::job_state_ref> take_all()
         {
             std::lock_guard lock(mutex);
-            std::vector<std::shared_ptr<detail::job_state>> result;
+            std::vector<detail::job_state_ref> result;
             for (auto& queue : priorities)
             {
                 while (!queue.empty())
@@ -169,10 +864,28 @@ struct job_system::implementation
     {
     }
 
+    ~implementation()
+    {
+        if (states) states->release_reference();
+    }
+
+    implementation(const implementation&) = delete;
+    implementation& operator=(const implementation&) = delete;
+
     job_system* scheduler{};
     job_system_config config;
     memory::memory_system* memory{};
-    std::vector<std::unique_ptr<work_queue>> workers;
+    detail::job_state_pool* states{};
+    std::vector<std::unique_ptr<worker_queue>> workers;
+    cpu_topology topology;
+    // Placement of each general worker, and its steal victims ordered same L3
+    // first, then same NUMA node, then everything else.
+    std::vector<cpu_info> worker_cpus;
+    std::vector<std::vector<std::size_t>> victims;
+    std::vector<std::size_t> same_l3_victims;
+    // Injection queues for near_parent jobs submitted from outside their domain.
+    std::vector<std::unique_ptr<work_queue>> domain_queues;
+    std::vector<std::uint32_t> domain_numa_nodes;
     work_queue injection;
     work_queue main;
     work_queue render;
@@ -181,115 +894,251 @@ struct job_system::implementation
     std::vector<std::thread> io_threads;
     std::thread render_thread;
     std::thread::id main_thread;
-    mutable std::mutex wake_mutex;
-    std::condition_variable wake;
+    std::unique_ptr<parking_lot> worker_parking;
+    std::unique_ptr<parking_lot> io_parking;
+    std::unique_ptr<parking_lot> render_parking;
     std::atomic_bool stopping{};
     std::atomic<job_shutdown_mode> shutdown_mode{job_shutdown_mode::drain};
     std::atomic_uint64_t next_sequence{};
     std::atomic_uint64_t submitted{};
     std::atomic_uint64_t completed{};
     std::atomic_uint64_t stolen{};
+    std::atomic_uint64_t stolen_same_l3{};
+    std::atomic_uint64_t stolen_cross_l3{};
+    std::atomic_uint64_t stolen_cross_numa{};
     std::atomic_uint64_t cancelled{};
     std::atomic_uint64_t failed{};
+    std::atomic_uint64_t spurious_wakeups{};
     std::atomic_size_t active{};
+    // General workers currently running a job and not parked in a wait.
+    std::atomic_size_t busy_workers{};
     std::atomic_uint64_t snapshot_sequence{};
-    mutable std::mutex profile_mutex;
-    mutable std::deque<job_profile_event> profile_events;
+    // One producer per general worker, IO thread and render thread, then a
+    // shared one for every other thread, serialised by external_profile_mutex.
+    std::vector<std::unique_ptr<profile_producer>> profile_producers;
+    std::mutex external_profile_mutex;
+    // Guards the collector side of every ring and the retained history.
+    std::mutex profile_mutex;
+    std::deque<job_profile_event> profile_events;
+    std::deque<job_steal_event> steal_events;
+    std::deque<job_dependency_edge> dependency_events;
     std::atomic_uint64_t dropped_profile_events{};
 
-    bool queues_empty() const
+    parking_lot* parking_for(job_affinity affinity) const noexcept
+    {
+        switch (affinity)
+        {
+            case job_affinity::any_worker:
+                return worker_parking.get();
+            case job_affinity::render_thread:
+                return render_parking.get();
+            case job_affinity::io_thread:
+                return io_parking.get();
+            case job_affinity::main_thread:
+                break;
+        }
+        return nullptr;
+    }
+
+    void wake_all()
+    {
+        for (auto* parking : {worker_parking.get(), io_parking.get(), render_parking.get()})
+            if (parking) parking->wake_all();
+    }
+
+    bool general_work_available() const
     {
-        if (injection.size() || main.size() || render.size() || io.size()) return false;
+        if (injection.size()) return true;
+        for (const auto& queue : domain_queues)
+            if (queue->size()) return true;
         for (const auto& worker : workers)
-            if (worker->size()) return false;
-        return true;
+            if (worker->size()) return true;
+        return false;
     }
-};
 
-namespace
-{
+    bool queues_empty() const
+    {
+        return !general_work_available() && !main.size() && !render.size() && !io.size();
+    }
 
-class job_pool_resource final : public std::pmr::memory_resource
-{
-public:
-    explicit job_pool_resource(memory::memory_system& memory)
-        : backing_(memory, memory::memory_domain::jobs, memory::make_memory_tag("jobs.state")),
-          pool_(std::array<std::size_t, 3>{256, 512, 1024}, 64, &backing_)
+    void create_profile_producers()
     {
+        if (config.profile_event_capacity == 0) return;
+        const std::size_t count =
+            config.run_inline ? 1 : workers.size() + config.io_worker_count + (config.enable_render_thread ? 1 : 0) + 1;
+        const auto capacity = std::max<std::size_t>(config.profile_event_capacity / count, 64);
+        for (std::size_t index = 0; index < count; ++index)
+            profile_producers.push_back(std::make_unique<profile_producer>(capacity));
     }
 
-private:
-    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    /** Pushes onto the calling thread's ring; full rings count the event as dropped. */
+    template <class Select, class Fill> void record_profile_event(const Select& select, const Fill& fill)
     {
-        if (bytes <= 1024 && alignment <= alignof(std::max_align_t))
+        if (profile_producers.empty()) return;
+        const auto push = [&](profile_producer& producer)
+        {
+            if (!select(producer).push(fill)) dropped_profile_events.fetch_add(1, std::memory_order_relaxed);
+        };
+        if (worker_context.scheduler == scheduler)
         {
-            if (void* pointer = pool_.try_allocate(bytes, alignment)) return pointer;
-            throw std::bad_alloc();
+            std::size_t index = worker_context.worker_index;
+            if (worker_context.affinity == job_affinity::io_thread) index += workers.size();
+            if (worker_context.affinity == job_affinity::render_thread)
+                index = workers.size() + config.io_worker_count;
+            push(*profile_producers[index]);
+            return;
         }
-        return backing_.allocate(bytes, alignment);
+        std::lock_guard lock(external_profile_mutex);
+        push(*profile_producers.back());
     }
 
-    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override
+    /** Moves every ring's events into the bounded history. Requires profile_mutex. */
+    void collect_profile_events()
     {
-        if (bytes <= 1024 && alignment <= alignof(std::max_align_t))
-            pool_.deallocate(pointer, bytes);
-        else
-            backing_.deallocate(pointer, bytes, alignment);
+        const auto merge = [this](auto& history, auto select, auto timestamp)
+        {
+            using event_type = typename std::remove_cvref_t<decltype(history)>::value_type;
+            std::vector<event_type> batch;
+            for (auto& producer : profile_producers)
+                select(*producer).drain([&batch](const event_type& event) { batch.push_back(event); });
+            // Rings are per thread; restore a single timeline before appending.
+            std::stable_sort(batch.begin(), batch.end(), [&](const event_type& left, const event_type& right)
+                             { return timestamp(left) < timestamp(right); });
+            for (auto& event : batch)
+            {
+                if (history.size() >= config.profile_event_capacity)
+                {
+                    history.pop_front();
+                    dropped_profile_events.fetch_add(1, std::memory_order_relaxed);
+                }
+                history.push_back(std::move(event));
+            }
+        };
+        merge(profile_events, [](profile_producer& producer) -> auto& { return producer.jobs; },
+              [](const job_profile_event& event) { return event.completed_nanoseconds; });
+        merge(steal_events, [](profile_producer& producer) -> auto& { return producer.steals; },
+              [](const job_steal_event& event) { return event.timestamp_nanoseconds; });
+        merge(dependency_events, [](profile_producer& producer) -> auto& { return producer.dependencies; },
+              [](const job_dependency_edge& event) { return event.released_nanoseconds; });
     }
 
-    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    void record_steal(std::size_t thief, std::uint32_t victim_worker, std::uint32_t victim_l3,
+                      std::uint32_t victim_numa, std::uint64_t sequence)
     {
-        return this == &other;
+        stolen.fetch_add(1, std::memory_order_relaxed);
+        record_profile_event([](profile_producer& producer) -> auto& { return producer.steals; },
+                             [&](job_steal_event& event)
+                             {
+                                 event = {.sequence = sequence,
+                                          .thread_id = thread_id_value(),
+                                          .thief_worker = static_cast<std::uint32_t>(thief),
+                                          .victim_worker = victim_worker,
+                                          .victim_l3_domain = victim_l3,
+                                          .timestamp_nanoseconds = now_nanoseconds()};
+                             });
+        const auto& cpu = worker_cpus[thief];
+        if (cpu.l3_domain == victim_l3)
+        {
+            stolen_same_l3.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        stolen_cross_l3.fetch_add(1, std::memory_order_relaxed);
+        if (cpu.numa_node != victim_numa) stolen_cross_numa.fetch_add(1, std::memory_order_relaxed);
     }
 
-    memory::system_memory_resource backing_;
-    memory::fixed_block_pool pool_;
+    /** Assigns workers to CPUs domain by domain and derives each worker's steal order. */
+    void place_workers(std::size_t worker_count)
+    {
+        if (topology.cpus.empty())
+        {
+            topology.cpus.push_back({.id = 0, .package = 0, .l3_domain = 0, .numa_node = 0});
+            topology.l3_domain_count = 1;
+            topology.numa_node_count = 1;
+        }
+        // Caller-supplied topologies may be sparse or disagree with their own counts; renumber domains densely.
+        std::map<std::uint32_t, std::uint32_t> l3_domains;
+        std::map<std::uint32_t, std::uint32_t> numa_nodes;
+        for (const auto& cpu : topology.cpus)
+        {
+            l3_domains.emplace(cpu.l3_domain, 0u);
+            numa_nodes.emplace(cpu.numa_node, 0u);
+        }
+        std::uint32_t next{};
+        for (auto& [domain, index] : l3_domains)
+            index = next++;
+        next = 0;
+        for (auto& [node, index] : numa_nodes)
+            index = next++;
+        for (auto& cpu : topology.cpus)
+        {
+            cpu.l3_domain = l3_domains[cpu.l3_domain];
+            cpu.numa_node = numa_nodes[cpu.numa_node];
+        }
+        topology.l3_domain_count = l3_domains.size();
+        topology.numa_node_count = numa_nodes.size();
+        auto ordered = topology.cpus;
+        std::stable_sort(ordered.begin(), ordered.end(),
+                         [](const cpu_info& left, const cpu_info& right)
+                         {
+                             return std::tie(left.numa_node, left.l3_domain) <
+                                    std::tie(right.numa_node, right.l3_domain);
+                         });
+        for (std::size_t index = 0; index < worker_count; ++index)
+            worker_cpus.push_back(ordered[index % ordered.size()]);
+
+        victims.resize(worker_count);
+        same_l3_victims.resize(worker_count);
+        for (std::size_t thief = 0; thief < worker_count; ++thief)
+        {
+            auto& order = victims[thief];
+            for (std::size_t offset = 1; offset < worker_count; ++offset)
+                order.push_back((thief + offset) % worker_count);
+            const auto distance = [&](std::size_t victim)
+            {
+                if (worker_cpus[victim].l3_domain == worker_cpus[thief].l3_domain) return 0;
+                return worker_cpus[victim].numa_node == worker_cpus[thief].numa_node ? 1 : 2;
+            };
+            std::stable_sort(order.begin(), order.end(),
+                             [&](std::size_t left, std::size_t right) { return distance(left) < distance(right); });
+            same_l3_victims[thief] = static_cast<std::size_t>(
+                std::count_if(order.begin(), order.end(), [&](std::size_t victim) { return distance(victim) == 0; }));
+        }
+        domain_numa_nodes.resize(topology.l3_domain_count);
+        for (const auto& cpu : topology.cpus)
+            domain_numa_nodes[cpu.l3_domain] = cpu.numa_node;
+        for (std::size_t domain = 0; domain < topology.l3_domain_count; ++domain)
+            domain_queues.push_back(std::make_unique<work_queue>());
+    }
 };
 
-std::mutex pool_resources_mutex;
-std::unordered_map<job_system::implementation*, std::shared_ptr<job_pool_resource>> pool_resources;
-
-std::shared_ptr<job_pool_resource> pool_resource_for(job_system::implementation& implementation)
-{
-    std::lock_guard lock(pool_resources_mutex);
-    auto& resource = pool_resources[&implementation];
-    if (!resource) resource = std::make_shared<job_pool_resource>(*implementation.memory);
-    return resource;
-}
-
-void release_pool_resource(job_system::implementation& implementation)
+namespace
 {
-    std::lock_guard lock(pool_resources_mutex);
-    pool_resources.erase(&implementation);
-}
 
-void record_profile(job_system::implementation& implementation, const std::shared_ptr<detail::job_state>& state)
+void record_profile(job_system::implementation& implementation, const detail::job_state& state)
 {
-    job_profile_event event{.sequence = state->sequence,
-                            .name = state->name,
-                            .priority = state->priority,
-                            .affinity = state->affinity,
-                            .status = state->status.load(std::memory_order_acquire),
-                            .thread_id = state->execution_thread,
-                            .queued_nanoseconds = state->queued_time,
-                            .started_nanoseconds = state->started_time,
-                            .completed_nanoseconds = state->completed_time};
-    std::lock_guard lock(implementation.profile_mutex);
-    if (implementation.profile_events.size() >= implementation.config.profile_event_capacity)
-    {
-        implementation.profile_events.pop_front();
-        implementation.dropped_profile_events.fetch_add(1, std::memory_order_relaxed);
-    }
-    implementation.profile_events.push_back(std::move(event));
+    implementation.record_profile_event([](profile_producer& producer) -> auto& { return producer.jobs; },
+                                        [&state](job_profile_event& event)
+                                        {
+                                            // Assign in place so the slot's name keeps its capacity.
+                                            event.sequence = state.sequence;
+                                            event.name.assign(state.name);
+                                            event.priority = state.priority;
+                                            event.affinity = state.affinity;
+                                            event.status = state.status.load(std::memory_order_acquire);
+                                            event.thread_id = state.execution_thread;
+                                            event.queued_nanoseconds = state.queued_time;
+                                            event.started_nanoseconds = state.started_time;
+                                            event.completed_nanoseconds = state.completed_time;
+                                        });
 }
 
-void finish_part(job_system::implementation& implementation, const std::shared_ptr<detail::job_state>& state,
+void finish_part(job_system::implementation& implementation, const detail::job_state_ref& state,
                  job_status requested_status);
 
 void dependency_finished(job_system::implementation& implementation,
-                         const std::shared_ptr<detail::job_state>& dependent, job_status prerequisite_status);
+                         const detail::job_state_ref& dependent, job_status prerequisite_status);
 
-void enqueue_ready(job_system::implementation& implementation, std::shared_ptr<detail::job_state> state)
+void enqueue_ready(job_system::implementation& implementation, detail::job_state_ref state)
 {
     if (state->cancellation.stop_requested() || (state->dependency_failed.load(std::memory_order_acquire) &&
                                                  state->dependency_policy == job_dependency_policy::cancel_on_failure))
@@ -300,14 +1149,14 @@ void enqueue_ready(job_system::implementation& implementation, std::shared_ptr<d
 
     state->status.store(job_status::queued, std::memory_order_release);
     state->queued_time = now_nanoseconds();
+    const job_affinity affinity = state->affinity;
     if (implementation.config.run_inline)
     {
         state->status.store(job_status::running, std::memory_order_release);
         state->started_time = now_nanoseconds();
         state->execution_thread = thread_id_value();
         job_status completion = job_status::succeeded;
-        const auto previous_job = current_job_state;
-        current_job_state = state;
+        auto* const previous_job = std::exchange(current_job_state, state.get());
         try
         {
             state->function();
@@ -334,22 +1183,34 @@ void enqueue_ready(job_system::implementation& implementation, std::shared_ptr<d
             implementation.io.push(std::move(state), false);
             break;
         case job_affinity::any_worker:
-            if (worker_context.scheduler == implementation.scheduler &&
-                worker_context.affinity == job_affinity::any_worker &&
-                worker_context.worker_index < implementation.workers.size())
+        {
+            const bool on_worker = worker_context.scheduler == implementation.scheduler &&
+                                   worker_context.affinity == job_affinity::any_worker &&
+                                   worker_context.worker_index < implementation.workers.size();
+            const auto preferred = state->preferred_l3;
+            if (on_worker && (preferred == no_domain ||
+                              implementation.worker_cpus[worker_context.worker_index].l3_domain == preferred))
+            {
+                implementation.workers[worker_context.worker_index]->push(std::move(state));
+            }
+            else if (preferred != no_domain)
             {
-                implementation.workers[worker_context.worker_index]->push(std::move(state), true);
+                implementation.domain_queues[preferred]->push(std::move(state), false);
+                implementation.worker_parking->wake_preferring(
+                    [&](std::size_t worker) { return implementation.worker_cpus[worker].l3_domain == preferred; });
+                return;
             }
             else
             {
                 implementation.injection.push(std::move(state), false);
             }
             break;
+        }
     }
-    implementation.wake.notify_all();
+    if (auto* parking = implementation.parking_for(affinity)) parking->wake();
 }
 
-void finish_part(job_system::implementation& implementation, const std::shared_ptr<detail::job_state>& state,
+void finish_part(job_system::implementation& implementation, const detail::job_state_ref& state,
                  job_status requested_status)
 {
     if (requested_status == job_status::failed)
@@ -378,27 +1239,50 @@ void finish_part(job_system::implementation& implementation, const std::shared_p
     if (final_status == job_status::cancelled) implementation.cancelled.fetch_add(1, std::memory_order_relaxed);
     implementation.completed.fetch_add(1, std::memory_order_relaxed);
 
-    std::vector<std::shared_ptr<detail::job_state>> dependents;
-    std::vector<std::coroutine_handle<>> continuations;
+    detail::job_link* waiters = state->waiters.exchange(&closed_waiters, std::memory_order_acq_rel);
+    if (state->completion.exchange(completion_done, std::memory_order_acq_rel) & completion_sleeping)
+        wake_word(state->completion);
+    record_profile(implementation, *state);
+
+    // Waiters were pushed LIFO; restore registration order before releasing them.
+    detail::job_link* ordered{};
+    while (waiters)
+        ordered = std::exchange(waiters, std::exchange(waiters->next, ordered));
+    detail::job_link* continuations{};
+    detail::job_link** continuations_tail = &continuations;
+    while (ordered)
     {
-        std::lock_guard lock(state->mutex);
-        dependents.swap(state->dependents);
-        continuations.swap(state->continuations);
+        detail::job_link* link = std::exchange(ordered, ordered->next);
+        if (link->dependent)
+        {
+            const auto dependent_sequence = link->dependent->sequence;
+            implementation.record_profile_event(
+                [](profile_producer& producer) -> auto& { return producer.dependencies; },
+                [&](job_dependency_edge& edge)
+                {
+                    edge = {.prerequisite_sequence = state->sequence,
+                            .dependent_sequence = dependent_sequence,
+                            .released_nanoseconds = state->completed_time};
+                });
+            dependency_finished(implementation, detail::job_state_ref::adopt(link->dependent), final_status);
+            continue;
+        }
+        link->next = nullptr;
+        *continuations_tail = link;
+        continuations_tail = &link->next;
     }
-    state->completion.notify_all();
-    record_profile(implementation, state);
-
-    for (const auto& dependent : dependents)
-        dependency_finished(implementation, dependent, final_status);
-    for (const auto continuation : continuations)
-        if (continuation) continuation.resume();
-    if (auto parent = state->parent.lock())
-        finish_part(implementation, parent,
+    while (continuations)
+    {
+        std::unique_ptr<detail::job_link> link(std::exchange(continuations, continuations->next));
+        if (link->continuation) link->continuation.resume();
+    }
+    if (state->parent)
+        finish_part(implementation, state->parent,
                     final_status == job_status::failed ? job_status::failed : job_status::succeeded);
 }
 
 void dependency_finished(job_system::implementation& implementation,
-                         const std::shared_ptr<detail::job_state>& dependent, job_status prerequisite_status)
+                         const detail::job_state_ref& dependent, job_status prerequisite_status)
 {
     if (prerequisite_status == job_status::failed || prerequisite_status == job_status::cancelled)
         dependent->dependency_failed.store(true, std::memory_order_release);
@@ -406,7 +1290,7 @@ void dependency_finished(job_system::implementation& implementation,
         enqueue_ready(implementation, dependent);
 }
 
-void execute_state(job_system::implementation& implementation, const std::shared_ptr<detail::job_state>& state)
+void execute_state(job_system::implementation& implementation, const detail::job_state_ref& state)
 {
     if (!state) return;
     if (implementation.shutdown_mode.load(std::memory_order_acquire) == job_shutdown_mode::cancel_pending ||
@@ -420,9 +1304,10 @@ void execute_state(job_system::implementation& implementation, const std::shared
     if (!state->status.compare_exchange_strong(expected, job_status::running, std::memory_order_acq_rel)) return;
     state->started_time = now_nanoseconds();
     state->execution_thread = thread_id_value();
+    if (worker_context.scheduler == implementation.scheduler && worker_context.affinity == job_affinity::any_worker)
+        state->execution_worker = static_cast<std::uint32_t>(worker_context.worker_index);
     implementation.active.fetch_add(1, std::memory_order_acq_rel);
-    const auto previous_job = current_job_state;
-    current_job_state = state;
+    auto* const previous_job = std::exchange(current_job_state, state.get());
     job_status completion = job_status::succeeded;
     try
     {
@@ -437,44 +1322,82 @@ void execute_state(job_system::implementation& implementation, const std::shared
     current_job_state = previous_job;
     finish_part(implementation, state, completion);
     implementation.active.fetch_sub(1, std::memory_order_acq_rel);
-    implementation.wake.notify_all();
+    // Draining shutdown waits for active to reach zero; let parked threads re-check.
+    if (implementation.stopping.load(std::memory_order_acquire)) implementation.wake_all();
 }
 
-std::shared_ptr<detail::job_state> take_general(job_system::implementation& implementation, std::size_t worker_index)
+detail::job_state_ref take_general(job_system::implementation& implementation, std::size_t worker_index)
 {
     static thread_local std::size_t streak{};
+    const auto& cpu = implementation.worker_cpus[worker_index];
     if (auto value = implementation.workers[worker_index]->pop_local(streak)) return value;
+    if (auto value = implementation.domain_queues[cpu.l3_domain]->pop_local(streak)) return value;
     if (auto value = implementation.injection.pop_local(streak)) return value;
 
-    const auto count = implementation.workers.size();
-    for (std::size_t offset = 1; offset < count; ++offset)
+    const auto steal_from = [&](std::size_t victim) -> detail::job_state_ref
     {
-        const auto victim = (worker_index + offset) % count;
-        if (auto value = implementation.workers[victim]->steal())
+        auto value = implementation.workers[victim]->steal();
+        if (value)
         {
-            implementation.stolen.fetch_add(1, std::memory_order_relaxed);
+            const auto& victim_cpu = implementation.worker_cpus[victim];
+            implementation.record_steal(worker_index, static_cast<std::uint32_t>(victim), victim_cpu.l3_domain,
+                                        victim_cpu.numa_node, value->sequence);
+        }
+        return value;
+    };
+    const auto& victims = implementation.victims[worker_index];
+    const auto same_l3 = implementation.same_l3_victims[worker_index];
+    for (std::size_t index = 0; index < same_l3; ++index)
+        if (auto value = steal_from(victims[index])) return value;
+    // Work pinned near another cache still beats idling once the local domain is dry.
+    for (std::size_t domain = 0; domain < implementation.domain_queues.size(); ++domain)
+    {
+        if (domain == cpu.l3_domain) continue;
+        if (auto value = implementation.domain_queues[domain]->steal())
+        {
+            implementation.record_steal(worker_index, job_steal_event::domain_queue, static_cast<std::uint32_t>(domain),
+                                        implementation.domain_numa_nodes[domain], value->sequence);
             return value;
         }
     }
+    for (std::size_t index = same_l3; index < victims.size(); ++index)
+        if (auto value = steal_from(victims[index])) return value;
     return {};
 }
 
+/** Bursts usually refill a queue within microseconds, so yield briefly before paying for a park. */
+template <class Ready> bool spin_for_work(const Ready& ready)
+{
+    for (std::size_t attempt = 0; attempt < idle_spin_count; ++attempt)
+    {
+        if (ready()) return true;
+        std::this_thread::yield();
+    }
+    return ready();
+}
+
 void general_worker_loop(job_system::implementation& implementation, std::size_t worker_index)
 {
     worker_context = {
         .scheduler = implementation.scheduler, .worker_index = worker_index, .affinity = job_affinity::any_worker};
+    if (implementation.config.pin_workers) pin_current_thread(implementation.worker_cpus[worker_index].id);
     for (;;)
     {
         if (auto state = take_general(implementation, worker_index))
         {
+            implementation.busy_workers.fetch_add(1, std::memory_order_relaxed);
             execute_state(implementation, state);
+            implementation.busy_workers.fetch_sub(1, std::memory_order_relaxed);
             continue;
         }
         if (implementation.stopping.load(std::memory_order_acquire) &&
             implementation.active.load(std::memory_order_acquire) == 0 && implementation.queues_empty())
             break;
-        std::unique_lock lock(implementation.wake_mutex);
-        implementation.wake.wait_for(lock, std::chrono::milliseconds(2));
+        const auto ready = [&]
+        { return implementation.stopping.load(std::memory_order_acquire) || implementation.general_work_available(); };
+        if (spin_for_work(ready)) continue;
+        if (implementation.worker_parking->park(worker_index, ready) && !ready())
+            implementation.spurious_wakeups.fetch_add(1, std::memory_order_relaxed);
     }
     worker_context = {};
 }
@@ -494,8 +1417,11 @@ void affinity_worker_loop(job_system::implementation& implementation, job_affini
         if (implementation.stopping.load(std::memory_order_acquire) &&
             implementation.active.load(std::memory_order_acquire) == 0 && implementation.queues_empty())
             break;
-        std::unique_lock lock(implementation.wake_mutex);
-        implementation.wake.wait_for(lock, std::chrono::milliseconds(2));
+        const auto ready = [&]
+        { return implementation.stopping.load(std::memory_order_acquire) || queue->size() != 0; };
+        if (spin_for_work(ready)) continue;
+        if (implementation.parking_for(affinity)->park(index, ready) && !ready())
+            implementation.spurious_wakeups.fetch_add(1, std::memory_order_relaxed);
     }
     worker_context = {};
 }
@@ -536,7 +1462,7 @@ bool cancellation_source::stop_requested() const noexcept
     return state_->cancelled.load(std::memory_order_acquire);
 }
 
-job_handle::job_handle(std::shared_ptr<detail::job_state> state) noexcept : state_(std::move(state)) {}
+job_handle::job_handle(detail::job_state_ref state) noexcept : state_(std::move(state)) {}
 
 void job_handle::wait() const
 {
@@ -613,19 +1539,50 @@ job_system_config job_system::single_threaded_config() noexcept
             .io_worker_count = 0,
             .enable_render_thread = false,
             .profile_event_capacity = 8192,
-            .memory = nullptr};
+            .memory = nullptr,
+            .pin_workers = false,
+            .topology = nullptr};
+}
+
+cpu_topology cpu_topology::discover()
+{
+    cpu_topology result;
+#if defined(__linux__)
+    result = discover_linux_topology();
+#endif
+    if (result.cpus.empty())
+    {
+        const auto count = std::max<std::uint32_t>(std::thread::hardware_concurrency(), 1);
+        for (std::uint32_t id = 0; id < count; ++id)
+            result.cpus.push_back({.id = id, .package = 0, .l3_domain = 0, .numa_node = 0});
+        result.l3_domain_count = 1;
+        result.numa_node_count = 1;
+    }
+    return result;
 }
 
 job_system::job_system(job_system_config config) : implementation_(std::make_unique<implementation>(*this, config))
 {
     auto& value = *implementation_;
     value.main_thread = std::this_thread::get_id();
-    if (config.run_inline) return;
+    const auto worker_count =
+        config.run_inline ? 0 : (config.worker_count == 0 ? default_worker_count() : config.worker_count);
+    value.states = new detail::job_state_pool(*value.memory, worker_count);
+    value.topology = config.topology ? *config.topology : cpu_topology::discover();
+    if (config.run_inline)
+    {
+        value.create_profile_producers();
+        return;
+    }
 
-    const auto worker_count = config.worker_count == 0 ? default_worker_count() : config.worker_count;
+    value.place_workers(worker_count);
     value.workers.reserve(worker_count);
     for (std::size_t index = 0; index < worker_count; ++index)
-        value.workers.push_back(std::make_unique<implementation::work_queue>());
+        value.workers.push_back(std::make_unique<implementation::worker_queue>());
+    value.create_profile_producers();
+    value.worker_parking = std::make_unique<parking_lot>(worker_count);
+    value.io_parking = std::make_unique<parking_lot>(config.io_worker_count);
+    value.render_parking = std::make_unique<parking_lot>(config.enable_render_thread ? 1 : 0);
     for (std::size_t index = 0; index < worker_count; ++index)
         value.worker_threads.emplace_back([&value, index] { general_worker_loop(value, index); });
     for (std::size_t index = 0; index < config.io_worker_count; ++index)
@@ -637,7 +1594,6 @@ job_system::job_system(job_system_config config) : implementation_(std::make_uni
 job_system::~job_system()
 {
     shutdown();
-    release_pool_resource(*implementation_);
 }
 
 job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_callable function, bool detached)
@@ -649,27 +1605,12 @@ job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_cal
         implementation_->config.io_worker_count == 0)
         throw std::invalid_argument("IO-affinity job submitted without an IO executor");
 
-    auto pool = pool_resource_for(*implementation_);
-    void* state_memory = pool->allocate(sizeof(detail::job_state), alignof(detail::job_state));
-    detail::job_state* raw_state{};
-    try
-    {
-        raw_state = new (state_memory) detail::job_state();
-    }
-    catch (...)
-    {
-        pool->deallocate(state_memory, sizeof(detail::job_state), alignof(detail::job_state));
-        throw;
-    }
-    auto state = std::shared_ptr<detail::job_state>(raw_state,
-                                                    [pool = std::move(pool)](detail::job_state* value)
-                                                    {
-                                                        value->~job_state();
-                                                        pool->deallocate(value, sizeof(detail::job_state),
-                                                                         alignof(detail::job_state));
-                                                    });
+    const bool on_worker = worker_context.scheduler == this && worker_context.affinity == job_affinity::any_worker &&
+                           worker_context.worker_index < implementation_->workers.size();
+    detail::job_state_ref state(
+        implementation_->states->acquire(on_worker ? worker_context.worker_index : static_cast<std::size_t>(-1)));
     state->scheduler = this;
-    state->name = descriptor.name.empty() ? "unnamed job" : std::string(descriptor.name);
+    state->name.assign(descriptor.name.empty() ? std::string_view("unnamed job") : descriptor.name);
     state->priority = descriptor.priority;
     state->affinity = descriptor.affinity;
     state->dependency_policy = descriptor.dependency_policy;
@@ -686,6 +1627,15 @@ job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_cal
     state->detached = detached;
     state->sequence = implementation_->next_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
     implementation_->submitted.fetch_add(1, std::memory_order_relaxed);
+    if (descriptor.locality == job_locality::near_parent && implementation_->domain_queues.size() > 1)
+    {
+        const detail::job_state* origin =
+            descriptor.parent.valid() ? descriptor.parent.state_.get() : current_job_state;
+        if (origin && origin->scheduler == this && origin->execution_worker < implementation_->worker_cpus.size())
+            state->preferred_l3 = implementation_->worker_cpus[origin->execution_worker].l3_domain;
+        else if (on_worker)
+            state->preferred_l3 = implementation_->worker_cpus[worker_context.worker_index].l3_domain;
+    }
 
     const auto for_each_dependency = [&descriptor](auto&& operation)
     {
@@ -701,9 +1651,9 @@ job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_cal
             [&descriptor](const job_handle& dependency)
             {
                 if (!dependency.valid()) return;
-                for (auto ancestor = descriptor.parent.state_; ancestor; ancestor = ancestor->parent.lock())
+                for (auto* ancestor = descriptor.parent.state_.get(); ancestor; ancestor = ancestor->parent.get())
                 {
-                    if (ancestor.get() == dependency.state_.get())
+                    if (ancestor == dependency.state_.get())
                         throw std::invalid_argument("a child job cannot depend on an ancestor that waits for it");
                 }
             });
@@ -711,7 +1661,7 @@ job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_cal
 
     if (descriptor.parent.valid())
     {
-        auto parent = descriptor.parent.state_;
+        const auto& parent = descriptor.parent.state_;
         auto unfinished = parent->unfinished.load(std::memory_order_acquire);
         while (unfinished != 0 &&
                !parent->unfinished.compare_exchange_weak(unfinished, unfinished + 1, std::memory_order_acq_rel))
@@ -721,23 +1671,23 @@ job_handle job_system::submit_erased(job_descriptor descriptor, detail::task_cal
         state->parent = parent;
     }
 
+    // Links must not move once published, so size them before registering any.
+    state->links.reserve(descriptor.dependencies.size() + descriptor.dependency_view.size());
     const auto register_dependency = [&](const job_handle& dependency)
     {
         if (!dependency.valid() || dependency.state_.get() == state.get()) return;
 
-        bool completed{};
-        job_status dependency_status{};
-        {
-            std::lock_guard lock(dependency.state_->mutex);
-            dependency_status = dependency.state_->status.load(std::memory_order_acquire);
-            completed = job_status_complete(dependency_status);
-            if (!completed)
-            {
-                state->pending_dependencies.fetch_add(1, std::memory_order_relaxed);
-                dependency.state_->dependents.push_back(state);
-            }
-        }
-        if (completed && (dependency_status == job_status::failed || dependency_status == job_status::cancelled))
+        // Each published link owns a reference that the prerequisite adopts on completion.
+        auto& link = state->links.emplace_back(detail::job_link{.next = nullptr, .dependent = state.get()});
+        state->pending_dependencies.fetch_add(1, std::memory_order_relaxed);
+        detail::retain(state.get());
+        if (push_waiter(*dependency.state_, &link)) return;
+
+        detail::release(state.get());
+        state->pending_dependencies.fetch_sub(1, std::memory_order_relaxed);
+        state->links.pop_back();
+        const auto dependency_status = dependency.state_->status.load(std::memory_order_acquire);
+        if (dependency_status == job_status::failed || dependency_status == job_status::cancelled)
             state->dependency_failed.store(true, std::memory_order_release);
     };
 
@@ -772,16 +1722,17 @@ void job_system::wait_all(const std::vector<job_handle>& handles) const
         handle.wait();
 }
 
-job_wait_result job_system::wait_for(const std::shared_ptr<detail::job_state>& state) const noexcept
+job_wait_result job_system::wait_for(const detail::job_state_ref& state) const noexcept
 {
     if (!state) return {};
 
+    const bool on_worker = !implementation_->config.run_inline && worker_context.scheduler == this &&
+                           worker_context.affinity == job_affinity::any_worker &&
+                           worker_context.worker_index < implementation_->workers.size();
     while (!job_status_complete(state->status.load(std::memory_order_acquire)))
     {
         bool helped{};
-        if (!implementation_->config.run_inline && worker_context.scheduler == this &&
-            worker_context.affinity == job_affinity::any_worker &&
-            worker_context.worker_index < implementation_->workers.size())
+        if (on_worker)
         {
             if (auto work = take_general(*implementation_, worker_context.worker_index))
             {
@@ -803,9 +1754,15 @@ job_wait_result job_system::wait_for(const std::shared_ptr<detail::job_state>& s
         }
         if (!helped)
         {
-            std::unique_lock lock(state->mutex);
-            state->completion.wait_for(lock, std::chrono::milliseconds(1), [&]
-                                       { return job_status_complete(state->status.load(std::memory_order_acquire)); });
+            // Announce the sleeper so completion only pays for a wake when someone is blocked.
+            const auto word = state->completion.fetch_or(completion_sleeping, std::memory_order_acq_rel);
+            if ((word & completion_done) == 0)
+            {
+                // A blocked worker counts as idle so range algorithms keep splitting work toward it.
+                if (on_worker) implementation_->busy_workers.fetch_sub(1, std::memory_order_relaxed);
+                wait_on_word(state->completion, word | completion_sleeping, std::chrono::milliseconds(1));
+                if (on_worker) implementation_->busy_workers.fetch_add(1, std::memory_order_relaxed);
+            }
         }
     }
     return {.status = state->status.load(std::memory_order_acquire), .exception = state->exception};
@@ -848,6 +1805,17 @@ void job_system::register_main_thread() noexcept
     implementation_->main_thread = std::this_thread::get_id();
 }
 
+bool job_system::range_split_wanted() const noexcept
+{
+    const auto& value = *implementation_;
+    if (value.config.run_inline || value.workers.empty()) return false;
+    if (value.busy_workers.load(std::memory_order_relaxed) >= value.workers.size()) return false;
+    if (worker_context.scheduler == this && worker_context.affinity == job_affinity::any_worker &&
+        worker_context.worker_index < value.workers.size())
+        return value.workers[worker_context.worker_index]->size() == 0;
+    return value.injection.size() == 0;
+}
+
 bool job_system::is_main_thread() const noexcept
 {
     return implementation_->config.run_inline || implementation_->main_thread == std::this_thread::get_id();
@@ -855,9 +1823,8 @@ bool job_system::is_main_thread() const noexcept
 
 job_handle job_system::current_job() const noexcept
 {
-    auto state = current_job_state.lock();
-    if (!state || state->scheduler != this) return {};
-    return job_handle(std::move(state));
+    if (!current_job_state || current_job_state->scheduler != this) return {};
+    return job_handle(detail::job_state_ref(current_job_state));
 }
 
 void job_system::shutdown(job_shutdown_mode mode)
@@ -867,7 +1834,7 @@ void job_system::shutdown(job_shutdown_mode mode)
 
     if (mode == job_shutdown_mode::cancel_pending)
     {
-        auto cancel_queue = [&](implementation::work_queue& queue)
+        auto cancel_queue = [&](auto& queue)
         {
             for (auto& state : queue.take_all())
                 finish_part(*implementation_, state, job_status::cancelled);
@@ -876,6 +1843,8 @@ void job_system::shutdown(job_shutdown_mode mode)
         cancel_queue(implementation_->main);
         cancel_queue(implementation_->render);
         cancel_queue(implementation_->io);
+        for (auto& queue : implementation_->domain_queues)
+            cancel_queue(*queue);
         for (auto& worker : implementation_->workers)
             cancel_queue(*worker);
     }
@@ -886,7 +1855,7 @@ void job_system::shutdown(job_shutdown_mode mode)
         }
     }
 
-    implementation_->wake.notify_all();
+    implementation_->wake_all();
     for (auto& worker : implementation_->worker_threads)
         if (worker.joinable()) worker.join();
     for (auto& worker : implementation_->io_threads)
@@ -906,6 +1875,17 @@ std::size_t job_system::io_worker_count() const noexcept
     return implementation_->io_threads.size();
 }
 
+const cpu_topology& job_system::topology() const noexcept
+{
+    return implementation_->topology;
+}
+
+const cpu_info& job_system::worker_cpu(std::size_t worker_index) const
+{
+    if (worker_index >= implementation_->worker_cpus.size()) throw std::out_of_range("worker index out of range");
+    return implementation_->worker_cpus[worker_index];
+}
+
 bool job_system::run_inline() const noexcept
 {
     return implementation_->config.run_inline;
@@ -924,30 +1904,51 @@ job_system_snapshot job_system::snapshot(bool consume_events) const
         .submitted = implementation_->submitted.load(std::memory_order_relaxed),
         .completed = implementation_->completed.load(std::memory_order_relaxed),
         .stolen = implementation_->stolen.load(std::memory_order_relaxed),
+        .stolen_same_l3 = implementation_->stolen_same_l3.load(std::memory_order_relaxed),
+        .stolen_cross_l3 = implementation_->stolen_cross_l3.load(std::memory_order_relaxed),
+        .stolen_cross_numa = implementation_->stolen_cross_numa.load(std::memory_order_relaxed),
         .cancelled = implementation_->cancelled.load(std::memory_order_relaxed),
         .failed = implementation_->failed.load(std::memory_order_relaxed),
-        .dropped_profile_events = implementation_->dropped_profile_events.load(std::memory_order_relaxed),
-        .recent_events = {}};
+        .spurious_wakeups = implementation_->spurious_wakeups.load(std::memory_order_relaxed),
+        .dropped_profile_events = 0,
+        .recent_events = {},
+        .recent_steals = {},
+        .recent_dependencies = {}};
+    for (const auto& queue : implementation_->domain_queues)
+        result.queued_general += queue->size();
     for (const auto& worker : implementation_->workers)
         result.queued_general += worker->size();
-    std::lock_guard lock(implementation_->profile_mutex);
-    result.recent_events.assign(implementation_->profile_events.begin(), implementation_->profile_events.end());
-    if (consume_events) implementation_->profile_events.clear();
+    auto& value = *implementation_;
+    std::lock_guard lock(value.profile_mutex);
+    value.collect_profile_events();
+    result.dropped_profile_events = value.dropped_profile_events.load(std::memory_order_relaxed);
+    result.recent_events.assign(value.profile_events.begin(), value.profile_events.end());
+    result.recent_steals.assign(value.steal_events.begin(), value.steal_events.end());
+    result.recent_dependencies.assign(value.dependency_events.begin(), value.dependency_events.end());
+    if (consume_events)
+    {
+        value.profile_events.clear();
+        value.steal_events.clear();
+        value.dependency_events.clear();
+    }
     return result;
 }
 
-void job_system::add_coroutine_continuation(const std::shared_ptr<detail::job_state>& state,
-                                            std::coroutine_handle<> continuation)
+void job_system::flush_profile_events() const
 {
-    bool resume_immediately{};
+    std::lock_guard lock(implementation_->profile_mutex);
+    implementation_->collect_profile_events();
+}
+
+void job_system::add_coroutine_continuation(const detail::job_state_ref& state, std::coroutine_handle<> continuation)
+{
+    auto link = std::make_unique<detail::job_link>(detail::job_link{.continuation = continuation});
+    if (push_waiter(*state, link.get()))
     {
-        std::lock_guard lock(state->mutex);
-        if (job_status_complete(state->status.load(std::memory_order_acquire)))
-            resume_immediately = true;
-        else
-            state->continuations.push_back(continuation);
+        (void)link.release();
+        return;
     }
-    if (resume_immediately) continuation.resume();
+    continuation.resume();
 }
 
 void wait_all(const std::vector<job_handle>& handles)
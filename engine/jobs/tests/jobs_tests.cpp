@@ -2,12 +2,16 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <mutex>
 #include <numeric>
 #include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -96,6 +100,56 @@ TEST_CASE("parallel_for covers the requested range")
     REQUIRE(std::accumulate(values.begin(), values.end(), 0) == 153);
 }
 
+TEST_CASE("lazily split range algorithms match their serial results")
+{
+    arc::jobs::job_system jobs(worker_config(4));
+    std::vector<std::atomic_int> visits(100000);
+    jobs.parallel_for(0, visits.size(), 64,
+                      [&](std::size_t begin, std::size_t end)
+                      {
+                          for (std::size_t index = begin; index < end; ++index)
+                              visits[index].fetch_add(1, std::memory_order_relaxed);
+                      });
+    REQUIRE(std::all_of(visits.begin(), visits.end(), [](const std::atomic_int& value) { return value.load() == 1; }));
+
+    // Concatenation is associative but not commutative, so any reordering of partials shows up.
+    const auto order = arc::jobs::parallel_reduce(
+        jobs, 0, 20000, 16, std::vector<std::size_t>{},
+        [](std::size_t begin, std::size_t end)
+        {
+            std::vector<std::size_t> indices(end - begin);
+            std::iota(indices.begin(), indices.end(), begin);
+            return indices;
+        },
+        [](std::vector<std::size_t> left, const std::vector<std::size_t>& right)
+        {
+            left.insert(left.end(), right.begin(), right.end());
+            return left;
+        });
+    std::vector<std::size_t> expected(20000);
+    std::iota(expected.begin(), expected.end(), std::size_t{});
+    REQUIRE(order == expected);
+
+    std::vector<int> keys(50000);
+    std::uint32_t seed = 12345;
+    for (auto& key : keys)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        key = static_cast<int>(seed % 1000);
+    }
+    auto sorted = keys;
+    std::sort(sorted.begin(), sorted.end(), std::greater<>());
+    arc::jobs::parallel_sort(jobs, keys.begin(), keys.end(), std::greater<>(), 256);
+    REQUIRE(keys == sorted);
+
+    REQUIRE_THROWS_AS(jobs.parallel_for(0, 4096, 8,
+                                        [](std::size_t begin, std::size_t end)
+                                        {
+                                            if (begin <= 4000 && 4000 < end) throw std::runtime_error("range failure");
+                                        }),
+                      std::runtime_error);
+}
+
 TEST_CASE("worker job system executes queued work")
 {
     arc::jobs::job_system jobs(worker_config(2));
@@ -110,6 +164,147 @@ TEST_CASE("worker job system executes queued work")
     REQUIRE(count.load() == 32);
 }
 
+TEST_CASE("worker deques grow past their initial ring and run every job exactly once")
+{
+    arc::jobs::job_system jobs(worker_config(4));
+    constexpr std::size_t job_count = 4096;
+    std::vector<std::atomic_int> runs(job_count);
+
+    auto spawner = jobs.submit(job("spawner"),
+                               [&]
+                               {
+                                   for (std::size_t index = 0; index < job_count; ++index)
+                                       jobs.submit_child(job("leaf"), [&runs, index] { runs[index].fetch_add(1); });
+                               });
+
+    spawner.wait();
+    REQUIRE(std::all_of(runs.begin(), runs.end(), [](const std::atomic_int& value) { return value.load() == 1; }));
+}
+
+TEST_CASE("recycled job states keep dependencies and handles consistent")
+{
+    arc::jobs::job_handle survivor;
+    {
+        arc::jobs::job_system jobs(worker_config(3));
+        for (int round = 0; round < 8; ++round)
+        {
+            std::vector<int> order;
+            std::mutex order_mutex;
+            std::vector<arc::jobs::job_handle> chain;
+            for (int index = 0; index < 64; ++index)
+            {
+                auto descriptor = job("chain link");
+                if (!chain.empty()) descriptor.dependencies.push_back(chain.back());
+                chain.push_back(jobs.submit(std::move(descriptor),
+                                            [&order, &order_mutex, index]
+                                            {
+                                                std::lock_guard lock(order_mutex);
+                                                order.push_back(index);
+                                            }));
+            }
+            chain.back().wait();
+            REQUIRE(order.size() == chain.size());
+            REQUIRE(std::is_sorted(order.begin(), order.end()));
+        }
+        survivor = jobs.submit(job("survivor"), [] {});
+        survivor.wait();
+    }
+    REQUIRE(survivor.status() == arc::jobs::job_status::succeeded);
+}
+
+TEST_CASE("parked executors wake for individual jobs")
+{
+    arc::jobs::job_system jobs(worker_config(4, 2, true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::atomic_int completed{};
+    for (int round = 0; round < 16; ++round)
+    {
+        for (const auto affinity : {arc::jobs::job_affinity::any_worker, arc::jobs::job_affinity::io_thread,
+                                    arc::jobs::job_affinity::render_thread})
+        {
+            jobs.submit(job("wake", arc::jobs::job_priority::normal, affinity), [&] { ++completed; }).wait();
+        }
+    }
+    REQUIRE(completed.load() == 48);
+    const auto snapshot = jobs.snapshot();
+    REQUIRE(snapshot.spurious_wakeups <= snapshot.submitted);
+}
+
+TEST_CASE("workers fill L3 domains and near-parent children stay schedulable")
+{
+    const auto discovered = arc::jobs::cpu_topology::discover();
+    REQUIRE_FALSE(discovered.cpus.empty());
+    for (const auto& cpu : discovered.cpus)
+    {
+        REQUIRE(cpu.l3_domain < discovered.l3_domain_count);
+        REQUIRE(cpu.numa_node < discovered.numa_node_count);
+    }
+
+    arc::jobs::cpu_topology topology{.cpus = {}, .l3_domain_count = 2, .numa_node_count = 2};
+    for (std::uint32_t id = 0; id < 4; ++id)
+        topology.cpus.push_back({.id = id, .package = id / 2, .l3_domain = id / 2, .numa_node = id / 2});
+    auto config = worker_config(4);
+    config.topology = &topology;
+    arc::jobs::job_system jobs(config);
+    REQUIRE(jobs.topology().l3_domain_count == 2);
+    REQUIRE(jobs.worker_cpu(0).l3_domain == 0);
+    REQUIRE(jobs.worker_cpu(1).l3_domain == 0);
+    REQUIRE(jobs.worker_cpu(2).l3_domain == 1);
+    REQUIRE(jobs.worker_cpu(3).l3_domain == 1);
+
+    std::atomic_int children{};
+    std::vector<arc::jobs::job_handle> parents;
+    for (int index = 0; index < 32; ++index)
+    {
+        parents.push_back(jobs.submit(job("parent"),
+                                      [&]
+                                      {
+                                          for (int child = 0; child < 8; ++child)
+                                          {
+                                              auto descriptor = job("near child");
+                                              descriptor.locality = arc::jobs::job_locality::near_parent;
+                                              jobs.submit_child(std::move(descriptor), [&] { ++children; });
+                                          }
+                                      }));
+    }
+    jobs.wait_all(parents);
+    REQUIRE(children.load() == 256);
+    const auto snapshot = jobs.snapshot();
+    REQUIRE(snapshot.stolen == snapshot.stolen_same_l3 + snapshot.stolen_cross_l3);
+    REQUIRE(snapshot.stolen_cross_numa <= snapshot.stolen_cross_l3);
+}
+
+TEST_CASE("inconsistent caller topologies are renumbered into dense domains")
+{
+    arc::jobs::cpu_topology topology{.cpus = {}, .l3_domain_count = 1, .numa_node_count = 1};
+    for (std::uint32_t id = 0; id < 4; ++id)
+    {
+        const bool low = id < 2;
+        topology.cpus.push_back({.id = id, .package = 0, .l3_domain = low ? 7u : 40u, .numa_node = low ? 3u : 9u});
+    }
+    auto config = worker_config(4);
+    config.topology = &topology;
+    arc::jobs::job_system jobs(config);
+    REQUIRE(jobs.topology().l3_domain_count == 2);
+    REQUIRE(jobs.topology().numa_node_count == 2);
+    for (const auto& cpu : jobs.topology().cpus)
+    {
+        REQUIRE(cpu.l3_domain < jobs.topology().l3_domain_count);
+        REQUIRE(cpu.numa_node < jobs.topology().numa_node_count);
+    }
+    REQUIRE(jobs.worker_cpu(0).l3_domain == jobs.worker_cpu(1).l3_domain);
+    REQUIRE(jobs.worker_cpu(2).l3_domain == jobs.worker_cpu(3).l3_domain);
+    REQUIRE(jobs.worker_cpu(0).l3_domain != jobs.worker_cpu(2).l3_domain);
+
+    std::atomic_int completed{};
+    std::vector<arc::jobs::job_handle> handles;
+    for (int index = 0; index < 64; ++index)
+        handles.push_back(jobs.submit(job("sparse topology"), [&] { ++completed; }));
+    jobs.wait_all(handles);
+    REQUIRE(completed.load() == 64);
+}
+
 TEST_CASE("jobs wait for every dependency before running")
 {
     arc::jobs::job_system jobs(worker_config(3));
@@ -284,6 +479,48 @@ TEST_CASE("fire and forget tasks remain alive and are profiled")
     REQUIRE(snapshot.recent_events.size() == 64);
 }
 
+TEST_CASE("profiling rings flush per frame and export a chrome trace")
+{
+    arc::jobs::job_system jobs(worker_config(2));
+    auto first = jobs.submit(job("first \"quoted\""), [] {});
+    auto second_descriptor = job("second");
+    second_descriptor.dependencies.push_back(first);
+    auto second = jobs.submit(std::move(second_descriptor), [] {});
+    second.wait();
+    jobs.flush_profile_events();
+
+    const auto snapshot = jobs.snapshot(true);
+    REQUIRE(snapshot.recent_events.size() == 2);
+    for (const auto& event : snapshot.recent_events)
+    {
+        REQUIRE(event.queued_nanoseconds <= event.started_nanoseconds);
+        REQUIRE(event.started_nanoseconds <= event.completed_nanoseconds);
+    }
+    REQUIRE(snapshot.recent_dependencies.size() == 1);
+    REQUIRE(snapshot.recent_dependencies.front().prerequisite_sequence == snapshot.recent_events[0].sequence);
+    REQUIRE(snapshot.recent_dependencies.front().dependent_sequence == snapshot.recent_events[1].sequence);
+    REQUIRE(snapshot.recent_steals.size() <= snapshot.stolen);
+    REQUIRE(jobs.snapshot().recent_events.empty());
+
+    std::ostringstream trace;
+    arc::jobs::write_chrome_trace(trace, snapshot);
+    const auto text = trace.str();
+    REQUIRE(text.starts_with("{\"displayTimeUnit\""));
+    REQUIRE(text.find(R"("name":"first \"quoted\"")") != std::string::npos);
+    REQUIRE(text.find(R"("ph":"X")") != std::string::npos);
+    REQUIRE(text.find(R"("cat":"queue")") != std::string::npos);
+    REQUIRE(text.find(R"("ph":"f")") != std::string::npos);
+
+    auto bounded = arc::jobs::job_system::single_threaded_config();
+    bounded.profile_event_capacity = 8;
+    arc::jobs::job_system inline_jobs(bounded);
+    for (int index = 0; index < 100; ++index)
+        inline_jobs.submit(job("bounded"), [] {}).wait();
+    const auto overflowed = inline_jobs.snapshot();
+    REQUIRE(overflowed.recent_events.size() == 8);
+    REQUIRE(overflowed.dropped_profile_events == 92);
+}
+
 #if defined(ARC_ENABLE_JOB_COROUTINES)
 namespace
 {
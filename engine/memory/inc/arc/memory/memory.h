@@ -10,9 +10,11 @@
 #include <functional>
 #include <memory>
 #include <memory_resource>
+#include <mutex>
 #include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace arc::memory
@@ -400,23 +402,38 @@ private:
     fixed_block_pool pool_;
 };
 
+/** How a world lays out its component storage. Fixed for the lifetime of the world. */
+enum class component_layout : std::uint8_t
+{
+    /** One sparse set per component type; adding or removing a component never moves the others. */
+    sparse_set,
+    /** Entities with identical component sets share 16 KiB structure-of-arrays chunks. */
+    archetype
+};
+
 class world_memory_context
 {
 public:
     explicit world_memory_context(memory_system& system = default_memory_system(), std::uint64_t world_id = 0,
-                                  memory_budget budget = {});
+                                  memory_budget budget = {}, component_layout layout = component_layout::sparse_set);
     ~world_memory_context();
 
     [[nodiscard]] std::uint64_t world_id() const noexcept;
+    [[nodiscard]] component_layout layout() const noexcept;
     [[nodiscard]] std::pmr::memory_resource* world_resource() noexcept;
     [[nodiscard]] std::pmr::memory_resource* component_resource() noexcept;
+    /** Component-domain resource charging its allocations to `tag`, such as one component pool's storage. */
+    [[nodiscard]] std::pmr::memory_resource* component_resource(memory_tag tag);
     [[nodiscard]] std::vector<memory_leak_record> leaks() const;
 
 private:
     memory_system* system_{};
     std::uint64_t world_id_{};
+    component_layout layout_{};
     system_memory_resource world_resource_;
     system_memory_resource component_resource_;
+    std::mutex tagged_component_mutex_;
+    std::unordered_map<std::uint32_t, std::unique_ptr<system_memory_resource>> tagged_component_resources_;
 };
 
 /**
@@ -897,9 +897,11 @@ std::size_t network_packet_pool::outstanding_bytes() const noexcept
     return pool_.outstanding_bytes();
 }
 
-world_memory_context::world_memory_context(memory_system& system, std::uint64_t world_id, memory_budget budget)
+world_memory_context::world_memory_context(memory_system& system, std::uint64_t world_id, memory_budget budget,
+                                           component_layout layout)
     : system_(&system),
       world_id_(world_id != 0 ? world_id : allocation_sequence.fetch_add(1, std::memory_order_relaxed) + 1),
+      layout_(layout),
       world_resource_(system, memory_domain::world, make_memory_tag("world"), world_id_),
       component_resource_(system, memory_domain::components, make_memory_tag("world.components"), world_id_)
 {
@@ -925,6 +927,11 @@ std::uint64_t world_memory_context::world_id() const noexcept
     return world_id_;
 }
 
+component_layout world_memory_context::layout() const noexcept
+{
+    return layout_;
+}
+
 std::pmr::memory_resource* world_memory_context::world_resource() noexcept
 {
     return &world_resource_;
@@ -935,6 +942,16 @@ std::pmr::memory_resource* world_memory_context::component_resource() noexcept
     return &component_resource_;
 }
 
+std::pmr::memory_resource* world_memory_context::component_resource(memory_tag tag)
+{
+    if (tag.id == 0) return &component_resource_;
+    std::lock_guard lock(tagged_component_mutex_);
+    auto& resource = tagged_component_resources_[tag.id];
+    if (!resource)
+        resource = std::make_unique<system_memory_resource>(*system_, memory_domain::components, tag, world_id_);
+    return resource.get();
+}
+
 std::vector<memory_leak_record> world_memory_context::leaks() const
 {
     return system_->leaks(world_id_);
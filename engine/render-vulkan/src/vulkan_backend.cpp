@@ -1570,28 +1570,39 @@ private:
         if (!event.packet) return;
 
         const auto& packet = *event.packet;
-        const auto make_draw = [&](const render_item& item, bool selected_for_overlay)
-        {
-            return draw_mesh_event{.gpu_scene_instance = item.gpu_scene_instance,
-                                   .mesh = item.mesh,
-                                   .material = item.material,
+        const auto& items = packet.item_stream();
+        const auto make_draw = [&](std::size_t index, bool selected_for_overlay)
+        {
+            const auto& item = items.details[index];
+            // Handles are only present once GPU Scene has synchronized the packet.
+            const auto instance =
+                index < packet.item_instances.size() ? packet.item_instances[index] : gpu_scene_instance_handle{};
+            return draw_mesh_event{.gpu_scene_instance = instance,
+                                   .mesh = items.meshes[index],
+                                   .material = items.materials[index],
                                    .model = item.model,
                                    .previous_model = item.previous_model,
                                    .view_projection = packet.camera.view_projection,
                                    .previous_view_projection = packet.camera.previous_view_projection,
-                                   .world_bounds = item.world_bounds,
+                                   .world_bounds = items.world_bounds.box(index),
                                    .mode = packet.mode,
                                    .visualization = packet.visualization,
                                    .object_id = item.object_id,
                                    .selected = selected_for_overlay,
-                                   .casts_shadows = item.casts_shadows,
-                                   .receives_shadows = item.receives_shadows,
+                                   .casts_shadows = items.has(index, render_item_flag::casts_shadows),
+                                   .receives_shadows = items.has(index, render_item_flag::receives_shadows),
                                    .mobility = item.mobility,
                                    .shadow_lod_bias = item.shadow_lod_bias,
                                    .maximum_shadow_distance = item.maximum_shadow_distance,
                                    .base_color_tint = item.base_color_tint,
                                    .wire_color = math::vector4f{1.0f, 0.48f, 0.04f, 1.0f},
-                                   .label = item.label};
+                                   .label = std::string(items.label(index))};
+        };
+        const auto overlay_selected = [&](std::size_t index)
+        {
+            return packet.overlay == editor_overlay_mode::all_wireframe ||
+                   (packet.overlay == editor_overlay_mode::selected_wireframe &&
+                    items.has(index, render_item_flag::selected));
         };
         const auto make_virtual_draw = [&](const virtual_render_item& item, bool selected_for_overlay)
         {
@@ -1638,22 +1649,17 @@ private:
 
         if (resolved_config_.features.gpu_driven_rendering)
         {
-            for (const auto& item : packet.items)
+            for (std::size_t index = 0; index < items.size(); ++index)
             {
-                if (!item.visible || !item.mesh.valid()) continue;
-                frame_draws_.push_back(
-                    make_draw(item, packet.overlay == editor_overlay_mode::all_wireframe ||
-                                        (packet.overlay == editor_overlay_mode::selected_wireframe && item.selected)));
+                if (!items.has(index, render_item_flag::visible) || !items.meshes[index].valid()) continue;
+                frame_draws_.push_back(make_draw(index, overlay_selected(index)));
             }
         }
         else
             for (const auto index : packet.visible_items)
             {
-                if (index >= packet.items.size()) continue;
-                const auto& item = packet.items[index];
-                frame_draws_.push_back(
-                    make_draw(item, packet.overlay == editor_overlay_mode::all_wireframe ||
-                                        (packet.overlay == editor_overlay_mode::selected_wireframe && item.selected)));
+                if (index >= items.size()) continue;
+                frame_draws_.push_back(make_draw(index, overlay_selected(index)));
             }
 
         if (resolved_config_.features.gpu_driven_rendering)
@@ -1676,10 +1682,12 @@ private:
                               (packet.overlay == editor_overlay_mode::selected_wireframe && item.selected)));
             }
 
-        for (const auto& item : packet.items)
+        for (std::size_t index = 0; index < items.size(); ++index)
         {
-            if (!item.visible || !item.casts_shadows || !item.mesh.valid()) continue;
-            frame_shadow_draws_.push_back(make_draw(item, item.selected));
+            if (!items.has(index, render_item_flag::visible) || !items.has(index, render_item_flag::casts_shadows) ||
+                !items.meshes[index].valid())
+                continue;
+            frame_shadow_draws_.push_back(make_draw(index, items.has(index, render_item_flag::selected)));
         }
         for (const auto& item : packet.virtual_items)
         {
@@ -1730,10 +1738,11 @@ private:
                 static_cast<std::uint32_t>(packet.visible_items.size() + packet.visible_virtual_items.size());
             profile.frustum_rejected =
                 static_cast<std::uint32_t>(packet.culled_item_count + packet.culled_virtual_cluster_count);
-            profile.indirect_commands = static_cast<std::uint32_t>(packet.items.size() + packet.virtual_items.size());
+            const auto item_count = items.size() - items.vacancies;
+            profile.indirect_commands = static_cast<std::uint32_t>(item_count + packet.virtual_items.size());
             if (resolved_config_.features.gpu_binding_model == gpu_resource_binding_model::classic)
                 profile.cpu_submissions += static_cast<std::uint32_t>(
-                    packet.items.size() + packet.virtual_items.size() + packet.visible_terrain_patches.size());
+                    item_count + packet.virtual_items.size() + packet.visible_terrain_patches.size());
         }
     }
 
@@ -177,6 +177,9 @@ class gpu_scene
 public:
     /**
      * @brief Reconcile one extracted world packet with persistent scene slots.
+     *
+     * When the packet's item delta continues the previous packet synchronized for its world, only the listed
+     * items, and items still settling from last frame's motion, are compared and written.
      * @param packet Mutable packet that receives stable instance handles.
      * @param frame_index Monotonic renderer frame index.
      * @return Incremental backend update batch for the frame.
@@ -228,11 +231,26 @@ private:
         std::uint64_t reuse_after_frame{};
     };
 
+    struct world_state
+    {
+        std::uint64_t epoch{};
+        std::uint64_t frame_index{};
+        /** Item-stream sequence of the last synchronized packet. */
+        std::uint64_t item_sequence{};
+        /** Slot bound to each item of the last packet; invalid for vacant items. */
+        std::vector<gpu_scene_instance_handle> item_slots;
+        /** Ascending item indices whose slot still carries `recently_changed`. */
+        std::vector<std::uint32_t> settling_items;
+        /** Terrain and virtual-mesh slots, which are reconciled in full every frame. */
+        std::vector<std::uint32_t> auxiliary_slots;
+    };
+
     std::vector<slot> slots_;
     std::vector<std::uint32_t> free_slots_;
     std::vector<retired_slot> retired_slots_;
     std::unordered_map<instance_key, std::uint32_t, instance_key_hash> lookup_;
-    std::unordered_map<std::uint64_t, std::uint64_t> world_epochs_;
+    std::unordered_map<std::uint64_t, world_state> worlds_;
+    std::vector<std::uint32_t> touched_items_;
     std::uint32_t active_instance_count_{};
 };
 
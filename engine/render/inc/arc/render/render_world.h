@@ -11,11 +11,19 @@
 #include <arc/math/matrix.h>
 #include <arc/math/vector.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+namespace arc::jobs
+{
+class job_system;
+}
+
 namespace arc::render
 {
 
@@ -66,12 +74,42 @@ struct render_skin
     std::uint32_t joint_count{};
 };
 
+/**
+ * @brief Per-item state bits kept in the hot draw stream.
+ */
+enum class render_item_flag : std::uint8_t
+{
+    none = 0,
+    visible = 1u << 0u,
+    selected = 1u << 1u,
+    transparent = 1u << 2u,
+    casts_shadows = 1u << 3u,
+    receives_shadows = 1u << 4u,
+    affects_indirect_lighting = 1u << 5u,
+    visible_in_hardware_tracing = 1u << 6u,
+    /** Slot released by an incremental extractor; it draws nothing and every consumer skips it. */
+    vacant = 1u << 7u
+};
+
+[[nodiscard]] constexpr render_item_flag operator|(render_item_flag lhs, render_item_flag rhs) noexcept
+{
+    return static_cast<render_item_flag>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+}
+
+/** @brief Return whether a render item flag set contains a requested flag. */
+[[nodiscard]] constexpr bool contains(render_item_flag value, render_item_flag requested) noexcept
+{
+    return (static_cast<std::uint8_t>(value) & static_cast<std::uint8_t>(requested)) != 0u;
+}
+
 /**
  * @brief One extracted scene draw candidate before backend command generation.
+ *
+ * Extraction fills this record and appends it to a `render_draw_stream`, which splits it into hot and cold
+ * storage; the label is copied into the stream's string table.
  */
 struct render_item
 {
-    gpu_scene_instance_handle gpu_scene_instance{};
     mesh_handle mesh{};
     material_handle material{};
     std::uint32_t submesh{};
@@ -79,7 +117,6 @@ struct render_item
     math::matrix4f previous_model{math::identity<float, 4>()};
     geometric::box3f world_bounds{};
     std::uint32_t render_layer_mask{1u};
-    std::uint64_t sort_key{};
     render_object_id object_id{};
     buffer_handle skin_matrices{};
     std::uint32_t skin_joint_count{};
@@ -100,7 +137,30 @@ struct render_item
     float distance_field_resolution_bias{};
     bool visible_in_hardware_tracing{true};
     math::vector4f base_color_tint = math::vector4f::one;
-    std::string label;
+    std::string_view label;
+};
+
+/**
+ * @brief Cold per-item data read only when a surviving item is turned into a draw or a GPU Scene instance.
+ */
+struct render_item_detail
+{
+    std::uint32_t submesh{};
+    math::matrix4f model{math::identity<float, 4>()};
+    math::matrix4f previous_model{math::identity<float, 4>()};
+    render_object_id object_id{};
+    buffer_handle skin_matrices{};
+    std::uint32_t skin_joint_count{};
+    std::uint32_t instance_start{};
+    std::uint32_t instance_count{1};
+    render_mobility mobility{render_mobility::movable};
+    float shadow_lod_bias{};
+    float maximum_shadow_distance{};
+    float maximum_draw_distance{};
+    float geometry_error_scale{1.0f};
+    float surface_card_density_bias{};
+    float distance_field_resolution_bias{};
+    math::vector4f base_color_tint = math::vector4f::one;
 };
 
 /**
@@ -413,6 +473,15 @@ struct render_instance_batch
     std::uint64_t sort_key{};
 };
 
+/**
+ * @brief Sort key paired with the index of the item it orders.
+ */
+struct render_sort_entry
+{
+    std::uint64_t key{};
+    std::uint32_t index{};
+};
+
 /**
  * @brief One indirect indexed draw command in backend-neutral form.
  */
@@ -442,6 +511,113 @@ struct view_frustum
     frustum_plane planes[6]{};
 };
 
+/**
+ * @brief Axis-aligned bounds split into one stream per min/max coordinate for packet frustum culling.
+ *
+ * Streams are padded to whole packets so the culling kernel always loads full registers.
+ */
+struct render_bounds_stream
+{
+    static constexpr std::size_t packet_lanes = 8;
+
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> min_z;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+    std::vector<float> max_z;
+    std::size_t count{};
+
+    void resize(std::size_t size);
+    void clear() noexcept;
+    void push_back(const geometric::box3f& bounds);
+    void assign(std::size_t index, const geometric::box3f& bounds) noexcept;
+    [[nodiscard]] geometric::box3f box(std::size_t index) const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return count;
+    }
+};
+
+/**
+ * @brief Extracted scene draw candidates stored as parallel streams, one element per item.
+ *
+ * Culling, sort-key generation, and batching only read the hot streams (bounds, mesh, material, layer mask,
+ * flags). Matrices, lighting biases, and tint live in `details`; labels are packed into one string table so
+ * appending an item never allocates per label. A persistent extractor may rewrite items in place and leave
+ * vacant slots behind, so indices stay stable across frames.
+ */
+struct render_draw_stream
+{
+    /** Byte range of one item's label in `label_data`. */
+    struct label_range
+    {
+        std::uint32_t offset{};
+        std::uint32_t size{};
+    };
+
+    render_bounds_stream world_bounds;
+    std::vector<mesh_handle> meshes;
+    std::vector<material_handle> materials;
+    std::vector<std::uint32_t> render_layer_masks;
+    std::vector<render_item_flag> flags;
+    std::vector<render_item_detail> details;
+    std::vector<label_range> labels;
+    std::string label_data;
+    /** Number of items currently marked `render_item_flag::vacant`. */
+    std::size_t vacancies{};
+    /** Bytes of `label_data` no item refers to any more; compacted away once they outweigh the live bytes. */
+    std::size_t dead_label_bytes{};
+
+    /** Split an item into the hot and cold streams and return its index. */
+    std::uint32_t push_back(const render_item& item);
+    /** Overwrite item `index`; a changed label is written over the old one when it fits and appended otherwise. */
+    void assign(std::size_t index, const render_item& item);
+    /** Release item `index` without moving the items after it. */
+    void vacate(std::size_t index);
+    /** Append every item of `other` in order, copying its label table in one block. */
+    void append(const render_draw_stream& other);
+    /** Repack `label_data` so it holds only the labels items still refer to. */
+    void compact_labels();
+    void reserve(std::size_t capacity);
+    void clear();
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return meshes.size();
+    }
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return meshes.empty();
+    }
+    [[nodiscard]] bool has(std::size_t index, render_item_flag flag) const noexcept
+    {
+        return contains(flags[index], flag);
+    }
+    [[nodiscard]] std::string_view label(std::size_t index) const noexcept
+    {
+        return std::string_view(label_data).substr(labels[index].offset, labels[index].size);
+    }
+};
+
+/**
+ * @brief Item-stream edits relative to an earlier packet of the same world.
+ *
+ * An extractor that keeps item indices stable reports which items it rewrote or vacated, so GPU Scene
+ * synchronization can touch only those. A consumer that did not synchronize the packet named by
+ * `base_sequence` reconciles the whole stream instead.
+ */
+struct render_item_delta
+{
+    /** Sequence of the packet these edits apply to; zero requests full reconciliation. */
+    std::uint64_t base_sequence{};
+    /** Process-unique sequence of this packet's item stream; zero when the stream is not tracked. */
+    std::uint64_t sequence{};
+    /** Items rewritten since the base packet, including newly occupied slots, in ascending order. */
+    std::vector<std::uint32_t> changed_items;
+    /** Items vacated since the base packet, in ascending order. */
+    std::vector<std::uint32_t> removed_items;
+};
+
 enum class debug_overlay_depth_mode : std::uint8_t
 {
     tested,
@@ -504,7 +680,15 @@ struct render_world_packet
     std::vector<water_render_data> waters;
     std::vector<vegetation_render_data> vegetation;
     std::vector<decal_render_data> decals;
-    std::vector<render_item> items;
+    /** Items owned by this packet; ignored while `shared_items` is set. */
+    render_draw_stream items;
+    /** Immutable stream shared with a persistent extractor instead of copied into `items`. */
+    std::shared_ptr<const render_draw_stream> shared_items;
+    render_item_delta item_delta;
+    /** Stable GPU Scene handle of each item, written by `gpu_scene::synchronize`. */
+    std::vector<gpu_scene_instance_handle> item_instances;
+    /** Sort key of each item, written by `prepare_render_world` for the items that survive culling. */
+    std::vector<std::uint64_t> sort_keys;
     std::vector<std::uint32_t> visible_items;
     std::vector<virtual_render_item> virtual_items;
     std::vector<std::uint32_t> visible_virtual_items;
@@ -515,6 +699,12 @@ struct render_world_packet
     std::uint32_t viewport_height{};
     std::size_t culled_item_count{};
     std::size_t culled_virtual_cluster_count{};
+
+    /** @return The shared item stream when set, otherwise `items`. */
+    [[nodiscard]] const render_draw_stream& item_stream() const noexcept
+    {
+        return shared_items ? *shared_items : items;
+    }
 };
 
 /**
@@ -529,6 +719,8 @@ struct render_world_prepare_options
     /** Build the allocating CPU reference output for validation of a GPU-driven view. */
     bool retain_cpu_reference{};
     std::uint32_t render_layer_mask{0xffffffffu};
+    /** Splits culling, sort-key generation, sorting, and batching into chunks across workers when set. */
+    jobs::job_system* jobs{};
 };
 
 /**
@@ -550,10 +742,32 @@ view_frustum make_view_frustum(const math::matrix4f& view_projection);
 [[nodiscard]] bool intersects(const view_frustum& frustum, const geometric::box3f& bounds);
 
 /**
- * @brief Build a material/mesh/depth sort key.
+ * @brief Test bounds `[first, first + count)` against a frustum, one packet of boxes per iteration.
+ *
+ * Writes one bit per box to `visibility`, bit `i % 64` of word `i / 64`, matching `intersects` for each box.
+ * `first` must be a multiple of 64; bits past the range in its last word are cleared.
+ */
+void cull_bounds(const view_frustum& frustum, const render_bounds_stream& bounds, std::size_t first,
+                 std::size_t count, std::span<std::uint64_t> visibility);
+
+/**
+ * @brief Build a 64-bit draw sort key whose ascending order is submission order.
+ *
+ * The pass occupies the top three bits, so each pass is its own key space. Opaque passes order by
+ * material index (22 bits), then mesh index (22 bits), then front-to-back depth (17 bits).
+ * `forward_transparent` orders back to front by the full 32-bit depth, with material and mesh bits as tie breakers.
  */
 std::uint64_t make_render_sort_key(scene_render_pass pass, material_handle material, mesh_handle mesh, float depth);
 
+/**
+ * @brief Sort `entries` by key with a stable least-significant-digit radix sort, one byte per pass.
+ *
+ * Bytes that are equal in every key are skipped. `scratch` must hold at least `entries.size()` elements. With a job
+ * system each pass's histogram and scatter run over chunks in parallel.
+ */
+void radix_sort_render_keys(std::span<render_sort_entry> entries, std::span<render_sort_entry> scratch,
+                            jobs::job_system* jobs = nullptr);
+
 /**
  * @brief Prepare CPU fallback draws, or clear them for an authoritative GPU-driven view.
  */
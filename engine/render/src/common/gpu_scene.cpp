@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <bit>
+#include <iterator>
 
 namespace arc::render
 {
@@ -136,8 +137,9 @@ gpu_scene_update_batch gpu_scene::synchronize(render_world_packet& packet, std::
     gpu_scene_update_batch batch{
         .frame_index = frame_index, .world_id = packet.gpu_scene_world_id, .world_epoch = packet.world_epoch};
     release_retired_slots(frame_index);
-    const auto previous_epoch = world_epochs_.find(packet.gpu_scene_world_id);
-    if (previous_epoch == world_epochs_.end() || previous_epoch->second != packet.world_epoch)
+    auto [found_world, new_world] = worlds_.try_emplace(packet.gpu_scene_world_id);
+    auto& world = found_world->second;
+    if (new_world || world.epoch != packet.world_epoch)
     {
         batch.updates.push_back({.kind = gpu_scene_update_kind::reset});
         for (std::uint32_t index = 0; index < slots_.size(); ++index)
@@ -145,7 +147,7 @@ gpu_scene_update_batch gpu_scene::synchronize(render_world_packet& packet, std::
             if (slots_[index].alive && slots_[index].key.world_id == packet.gpu_scene_world_id)
                 destroy_slot(index, frame_index, batch);
         }
-        world_epochs_[packet.gpu_scene_world_id] = packet.world_epoch;
+        world = {.epoch = packet.world_epoch};
     }
 
     const auto upsert = [&](const instance_key& key, gpu_scene_instance instance)
@@ -194,51 +196,102 @@ gpu_scene_update_batch gpu_scene::synchronize(render_world_packet& packet, std::
             batch.updates.push_back(
                 {.kind = gpu_scene_update_kind::upsert, .handle = handle, .dirty = dirty, .instance = instance});
         }
+        return handle;
     };
 
-    for (auto& item : packet.items)
+    const auto& items = packet.item_stream();
+    const auto upsert_item = [&](std::size_t index)
     {
+        const auto& item = items.details[index];
         const auto geometry_kind =
             item.skin_matrices.valid() ? gpu_scene_geometry_kind::skinned_mesh : gpu_scene_geometry_kind::mesh;
         const instance_key key{.world_id = packet.gpu_scene_world_id,
                                .object_id = item.object_id,
                                .geometry_kind = geometry_kind,
                                .submesh_or_cluster = item.submesh};
-        upsert(key, {.model = item.model,
-                     .previous_model = item.previous_model,
-                     .world_bounds = item.world_bounds,
-                     .mesh = item.mesh,
-                     .material = item.material,
-                     .skin_palette = item.skin_matrices,
-                     .skin_joint_count = item.skin_joint_count,
-                     .object_id = item.object_id,
-                     .submesh_or_cluster = item.submesh,
-                     .render_layer_mask = item.render_layer_mask,
-                     .flags = instance_flags(item.visible, item.selected, item.transparent, item.casts_shadows,
-                                             item.receives_shadows),
-                     .maximum_draw_distance = item.maximum_draw_distance,
-                     .geometry_error_scale = item.geometry_error_scale,
-                     .geometry_kind = geometry_kind});
-        item.gpu_scene_instance = {.index = lookup_.at(key), .generation = slots_[lookup_.at(key)].generation};
+        // A reused item index may now name another object; its previous slot must not linger.
+        const auto previous = world.item_slots[index];
+        if (find(previous) && slots_[previous.index].key != key)
+            destroy_slot(previous.index, frame_index, batch);
+        const auto handle =
+            upsert(key, {.model = item.model,
+                         .previous_model = item.previous_model,
+                         .world_bounds = items.world_bounds.box(index),
+                         .mesh = items.meshes[index],
+                         .material = items.materials[index],
+                         .skin_palette = item.skin_matrices,
+                         .skin_joint_count = item.skin_joint_count,
+                         .object_id = item.object_id,
+                         .submesh_or_cluster = item.submesh,
+                         .render_layer_mask = items.render_layer_masks[index],
+                         .flags = instance_flags(items.has(index, render_item_flag::visible),
+                                                 items.has(index, render_item_flag::selected),
+                                                 items.has(index, render_item_flag::transparent),
+                                                 items.has(index, render_item_flag::casts_shadows),
+                                                 items.has(index, render_item_flag::receives_shadows)),
+                         .maximum_draw_distance = item.maximum_draw_distance,
+                         .geometry_error_scale = item.geometry_error_scale,
+                         .geometry_kind = geometry_kind});
+        world.item_slots[index] = handle;
+        if (contains(slots_[handle.index].instance.flags, gpu_scene_instance_flag::recently_changed))
+            world.settling_items.push_back(static_cast<std::uint32_t>(index));
+    };
+
+    const auto& delta = packet.item_delta;
+    const bool incremental = delta.base_sequence != 0 && delta.base_sequence == world.item_sequence &&
+                             world.frame_index != frame_index && world.item_slots.size() <= items.size();
+    if (incremental)
+    {
+        // Items outside the delta are unchanged since the base packet, so only the edited items and the ones
+        // whose previous-frame state still has to settle are compared; the rest keep their slots as they are.
+        world.item_slots.resize(items.size());
+        for (const auto index : delta.removed_items)
+        {
+            auto& bound = world.item_slots[index];
+            if (find(bound)) destroy_slot(bound.index, frame_index, batch);
+            bound = {};
+        }
+        touched_items_.clear();
+        std::set_union(delta.changed_items.begin(), delta.changed_items.end(), world.settling_items.begin(),
+                       world.settling_items.end(), std::back_inserter(touched_items_));
+        world.settling_items.clear();
+        for (const auto index : touched_items_)
+        {
+            if (!items.has(index, render_item_flag::vacant)) upsert_item(index);
+        }
+    }
+    else
+    {
+        world.item_slots.assign(items.size(), {});
+        world.settling_items.clear();
+        for (std::size_t index = 0; index < items.size(); ++index)
+        {
+            if (!items.has(index, render_item_flag::vacant)) upsert_item(index);
+        }
     }
+    // The item stream may be shared with the extractor, so handles go to the packet's own table.
+    packet.item_instances.assign(world.item_slots.begin(), world.item_slots.end());
 
+    const auto previous_auxiliary = std::move(world.auxiliary_slots);
+    world.auxiliary_slots.clear();
     for (auto& item : packet.terrains)
     {
         const instance_key key{.world_id = packet.gpu_scene_world_id,
                                .object_id = item.object_id,
                                .geometry_kind = gpu_scene_geometry_kind::terrain,
                                .submesh_or_cluster = 0u};
-        upsert(key, {.model = item.model,
-                     .previous_model = item.previous_model,
-                     .world_bounds = item.world_bounds,
-                     .terrain = item.terrain,
-                     .material = item.material,
-                     .object_id = item.object_id,
-                     .render_layer_mask = item.render_layer_mask,
-                     .flags = instance_flags(true, item.selected, false, item.cast_shadows, item.receive_shadows),
-                     .geometry_error_scale = 1.0f,
-                     .geometry_kind = gpu_scene_geometry_kind::terrain});
-        item.gpu_scene_instance = {.index = lookup_.at(key), .generation = slots_[lookup_.at(key)].generation};
+        item.gpu_scene_instance =
+            upsert(key, {.model = item.model,
+                         .previous_model = item.previous_model,
+                         .world_bounds = item.world_bounds,
+                         .terrain = item.terrain,
+                         .material = item.material,
+                         .object_id = item.object_id,
+                         .render_layer_mask = item.render_layer_mask,
+                         .flags = instance_flags(true, item.selected, false, item.cast_shadows, item.receive_shadows),
+                         .geometry_error_scale = 1.0f,
+                         .geometry_kind = gpu_scene_geometry_kind::terrain});
+        world.auxiliary_slots.push_back(item.gpu_scene_instance.index);
     }
     for (auto& item : packet.virtual_items)
     {
@@ -246,29 +299,42 @@ gpu_scene_update_batch gpu_scene::synchronize(render_world_packet& packet, std::
                                .object_id = item.object_id,
                                .geometry_kind = gpu_scene_geometry_kind::virtual_mesh,
                                .submesh_or_cluster = item.root_node};
-        upsert(key,
-               {.model = item.model,
-                .previous_model = item.previous_model,
-                .world_bounds = item.world_bounds,
-                .virtual_mesh = item.mesh,
-                .material = item.material,
-                .object_id = item.object_id,
-                .submesh_or_cluster = item.root_node,
-                .render_layer_mask = item.render_layer_mask,
-                .flags = instance_flags(item.visible, item.selected, false, item.casts_shadows, item.receives_shadows),
-                .maximum_draw_distance = item.maximum_draw_distance,
-                .geometry_error_scale = item.geometry_error_scale,
-                .geometry_kind = gpu_scene_geometry_kind::virtual_mesh});
-        item.gpu_scene_instance = {.index = lookup_.at(key), .generation = slots_[lookup_.at(key)].generation};
+        item.gpu_scene_instance =
+            upsert(key, {.model = item.model,
+                         .previous_model = item.previous_model,
+                         .world_bounds = item.world_bounds,
+                         .virtual_mesh = item.mesh,
+                         .material = item.material,
+                         .object_id = item.object_id,
+                         .submesh_or_cluster = item.root_node,
+                         .render_layer_mask = item.render_layer_mask,
+                         .flags = instance_flags(item.visible, item.selected, false, item.casts_shadows,
+                                                 item.receives_shadows),
+                         .maximum_draw_distance = item.maximum_draw_distance,
+                         .geometry_error_scale = item.geometry_error_scale,
+                         .geometry_kind = gpu_scene_geometry_kind::virtual_mesh});
+        world.auxiliary_slots.push_back(item.gpu_scene_instance.index);
     }
 
-    for (std::uint32_t index = 0; index < slots_.size(); ++index)
+    const auto destroy_unseen = [&](std::uint32_t index)
     {
         const auto& candidate = slots_[index];
         if (candidate.alive && candidate.key.world_id == packet.gpu_scene_world_id &&
             candidate.last_seen_frame != frame_index)
             destroy_slot(index, frame_index, batch);
+    };
+    if (incremental)
+    {
+        for (const auto index : previous_auxiliary)
+            destroy_unseen(index);
+    }
+    else
+    {
+        for (std::uint32_t index = 0; index < slots_.size(); ++index)
+            destroy_unseen(index);
     }
+    world.frame_index = frame_index;
+    world.item_sequence = delta.sequence;
 
     batch.active_instance_count = active_instance_count_;
     batch.capacity = static_cast<std::uint32_t>(slots_.size());
@@ -287,7 +353,7 @@ void gpu_scene::reset()
     free_slots_.clear();
     retired_slots_.clear();
     lookup_.clear();
-    world_epochs_.clear();
+    worlds_.clear();
     active_instance_count_ = 0;
 }
 
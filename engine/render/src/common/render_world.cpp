@@ -1,8 +1,14 @@
 #include <arc/render/render_world.h>
 
+#include <arc/jobs/jobs.h>
+#include <arc/simd/simd.h>
+
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 
@@ -15,6 +21,17 @@ constexpr std::uint32_t maximum_gpu_scene_instances = 1u << 20u;
 constexpr std::uint32_t maximum_gpu_draw_bins = default_gpu_pipeline_bin_capacity;
 constexpr std::uint32_t gpu_scene_instance_stride = 224u;
 constexpr std::uint32_t indirect_command_stride = 20u;
+// Items per culling chunk, in whole visibility words; a chunk's bounds stream stays cache resident.
+constexpr std::size_t cull_chunk_words = 32u;
+constexpr std::size_t radix_buckets = 256u;
+// Entries per radix block; each block keeps its own histogram so parallel scatters stay stable.
+constexpr std::size_t radix_block_entries = 16384u;
+// Sorted items per batching block.
+constexpr std::size_t batch_block_items = 4096u;
+// Dead label bytes tolerated before a draw stream repacks its label table.
+constexpr std::size_t label_compaction_bytes = 4096u;
+
+using cull_packet = simd::simd<float, render_bounds_stream::packet_lanes>;
 
 frustum_plane normalize_plane(float x, float y, float z, float w)
 {
@@ -23,26 +40,80 @@ frustum_plane normalize_plane(float x, float y, float z, float w)
     return {.normal = math::vector3f{x / length, y / length, z / length}, .distance = w / length};
 }
 
-float item_depth(const render_world_packet& packet, const render_item& item)
+float bounds_depth(const render_world_packet& packet, const geometric::box3f& bounds)
 {
-    const auto center = geometric::center(item.world_bounds);
+    const auto center = geometric::center(bounds);
     const auto clip = math::transform_point(packet.camera.view_projection, center.as_vector());
     return clip[2];
 }
 
 float item_depth(const render_world_packet& packet, const virtual_render_item& item)
 {
-    const auto center = geometric::center(item.world_bounds);
-    const auto clip = math::transform_point(packet.camera.view_projection, center.as_vector());
-    return clip[2];
+    return bounds_depth(packet, item.world_bounds);
+}
+
+std::uint64_t batch_key(mesh_handle mesh, material_handle material)
+{
+    return (static_cast<std::uint64_t>(material.generation) << 48u) |
+           (static_cast<std::uint64_t>(material.index & 0xffffu) << 32u) |
+           (static_cast<std::uint64_t>(mesh.generation) << 16u) | static_cast<std::uint64_t>(mesh.index & 0xffffu);
+}
+
+// Calls body(block, first, last) for each fixed-size block of [0, count), spreading blocks across workers when a job
+// system is given. Block boundaries do not depend on scheduling, so per-block results can be combined in order.
+template <class Body>
+void for_each_block(jobs::job_system* jobs, std::size_t count, std::size_t block_size, const Body& body)
+{
+    const std::size_t block_count = (count + block_size - 1) / block_size;
+    const auto run = [&](std::size_t first_block, std::size_t last_block)
+    {
+        for (std::size_t block = first_block; block < last_block; ++block)
+            body(block, block * block_size, std::min(block * block_size + block_size, count));
+    };
+    if (jobs)
+        jobs->parallel_for(0, block_count, 1, run);
+    else
+        run(0, block_count);
+}
+
+// Maps a float onto an unsigned integer with the same ordering; NaN orders as zero.
+std::uint32_t ordered_depth_bits(float depth) noexcept
+{
+    const auto bits = std::bit_cast<std::uint32_t>(std::isnan(depth) ? 0.0f : depth);
+    return (bits & 0x80000000u) != 0u ? ~bits : bits | 0x80000000u;
 }
 
-std::uint64_t batch_key(const render_item& item)
+render_item_flag item_flags(const render_item& item) noexcept
 {
-    return (static_cast<std::uint64_t>(item.material.generation) << 48u) |
-           (static_cast<std::uint64_t>(item.material.index & 0xffffu) << 32u) |
-           (static_cast<std::uint64_t>(item.mesh.generation) << 16u) |
-           static_cast<std::uint64_t>(item.mesh.index & 0xffffu);
+    auto flags = render_item_flag::none;
+    if (item.visible) flags = flags | render_item_flag::visible;
+    if (item.selected) flags = flags | render_item_flag::selected;
+    if (item.transparent) flags = flags | render_item_flag::transparent;
+    if (item.casts_shadows) flags = flags | render_item_flag::casts_shadows;
+    if (item.receives_shadows) flags = flags | render_item_flag::receives_shadows;
+    if (item.affects_indirect_lighting) flags = flags | render_item_flag::affects_indirect_lighting;
+    if (item.visible_in_hardware_tracing) flags = flags | render_item_flag::visible_in_hardware_tracing;
+    return flags;
+}
+
+render_item_detail item_detail(const render_item& item) noexcept
+{
+    return {.submesh = item.submesh,
+            .model = item.model,
+            .previous_model = item.previous_model,
+            .object_id = item.object_id,
+            .skin_matrices = item.skin_matrices,
+            .skin_joint_count = item.skin_joint_count,
+            .instance_start = item.instance_start,
+            .instance_count = item.instance_count,
+            .mobility = item.mobility,
+            .shadow_lod_bias = item.shadow_lod_bias,
+            .maximum_shadow_distance = item.maximum_shadow_distance,
+            .maximum_draw_distance = item.maximum_draw_distance,
+            .geometry_error_scale = item.geometry_error_scale,
+            .surface_card_density_bias = item.surface_card_density_bias,
+            .distance_field_resolution_bias = item.distance_field_resolution_bias,
+            .base_color_tint = item.base_color_tint};
 }
 
 } // namespace
@@ -71,13 +142,308 @@ bool intersects(const view_frustum& frustum, const geometric::box3f& bounds)
     return true;
 }
 
+void render_bounds_stream::resize(std::size_t size)
+{
+    count = size;
+    const std::size_t padded = (size + packet_lanes - 1) / packet_lanes * packet_lanes;
+    for (auto* stream : {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z})
+        stream->resize(padded);
+}
+
+void render_bounds_stream::clear() noexcept
+{
+    count = 0;
+    for (auto* stream : {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z})
+        stream->clear();
+}
+
+void render_bounds_stream::push_back(const geometric::box3f& bounds)
+{
+    if (count == min_x.size())
+        for (auto* stream : {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z})
+            stream->resize(count + packet_lanes);
+    assign(count++, bounds);
+}
+
+geometric::box3f render_bounds_stream::box(std::size_t index) const noexcept
+{
+    return {{min_x[index], min_y[index], min_z[index]}, {max_x[index], max_y[index], max_z[index]}};
+}
+
+void render_bounds_stream::assign(std::size_t index, const geometric::box3f& bounds) noexcept
+{
+    min_x[index] = bounds.min[0];
+    min_y[index] = bounds.min[1];
+    min_z[index] = bounds.min[2];
+    max_x[index] = bounds.max[0];
+    max_y[index] = bounds.max[1];
+    max_z[index] = bounds.max[2];
+}
+
+void cull_bounds(const view_frustum& frustum, const render_bounds_stream& bounds, std::size_t first,
+                 std::size_t count, std::span<std::uint64_t> visibility)
+{
+    constexpr std::size_t lanes = render_bounds_stream::packet_lanes;
+    static_assert(64u % lanes == 0u);
+
+    // A plane's normal is shared by every lane, so the scalar test's per-axis choice of the
+    // positive vertex becomes a choice of stream made once per call.
+    struct packet_plane
+    {
+        const float* x;
+        const float* y;
+        const float* z;
+        cull_packet normal_x;
+        cull_packet normal_y;
+        cull_packet normal_z;
+        cull_packet distance;
+    };
+    std::array<packet_plane, 6> planes{};
+    for (std::size_t index = 0; index < planes.size(); ++index)
+    {
+        const auto& plane = frustum.planes[index];
+        planes[index] = {.x = (plane.normal[0] >= 0.0f ? bounds.max_x : bounds.min_x).data(),
+                         .y = (plane.normal[1] >= 0.0f ? bounds.max_y : bounds.min_y).data(),
+                         .z = (plane.normal[2] >= 0.0f ? bounds.max_z : bounds.min_z).data(),
+                         .normal_x = simd::fill<float, lanes>(plane.normal[0]),
+                         .normal_y = simd::fill<float, lanes>(plane.normal[1]),
+                         .normal_z = simd::fill<float, lanes>(plane.normal[2]),
+                         .distance = simd::fill<float, lanes>(plane.distance)};
+    }
+
+    const auto lane_bits = []
+    {
+        std::array<std::uint32_t, lanes> bits{};
+        for (std::size_t lane = 0; lane < lanes; ++lane)
+            bits[lane] = 1u << lane;
+        return simd::load_unaligned<std::uint32_t, lanes>(bits.data());
+    }();
+    const auto no_bits = simd::fill<std::uint32_t, lanes>(0u);
+    const auto zero = simd::fill<float, lanes>(0.0f);
+
+    const std::size_t last = first + count;
+    for (std::size_t word = first / 64u; word * 64u < last; ++word)
+    {
+        const std::size_t base = word * 64u;
+        std::uint64_t bits{};
+        for (std::size_t lane = 0; lane < 64u && base + lane < last; lane += lanes)
+        {
+            const std::size_t at = base + lane;
+            auto outside = simd::simd_mask<lanes>(false);
+            for (const auto& plane : planes)
+            {
+                const auto x = simd::load_unaligned<float, lanes>(plane.x + at);
+                const auto y = simd::load_unaligned<float, lanes>(plane.y + at);
+                const auto z = simd::load_unaligned<float, lanes>(plane.z + at);
+                const auto dot = simd::add(simd::add(simd::mul(plane.normal_x, x), simd::mul(plane.normal_y, y)),
+                                           simd::mul(plane.normal_z, z));
+                outside |= simd::cmp_lt(simd::add(dot, plane.distance), zero);
+            }
+            bits |= std::uint64_t{simd::sum(simd::select(outside, no_bits, lane_bits))} << lane;
+        }
+        if (last - base < 64u) bits &= (std::uint64_t{1} << (last - base)) - 1u;
+        visibility[word] = bits;
+    }
+}
+
+std::uint32_t render_draw_stream::push_back(const render_item& item)
+{
+    const auto index = static_cast<std::uint32_t>(meshes.size());
+    world_bounds.push_back(item.world_bounds);
+    meshes.push_back(item.mesh);
+    materials.push_back(item.material);
+    render_layer_masks.push_back(item.render_layer_mask);
+    flags.push_back(item_flags(item));
+    details.push_back(item_detail(item));
+    labels.push_back({.offset = static_cast<std::uint32_t>(label_data.size()),
+                      .size = static_cast<std::uint32_t>(item.label.size())});
+    label_data.append(item.label);
+    return index;
+}
+
+void render_draw_stream::assign(std::size_t index, const render_item& item)
+{
+    if (contains(flags[index], render_item_flag::vacant)) --vacancies;
+    world_bounds.assign(index, item.world_bounds);
+    meshes[index] = item.mesh;
+    materials[index] = item.material;
+    render_layer_masks[index] = item.render_layer_mask;
+    flags[index] = item_flags(item);
+    details[index] = item_detail(item);
+    auto& range = labels[index];
+    if (label(index) == item.label) return;
+    const auto size = static_cast<std::uint32_t>(item.label.size());
+    if (size <= range.size)
+    {
+        label_data.replace(range.offset, size, item.label);
+        dead_label_bytes += range.size - size;
+        range.size = size;
+    }
+    else
+    {
+        dead_label_bytes += range.size;
+        range = {.offset = static_cast<std::uint32_t>(label_data.size()), .size = size};
+        label_data.append(item.label);
+    }
+    if (dead_label_bytes > label_compaction_bytes && dead_label_bytes * 2u > label_data.size()) compact_labels();
+}
+
+void render_draw_stream::vacate(std::size_t index)
+{
+    if (contains(flags[index], render_item_flag::vacant)) return;
+    world_bounds.assign(index, {});
+    meshes[index] = {};
+    materials[index] = {};
+    render_layer_masks[index] = 0u;
+    flags[index] = render_item_flag::vacant;
+    details[index] = {};
+    dead_label_bytes += labels[index].size;
+    labels[index] = {};
+    ++vacancies;
+    if (dead_label_bytes > label_compaction_bytes && dead_label_bytes * 2u > label_data.size()) compact_labels();
+}
+
+void render_draw_stream::append(const render_draw_stream& other)
+{
+    const std::size_t first = size();
+    const auto label_base = static_cast<std::uint32_t>(label_data.size());
+    world_bounds.resize(first + other.size());
+    const auto& source = other.world_bounds;
+    for (const auto& [to, from] :
+         {std::pair{&world_bounds.min_x, &source.min_x}, std::pair{&world_bounds.min_y, &source.min_y},
+          std::pair{&world_bounds.min_z, &source.min_z}, std::pair{&world_bounds.max_x, &source.max_x},
+          std::pair{&world_bounds.max_y, &source.max_y}, std::pair{&world_bounds.max_z, &source.max_z}})
+        std::copy_n(from->begin(), other.size(), to->begin() + static_cast<std::ptrdiff_t>(first));
+    meshes.insert(meshes.end(), other.meshes.begin(), other.meshes.end());
+    materials.insert(materials.end(), other.materials.begin(), other.materials.end());
+    render_layer_masks.insert(render_layer_masks.end(), other.render_layer_masks.begin(),
+                              other.render_layer_masks.end());
+    flags.insert(flags.end(), other.flags.begin(), other.flags.end());
+    details.insert(details.end(), other.details.begin(), other.details.end());
+    labels.reserve(labels.size() + other.labels.size());
+    for (const auto label : other.labels)
+        labels.push_back({.offset = label_base + label.offset, .size = label.size});
+    label_data.append(other.label_data);
+    vacancies += other.vacancies;
+    dead_label_bytes += other.dead_label_bytes;
+}
+
+void render_draw_stream::compact_labels()
+{
+    std::string packed;
+    packed.reserve(label_data.size() - dead_label_bytes);
+    for (auto& range : labels)
+    {
+        const auto offset = static_cast<std::uint32_t>(packed.size());
+        packed.append(label_data, range.offset, range.size);
+        range.offset = range.size != 0u ? offset : 0u;
+    }
+    label_data = std::move(packed);
+    dead_label_bytes = 0;
+}
+
+void render_draw_stream::reserve(std::size_t capacity)
+{
+    for (auto* stream : {&world_bounds.min_x, &world_bounds.min_y, &world_bounds.min_z, &world_bounds.max_x,
+                         &world_bounds.max_y, &world_bounds.max_z})
+        stream->reserve((capacity + render_bounds_stream::packet_lanes - 1) / render_bounds_stream::packet_lanes *
+                        render_bounds_stream::packet_lanes);
+    meshes.reserve(capacity);
+    materials.reserve(capacity);
+    render_layer_masks.reserve(capacity);
+    flags.reserve(capacity);
+    details.reserve(capacity);
+    labels.reserve(capacity);
+}
+
+void render_draw_stream::clear()
+{
+    world_bounds.clear();
+    meshes.clear();
+    materials.clear();
+    render_layer_masks.clear();
+    flags.clear();
+    details.clear();
+    labels.clear();
+    label_data.clear();
+    vacancies = 0;
+    dead_label_bytes = 0;
+}
+
 std::uint64_t make_render_sort_key(scene_render_pass pass, material_handle material, mesh_handle mesh, float depth)
 {
-    const auto depth_bucket = static_cast<std::uint32_t>(std::clamp(depth, 0.0f, 1.0f) * 65535.0f);
-    return (static_cast<std::uint64_t>(pass) << 56u) | (static_cast<std::uint64_t>(material.index & 0xfffu) << 44u) |
-           (static_cast<std::uint64_t>(material.generation & 0xffu) << 36u) |
-           (static_cast<std::uint64_t>(mesh.index & 0xfffu) << 24u) |
-           (static_cast<std::uint64_t>(mesh.generation & 0xffu) << 16u) | depth_bucket;
+    const auto pass_bits = static_cast<std::uint64_t>(pass) << 61u;
+    if (pass == scene_render_pass::forward_transparent)
+    {
+        const auto descending_depth = ~ordered_depth_bits(depth);
+        return pass_bits | (static_cast<std::uint64_t>(descending_depth) << 29u) |
+               (static_cast<std::uint64_t>(material.index & 0x7fffu) << 14u) |
+               static_cast<std::uint64_t>(mesh.index & 0x3fffu);
+    }
+    const auto finite_depth = std::isfinite(depth) ? depth : 0.0f;
+    const auto depth_bucket = static_cast<std::uint32_t>(std::clamp(finite_depth, 0.0f, 1.0f) * 131071.0f);
+    return pass_bits | (static_cast<std::uint64_t>(material.index & 0x3fffffu) << 39u) |
+           (static_cast<std::uint64_t>(mesh.index & 0x3fffffu) << 17u) | depth_bucket;
+}
+
+void radix_sort_render_keys(std::span<render_sort_entry> entries, std::span<render_sort_entry> scratch,
+                            jobs::job_system* jobs)
+{
+    const std::size_t count = entries.size();
+    if (count < 2) return;
+
+    // A byte that is equal in every key leaves the order unchanged, so its pass is skipped.
+    struct key_bits
+    {
+        std::uint64_t any{};
+        std::uint64_t all{~std::uint64_t{}};
+    };
+    const auto fold = [&](std::size_t first, std::size_t last)
+    {
+        key_bits bits;
+        for (std::size_t index = first; index < last; ++index)
+        {
+            bits.any |= entries[index].key;
+            bits.all &= entries[index].key;
+        }
+        return bits;
+    };
+    const auto combine = [](key_bits lhs, key_bits rhs)
+    { return key_bits{.any = lhs.any | rhs.any, .all = lhs.all & rhs.all}; };
+    const auto bits =
+        jobs ? jobs->parallel_reduce(0, count, radix_block_entries, key_bits{}, fold, combine) : fold(0, count);
+    const std::uint64_t varying = bits.any ^ bits.all;
+
+    const std::size_t block_count = (count + radix_block_entries - 1) / radix_block_entries;
+    std::vector<std::array<std::uint32_t, radix_buckets>> offsets(block_count);
+    auto source = entries;
+    auto target = scratch.first(count);
+    for (std::uint32_t shift = 0; shift < 64u; shift += 8u)
+    {
+        if (((varying >> shift) & 0xffu) == 0u) continue;
+        for_each_block(jobs, count, radix_block_entries,
+                       [&](std::size_t block, std::size_t first, std::size_t last)
+                       {
+                           auto& histogram = offsets[block];
+                           histogram.fill(0u);
+                           for (std::size_t index = first; index < last; ++index)
+                               ++histogram[(source[index].key >> shift) & 0xffu];
+                       });
+        // Bucket-major, block-minor offsets keep equal digits in input order.
+        std::uint32_t position = 0;
+        for (std::size_t bucket = 0; bucket < radix_buckets; ++bucket)
+            for (auto& histogram : offsets)
+                position += std::exchange(histogram[bucket], position);
+        for_each_block(jobs, count, radix_block_entries,
+                       [&](std::size_t block, std::size_t first, std::size_t last)
+                       {
+                           auto& histogram = offsets[block];
+                           for (std::size_t index = first; index < last; ++index)
+                               target[histogram[(source[index].key >> shift) & 0xffu]++] = source[index];
+                       });
+        std::swap(source, target);
+    }
+    if (source.data() != entries.data()) std::copy(source.begin(), source.end(), entries.begin());
 }
 
 void prepare_render_world(render_world_packet& packet, const render_world_prepare_options& options)
@@ -95,22 +461,66 @@ void prepare_render_world(render_world_packet& packet, const render_world_prepar
     if (options.gpu_driven && !options.retain_cpu_reference) return;
 
     const auto frustum = make_view_frustum(packet.camera.view_projection);
-    for (std::uint32_t index = 0; index < packet.items.size(); ++index)
+    const auto& items = packet.item_stream();
+    const std::size_t item_count = items.size();
+    packet.sort_keys.assign(item_count, 0u);
+    const std::size_t visibility_words = (item_count + 63u) / 64u;
+    std::vector<std::uint64_t> visibility(visibility_words);
+    // Each chunk owns whole visibility words. Eligibility reads only the flag, mesh, and mask streams and
+    // culling reads the bounds streams in place; only the survivors are touched again for their sort keys.
+    const auto prepare_items = [&](std::size_t first_word, std::size_t last_word)
     {
-        auto& item = packet.items[index];
-        const bool layer_visible = (item.render_layer_mask & options.render_layer_mask) != 0;
-        const bool bounds_visible = !options.enable_frustum_culling || intersects(frustum, item.world_bounds);
-        if (!item.visible || !item.mesh.valid() || !layer_visible || !bounds_visible)
+        const std::size_t first = first_word * 64u;
+        const std::size_t last = std::min(last_word * 64u, item_count);
+        const std::span<std::uint64_t> words = std::span(visibility).subspan(first_word, last_word - first_word);
+        std::array<std::uint64_t, cull_chunk_words> eligible{};
+        for (std::size_t index = first; index < last; ++index)
         {
-            ++packet.culled_item_count;
-            continue;
+            const bool layer_visible = (items.render_layer_masks[index] & options.render_layer_mask) != 0;
+            if (items.has(index, render_item_flag::visible) && items.meshes[index].valid() && layer_visible)
+                eligible[(index - first) / 64u] |= std::uint64_t{1} << (index % 64u);
         }
+        if (options.enable_frustum_culling)
+            cull_bounds(frustum, items.world_bounds, first, last - first, visibility);
+        else
+            std::fill(words.begin(), words.end(), ~std::uint64_t{});
+        for (std::size_t word = 0; word < words.size(); ++word)
+        {
+            words[word] &= eligible[word];
+            for (std::uint64_t bits = words[word]; bits != 0; bits &= bits - 1u)
+            {
+                const std::size_t index = first + word * 64u + static_cast<std::size_t>(std::countr_zero(bits));
+                const auto pass = items.has(index, render_item_flag::transparent)
+                                      ? scene_render_pass::forward_transparent
+                                      : scene_render_pass::gbuffer;
+                packet.sort_keys[index] = make_render_sort_key(pass, items.materials[index], items.meshes[index],
+                                                               bounds_depth(packet, items.world_bounds.box(index)));
+            }
+        }
+    };
+    if (options.jobs)
+        options.jobs->parallel_for(0, visibility_words, cull_chunk_words, prepare_items);
+    else
+        for (std::size_t word = 0; word < visibility_words; word += cull_chunk_words)
+            prepare_items(word, std::min(word + cull_chunk_words, visibility_words));
 
-        const auto pass = item.transparent ? scene_render_pass::forward_transparent : scene_render_pass::gbuffer;
-        item.sort_key = make_render_sort_key(pass, item.material, item.mesh, item_depth(packet, item));
-        packet.visible_items.push_back(index);
-    }
+    std::size_t visible_count{};
+    for (const auto word : visibility)
+        visible_count += static_cast<std::size_t>(std::popcount(word));
+    packet.culled_item_count = item_count - items.vacancies - visible_count;
+    std::vector<render_sort_entry> order;
+    order.reserve(visible_count);
+    for (std::size_t word = 0; word < visibility_words; ++word)
+        for (std::uint64_t bits = visibility[word]; bits != 0; bits &= bits - 1u)
+        {
+            const auto index =
+                static_cast<std::uint32_t>(word * 64u) + static_cast<std::uint32_t>(std::countr_zero(bits));
+            order.push_back({.key = packet.sort_keys[index], .index = index});
+        }
+    std::vector<render_sort_entry> scratch(visible_count);
+    radix_sort_render_keys(order, scratch, options.jobs);
 
+    std::vector<render_sort_entry> virtual_order;
     for (std::uint32_t index = 0; index < packet.virtual_items.size(); ++index)
     {
         auto& item = packet.virtual_items[index];
@@ -124,68 +534,84 @@ void prepare_render_world(render_world_packet& packet, const render_world_prepar
 
         item.sort_key =
             make_render_sort_key(scene_render_pass::gbuffer, item.material, item.mesh, item_depth(packet, item));
-        packet.visible_virtual_items.push_back(index);
+        virtual_order.push_back({.key = item.sort_key, .index = index});
     }
+    scratch.resize(std::max(scratch.size(), virtual_order.size()));
+    radix_sort_render_keys(virtual_order, scratch, options.jobs);
+    packet.visible_virtual_items.reserve(virtual_order.size());
+    for (const auto& entry : virtual_order)
+        packet.visible_virtual_items.push_back(entry.index);
 
-    std::sort(packet.visible_items.begin(), packet.visible_items.end(),
-              [&](std::uint32_t lhs, std::uint32_t rhs)
-              {
-                  const auto& left = packet.items[lhs];
-                  const auto& right = packet.items[rhs];
-                  if (left.transparent != right.transparent) return !left.transparent;
-                  if (left.transparent) return item_depth(packet, left) > item_depth(packet, right);
-                  return left.sort_key < right.sort_key;
-              });
-
-    std::sort(packet.visible_virtual_items.begin(), packet.visible_virtual_items.end(),
-              [&](std::uint32_t lhs, std::uint32_t rhs)
-              {
-                  const auto& left = packet.virtual_items[lhs];
-                  const auto& right = packet.virtual_items[rhs];
-                  return left.sort_key < right.sort_key;
-              });
+    // Sorted runs of one mesh and material become instance batches. Each block counts the runs starting in it, then
+    // records their positions at its prefix offset, so batches come out in sorted order however blocks are scheduled.
+    packet.visible_items.resize(visible_count);
+    const auto starts_batch = [&](std::size_t position)
+    {
+        if (position == 0) return true;
+        const auto previous = order[position - 1].index;
+        const auto current = order[position].index;
+        return batch_key(items.meshes[previous], items.materials[previous]) !=
+               batch_key(items.meshes[current], items.materials[current]);
+    };
+    const std::size_t block_count = (visible_count + batch_block_items - 1) / batch_block_items;
+    std::vector<std::uint32_t> block_batches(block_count + 1);
+    for_each_block(options.jobs, visible_count, batch_block_items,
+                   [&](std::size_t block, std::size_t first, std::size_t last)
+                   {
+                       std::uint32_t starts{};
+                       for (std::size_t position = first; position < last; ++position)
+                       {
+                           packet.visible_items[position] = order[position].index;
+                           if (options.enable_instancing && starts_batch(position)) ++starts;
+                       }
+                       block_batches[block + 1] = starts;
+                   });
 
     if (options.enable_instancing)
     {
-        std::uint32_t batch_start = 0;
-        while (batch_start < packet.visible_items.size())
-        {
-            const auto first_item_index = packet.visible_items[batch_start];
-            const auto& first = packet.items[first_item_index];
-            const auto key = batch_key(first);
-            std::uint32_t batch_end = batch_start + 1;
-            while (batch_end < packet.visible_items.size() &&
-                   batch_key(packet.items[packet.visible_items[batch_end]]) == key)
-                ++batch_end;
-
-            packet.instance_batches.push_back(
-                {.mesh = first.mesh,
-                 .material = first.material,
-                 .pass = first.transparent ? scene_render_pass::forward_transparent : scene_render_pass::gbuffer,
-                 .first_item = batch_start,
-                 .item_count = batch_end - batch_start,
-                 .sort_key = first.sort_key});
-            batch_start = batch_end;
-        }
+        std::partial_sum(block_batches.begin(), block_batches.end(), block_batches.begin());
+        std::vector<std::uint32_t> batch_starts(block_batches.back());
+        for_each_block(options.jobs, visible_count, batch_block_items,
+                       [&](std::size_t block, std::size_t first, std::size_t last)
+                       {
+                           auto batch = block_batches[block];
+                           for (std::size_t position = first; position < last; ++position)
+                               if (starts_batch(position)) batch_starts[batch++] = static_cast<std::uint32_t>(position);
+                       });
+
+        packet.instance_batches.resize(batch_starts.size());
+        if (options.enable_indirect_draws) packet.indirect_draws.resize(batch_starts.size());
+        for_each_block(options.jobs, batch_starts.size(), batch_block_items,
+                       [&](std::size_t, std::size_t first, std::size_t last)
+                       {
+                           for (std::size_t batch = first; batch < last; ++batch)
+                           {
+                               const auto start = batch_starts[batch];
+                               const auto end = batch + 1 < batch_starts.size()
+                                                    ? batch_starts[batch + 1]
+                                                    : static_cast<std::uint32_t>(visible_count);
+                               const auto index = order[start].index;
+                               packet.instance_batches[batch] = {
+                                   .mesh = items.meshes[index],
+                                   .material = items.materials[index],
+                                   .pass = items.has(index, render_item_flag::transparent)
+                                               ? scene_render_pass::forward_transparent
+                                               : scene_render_pass::gbuffer,
+                                   .first_item = start,
+                                   .item_count = end - start,
+                                   .sort_key = order[start].key};
+                               if (options.enable_indirect_draws)
+                                   packet.indirect_draws[batch] = {
+                                       .index_count = 0, .instance_count = end - start, .first_instance = start};
+                           }
+                       });
     }
 
-    if (options.enable_indirect_draws)
+    if (options.enable_indirect_draws && packet.instance_batches.empty())
     {
-        packet.indirect_draws.reserve(packet.instance_batches.empty() ? packet.visible_items.size()
-                                                                      : packet.instance_batches.size());
-        if (!packet.instance_batches.empty())
-        {
-            for (const auto& batch : packet.instance_batches)
-            {
-                packet.indirect_draws.push_back(
-                    {.index_count = 0, .instance_count = batch.item_count, .first_instance = batch.first_item});
-            }
-        }
-        else
-        {
-            for (std::uint32_t index = 0; index < packet.visible_items.size(); ++index)
-                packet.indirect_draws.push_back({.instance_count = 1, .first_instance = index});
-        }
+        packet.indirect_draws.resize(visible_count);
+        for (std::uint32_t index = 0; index < visible_count; ++index)
+            packet.indirect_draws[index] = {.instance_count = 1, .first_instance = index};
     }
 }
 
@@ -1299,18 +1299,22 @@ render_submit_result renderer::render_frame(std::uint64_t frame_index, const ren
             resolved_config_.features.software_reflections || resolved_config_.features.hardware_gi ||
             resolved_config_.features.hardware_reflections)
         {
+            const auto& items = prepared->item_stream();
             std::vector<lighting_scene_instance> instances;
-            instances.reserve(prepared->items.size());
+            instances.reserve(items.size());
             std::uint32_t surface_card_count{};
             std::uint32_t surface_page_count{};
             std::uint32_t distance_field_page_count{};
             std::uint64_t resident_lighting_bytes{};
             std::unordered_set<std::uint64_t> counted_geometry;
-            for (const auto& item : prepared->items)
+            for (std::size_t index = 0; index < items.size(); ++index)
             {
-                if (!item.visible || item.transparent || item.skin_matrices.valid() || !item.affects_indirect_lighting)
+                const auto& item = items.details[index];
+                if (!items.has(index, render_item_flag::visible) || items.has(index, render_item_flag::transparent) ||
+                    item.skin_matrices.valid() || !items.has(index, render_item_flag::affects_indirect_lighting))
                     continue;
-                const auto geometry = lighting_geometry_for(item.mesh);
+                const auto mesh = items.meshes[index];
+                const auto geometry = lighting_geometry_for(mesh);
                 const auto* lighting_geometry = lighting_geometry_data_for(geometry);
                 if (!geometry.valid() || !lighting_geometry) continue;
                 if (counted_geometry.insert(renderer_resource_key(geometry)).second)
@@ -1333,19 +1337,19 @@ render_submit_result renderer::render_frame(std::uint64_t frame_index, const ren
                 const auto object_key = (static_cast<std::uint64_t>(item.object_id.generation) << 32u) |
                                         static_cast<std::uint64_t>(item.object_id.index);
                 instances.push_back(
-                    {.stable_id = object_key ^ (renderer_resource_key(item.mesh) * 0x9e3779b97f4a7c15ull),
+                    {.stable_id = object_key ^ (renderer_resource_key(mesh) * 0x9e3779b97f4a7c15ull),
                      .geometry = geometry,
-                     .material = item.material,
+                     .material = items.materials[index],
                      .model = item.model,
-                     .world_bounds = item.world_bounds,
+                     .world_bounds = items.world_bounds.box(index),
                      .transform_revision = transform_revision,
-                     .material_revision = renderer_resource_key(item.material),
+                     .material_revision = renderer_resource_key(items.materials[index]),
                      .geometry_generation = lighting_geometry->generation,
                      .card_density_bias = item.surface_card_density_bias,
                      .distance_field_resolution_bias = item.distance_field_resolution_bias,
                      .static_object = item.mobility == render_mobility::static_object,
-                     .affects_indirect_lighting = item.affects_indirect_lighting,
-                     .visible_in_hardware_tracing = item.visible_in_hardware_tracing});
+                     .affects_indirect_lighting = true,
+                     .visible_in_hardware_tracing = items.has(index, render_item_flag::visible_in_hardware_tracing)});
             }
             lighting_scene_updates.push_back(std::make_shared<lighting_scene_update_batch>(lighting_scene_.synchronize(
                 prepared->gpu_scene_world_id, prepared->world_epoch, frame_index, instances)));
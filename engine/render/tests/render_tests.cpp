@@ -3,6 +3,7 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <array>
 #include <cmath>
@@ -1044,6 +1045,224 @@ TEST_CASE("render world preparation culls sorts batches and emits indirect comma
     REQUIRE(packet.indirect_draws[0].instance_count == 2);
 }
 
+TEST_CASE("render draw stream splits items into hot streams, details, and a label table")
+{
+    arc::render::render_world_packet packet;
+    packet.camera.view_projection = arc::math::identity<float, 4>();
+    const auto box_at = [](float z)
+    {
+        return arc::geometric::box3f{arc::geometric::point3f{-0.1f, -0.1f, z - 0.1f},
+                                     arc::geometric::point3f{0.1f, 0.1f, z + 0.1f}};
+    };
+    packet.items.push_back({.mesh = {.index = 1, .generation = 1},
+                            .world_bounds = box_at(0.2f),
+                            .transparent = true,
+                            .label = "near glass"});
+    packet.items.push_back({.mesh = {.index = 1, .generation = 1},
+                            .world_bounds = box_at(0.0f),
+                            .object_id = {.index = 7, .generation = 2},
+                            .instance_count = 3,
+                            .casts_shadows = false});
+    packet.items.push_back({.mesh = {.index = 1, .generation = 1},
+                            .world_bounds = box_at(0.6f),
+                            .transparent = true,
+                            .label = "far glass"});
+
+    REQUIRE(packet.items.size() == 3);
+    REQUIRE(packet.items.label(0) == "near glass");
+    REQUIRE(packet.items.label(1).empty());
+    REQUIRE(packet.items.label(2) == "far glass");
+    REQUIRE(packet.items.details[1].object_id == arc::render::render_object_id{.index = 7, .generation = 2});
+    REQUIRE(packet.items.details[1].instance_count == 3);
+    REQUIRE_FALSE(packet.items.has(1, arc::render::render_item_flag::casts_shadows));
+    REQUIRE(packet.items.has(1, arc::render::render_item_flag::receives_shadows));
+    REQUIRE(packet.items.world_bounds.box(2).max[2] == Catch::Approx(0.7f));
+
+    arc::render::prepare_render_world(packet, {.enable_instancing = false});
+    REQUIRE(packet.visible_items == std::vector<std::uint32_t>{1, 2, 0});
+
+    packet.items.vacate(1);
+    packet.items.assign(2, {.mesh = {.index = 3, .generation = 1}, .world_bounds = box_at(0.4f), .label = "far glass"});
+    REQUIRE(packet.items.vacancies == 1);
+    REQUIRE(packet.items.has(1, arc::render::render_item_flag::vacant));
+    REQUIRE(packet.items.label(2) == "far glass");
+    REQUIRE(packet.items.meshes[2] == arc::render::mesh_handle{.index = 3, .generation = 1});
+    arc::render::prepare_render_world(packet, {.enable_instancing = false});
+    REQUIRE(packet.visible_items == std::vector<std::uint32_t>{2, 0});
+    REQUIRE(packet.culled_item_count == 0);
+
+    packet.items.clear();
+    REQUIRE(packet.items.empty());
+    REQUIRE(packet.items.world_bounds.size() == 0);
+    packet.items.push_back({.label = "again"});
+    REQUIRE(packet.items.label(0) == "again");
+}
+
+TEST_CASE("render world preparation culls packets of bounds like the per-box frustum test")
+{
+    arc::render::render_world_packet packet;
+    auto view_projection = arc::math::identity<float, 4>();
+    view_projection(0, 2) = 0.3f;
+    view_projection(1, 2) = -0.2f;
+    view_projection(3, 2) = 0.1f;
+    packet.camera.view_projection = view_projection;
+    std::uint32_t state = 12345u;
+    const auto next = [&state]
+    {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<float>(state >> 8u) / static_cast<float>(1u << 24u) * 6.0f - 3.0f;
+    };
+    for (std::uint32_t index = 0; index < 5000; ++index)
+    {
+        const arc::geometric::point3f min{next(), next(), next()};
+        const float size = std::abs(next()) * 0.25f;
+        packet.items.push_back({.mesh = {.index = index % 5 + 1, .generation = 1},
+                                .world_bounds = {min, {min[0] + size, min[1] + size, min[2] + size}},
+                                .visible = index % 11 != 0});
+    }
+
+    const auto frustum = arc::render::make_view_frustum(view_projection);
+    std::vector<std::uint32_t> expected;
+    for (std::uint32_t index = 0; index < packet.items.size(); ++index)
+        if (packet.items.has(index, arc::render::render_item_flag::visible) &&
+            arc::render::intersects(frustum, packet.items.world_bounds.box(index)))
+            expected.push_back(index);
+    REQUIRE(!expected.empty());
+    REQUIRE(expected.size() < packet.items.size() / 2u);
+
+    arc::render::render_bounds_stream bounds;
+    bounds.resize(packet.items.size());
+    for (std::size_t index = 0; index < packet.items.size(); ++index)
+        bounds.assign(index, packet.items.world_bounds.box(index));
+    std::vector<std::uint64_t> visibility((packet.items.size() + 63u) / 64u, ~std::uint64_t{});
+    arc::render::cull_bounds(frustum, bounds, 128, packet.items.size() - 128, visibility);
+    REQUIRE(visibility[0] == ~std::uint64_t{});
+    for (std::size_t index = 128; index < packet.items.size(); ++index)
+        REQUIRE(((visibility[index / 64u] >> (index % 64u)) & 1u) ==
+                (arc::render::intersects(frustum, packet.items.world_bounds.box(index)) ? 1u : 0u));
+    REQUIRE(visibility.back() >> (packet.items.size() % 64u) == 0u);
+
+    arc::jobs::job_system jobs(
+        {.worker_count = 2, .run_inline = false, .io_worker_count = 0, .enable_render_thread = false});
+    for (arc::jobs::job_system* scheduler : {static_cast<arc::jobs::job_system*>(nullptr), &jobs})
+    {
+        arc::render::prepare_render_world(packet, {.enable_instancing = false, .jobs = scheduler});
+        std::vector<std::uint32_t> visible = packet.visible_items;
+        std::sort(visible.begin(), visible.end());
+        REQUIRE(visible == expected);
+        REQUIRE(packet.culled_item_count == packet.items.size() - expected.size());
+    }
+}
+
+TEST_CASE("render sort keys separate pass key spaces and keep wide resource indices apart")
+{
+    using arc::render::make_render_sort_key;
+    using arc::render::scene_render_pass;
+    const arc::render::mesh_handle mesh{.index = 3, .generation = 1};
+    const auto opaque = [&](std::uint32_t material, float depth)
+    { return make_render_sort_key(scene_render_pass::gbuffer, {.index = material, .generation = 1}, mesh, depth); };
+    const auto transparent = [&](float depth)
+    {
+        return make_render_sort_key(scene_render_pass::forward_transparent, {.index = 1, .generation = 1}, mesh,
+                                    depth);
+    };
+
+    REQUIRE(opaque(5000u, 0.5f) != opaque(5000u + 4096u, 0.5f));
+    REQUIRE(opaque(5000u, 0.9f) < opaque(5000u + 4096u, 0.1f));
+    REQUIRE(opaque(7u, 0.1f) < opaque(7u, 0.9f));
+    REQUIRE(transparent(0.9f) < transparent(0.1f));
+    REQUIRE(transparent(0.5f) < transparent(0.5f - 1.0e-6f));
+    REQUIRE(transparent(-0.25f) > transparent(0.25f));
+    REQUIRE(opaque(0x3fffffu, 1.0f) < transparent(1.0e6f));
+}
+
+TEST_CASE("render key radix sort and parallel batching match the serial reference")
+{
+    std::uint64_t state = 0x2545f4914f6cdd1dull;
+    const auto next = [&state]
+    {
+        state ^= state << 13u;
+        state ^= state >> 7u;
+        state ^= state << 17u;
+        return state;
+    };
+    std::vector<arc::render::render_sort_entry> entries(70'000);
+    for (std::uint32_t index = 0; index < entries.size(); ++index)
+        entries[index] = {.key = (next() & 0xff00ff0000ffff0full) | 0x0100000000000000ull, .index = index};
+    auto expected = entries;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.key < rhs.key; });
+
+    arc::jobs::job_system jobs(
+        {.worker_count = 3, .run_inline = false, .io_worker_count = 0, .enable_render_thread = false});
+    for (arc::jobs::job_system* scheduler : {static_cast<arc::jobs::job_system*>(nullptr), &jobs})
+    {
+        auto sorted = entries;
+        std::vector<arc::render::render_sort_entry> scratch(sorted.size());
+        arc::render::radix_sort_render_keys(sorted, scratch, scheduler);
+        for (std::size_t position = 0; position < sorted.size(); ++position)
+        {
+            REQUIRE(sorted[position].key == expected[position].key);
+            REQUIRE(sorted[position].index == expected[position].index);
+        }
+    }
+
+    arc::render::render_world_packet packet;
+    packet.camera.view_projection = arc::math::identity<float, 4>();
+    for (std::uint32_t index = 0; index < 20'000; ++index)
+    {
+        const float z = static_cast<float>(next() % 1000u) / 1000.0f;
+        const auto mesh = static_cast<std::uint32_t>(next() % 3u) + 1u;
+        const auto material = static_cast<std::uint32_t>(next() % 5u) + 4094u;
+        packet.items.push_back({.mesh = {.index = mesh, .generation = 1},
+                                .material = {.index = material, .generation = 1},
+                                .world_bounds = {{-0.1f, -0.1f, z - 0.01f}, {0.1f, 0.1f, z + 0.01f}},
+                                .transparent = index % 7u == 0u});
+    }
+    arc::render::prepare_render_world(packet);
+    const auto visible = packet.visible_items;
+    const auto batches = packet.instance_batches;
+    const auto draws = packet.indirect_draws;
+    REQUIRE(visible.size() == packet.items.size());
+    REQUIRE(batches.size() > 15u);
+
+    std::uint32_t covered{};
+    for (const auto& batch : batches)
+    {
+        REQUIRE(batch.first_item == covered);
+        covered += batch.item_count;
+        for (std::uint32_t position = batch.first_item; position < batch.first_item + batch.item_count; ++position)
+        {
+            REQUIRE(packet.items.meshes[visible[position]] == batch.mesh);
+            REQUIRE(packet.items.materials[visible[position]] == batch.material);
+        }
+    }
+    REQUIRE(covered == visible.size());
+    for (std::size_t position = 1; position < visible.size(); ++position)
+    {
+        const bool previous_transparent =
+            packet.items.has(visible[position - 1], arc::render::render_item_flag::transparent);
+        const bool transparent = packet.items.has(visible[position], arc::render::render_item_flag::transparent);
+        REQUIRE((!previous_transparent || transparent));
+        if (previous_transparent)
+            REQUIRE(packet.items.world_bounds.box(visible[position - 1]).min[2] >=
+                    packet.items.world_bounds.box(visible[position]).min[2]);
+    }
+
+    arc::render::prepare_render_world(packet, {.jobs = &jobs});
+    REQUIRE(packet.visible_items == visible);
+    REQUIRE(packet.instance_batches.size() == batches.size());
+    REQUIRE(packet.indirect_draws.size() == draws.size());
+    for (std::size_t batch = 0; batch < batches.size(); ++batch)
+    {
+        REQUIRE(packet.instance_batches[batch].first_item == batches[batch].first_item);
+        REQUIRE(packet.instance_batches[batch].item_count == batches[batch].item_count);
+        REQUIRE(packet.instance_batches[batch].sort_key == batches[batch].sort_key);
+        REQUIRE(packet.indirect_draws[batch].instance_count == draws[batch].instance_count);
+        REQUIRE(packet.indirect_draws[batch].first_instance == draws[batch].first_instance);
+    }
+}
+
 TEST_CASE("GPU Scene keeps stable slots and emits precise incremental updates")
 {
     using namespace arc::render;
@@ -1065,9 +1284,9 @@ TEST_CASE("GPU Scene keeps stable slots and emits precise incremental updates")
     REQUIRE(handle.valid());
     REQUIRE(scene.find(handle) != nullptr);
 
-    auto moved = packet.items[0].model;
+    auto moved = packet.items.details[0].model;
     moved(0, 3) = 4.0f;
-    packet.items[0].model = moved;
+    packet.items.details[0].model = moved;
     const auto update = scene.synchronize(packet, 2);
     REQUIRE(update.updates.size() == 1);
     REQUIRE(update.updates[0].handle == handle);
@@ -1103,6 +1322,59 @@ TEST_CASE("GPU Scene keeps stable slots and emits precise incremental updates")
     REQUIRE(recycled_handle.generation != handle.generation);
 }
 
+TEST_CASE("GPU Scene applies item deltas without revisiting unchanged items")
+{
+    using namespace arc::render;
+    render_world_packet packet;
+    packet.gpu_scene_world_id = 23;
+    for (std::uint32_t index = 0; index < 3; ++index)
+        packet.items.push_back(
+            {.mesh = {.index = 1, .generation = 1}, .object_id = {.index = 50 + index, .generation = 1}});
+    packet.item_delta = {.sequence = 1};
+
+    gpu_scene scene;
+    const auto initial = scene.synchronize(packet, 1);
+    REQUIRE(initial.active_instance_count == 3);
+    const auto first = packet.item_instances[0];
+    const auto last = packet.item_instances[2];
+    packet.item_delta = {.base_sequence = 1, .sequence = 2};
+    REQUIRE(scene.synchronize(packet, 2).updates.size() == 3);
+
+    // Only listed items are compared, so an unlisted edit is trusted to be absent.
+    packet.items.details[1].model(0, 3) = 2.0f;
+    packet.items.details[2].model(1, 3) = 5.0f;
+    packet.item_delta = {.base_sequence = 2, .sequence = 3, .changed_items = {1}};
+    const auto moved = scene.synchronize(packet, 3);
+    REQUIRE(moved.updates.size() == 1);
+    REQUIRE(moved.updates[0].handle == packet.item_instances[1]);
+    REQUIRE(moved.updates[0].dirty == (gpu_scene_dirty::transform | gpu_scene_dirty::flags));
+    REQUIRE(contains(moved.updates[0].instance.flags, gpu_scene_instance_flag::recently_changed));
+    REQUIRE(packet.item_instances[2] == last);
+
+    packet.item_delta = {.base_sequence = 3, .sequence = 4};
+    const auto settled = scene.synchronize(packet, 4);
+    REQUIRE(settled.updates.size() == 1);
+    REQUIRE(settled.updates[0].dirty == (gpu_scene_dirty::transform | gpu_scene_dirty::flags));
+    REQUIRE_FALSE(contains(settled.updates[0].instance.flags, gpu_scene_instance_flag::recently_changed));
+
+    packet.items.vacate(0);
+    packet.item_delta = {.base_sequence = 4, .sequence = 5, .removed_items = {0}};
+    const auto removed = scene.synchronize(packet, 5);
+    REQUIRE(removed.active_instance_count == 2);
+    REQUIRE(removed.updates.size() == 1);
+    REQUIRE(removed.updates[0].kind == gpu_scene_update_kind::destroy);
+    REQUIRE(removed.updates[0].handle == first);
+    REQUIRE_FALSE(packet.item_instances[0].valid());
+
+    // A packet that does not continue the last synchronized one is reconciled in full.
+    packet.item_delta = {.base_sequence = 99, .sequence = 6};
+    const auto reconciled = scene.synchronize(packet, 6);
+    REQUIRE(reconciled.active_instance_count == 2);
+    REQUIRE(reconciled.updates.size() == 1);
+    REQUIRE(reconciled.updates[0].handle == last);
+    REQUIRE(reconciled.updates[0].dirty == (gpu_scene_dirty::transform | gpu_scene_dirty::flags));
+}
+
 TEST_CASE("GPU Scene represents skinned meshes and terrain without CPU patch expansion")
 {
     using namespace arc::render;
@@ -1118,9 +1390,9 @@ TEST_CASE("GPU Scene represents skinned meshes and terrain without CPU patch exp
     gpu_scene scene;
     const auto update = scene.synchronize(packet, 1);
     REQUIRE(update.active_instance_count == 2);
-    REQUIRE(packet.items[0].gpu_scene_instance.valid());
+    REQUIRE(packet.item_instances[0].valid());
     REQUIRE(packet.terrains[0].gpu_scene_instance.valid());
-    const auto* skinned = scene.find(packet.items[0].gpu_scene_instance);
+    const auto* skinned = scene.find(packet.item_instances[0]);
     const auto* terrain = scene.find(packet.terrains[0].gpu_scene_instance);
     REQUIRE(skinned != nullptr);
     REQUIRE(skinned->geometry_kind == gpu_scene_geometry_kind::skinned_mesh);
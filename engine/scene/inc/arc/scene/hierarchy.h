@@ -1,8 +1,11 @@
 #pragma once
 
 #include <arc/ecs/world.h>
+#include <arc/jobs/jobs.h>
 #include <arc/scene/components.h>
 
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace arc::scene
@@ -14,6 +17,118 @@ enum class reparent_transform_policy
     preserve_local
 };
 
+/**
+ * @brief Breadth-first snapshot of a world's transform hierarchy, reused across frames.
+ *
+ * Built on first use and rebuilt only after a structural change or a hierarchy link edit, so steady-state
+ * propagation touches the cached nodes without traversing links or looking components up.
+ */
+class transform_hierarchy_cache
+{
+public:
+    [[nodiscard]] std::size_t node_count() const noexcept
+    {
+        return nodes_.size();
+    }
+    [[nodiscard]] std::size_t depth_count() const noexcept
+    {
+        return levels_.empty() ? 0 : levels_.size() - 1;
+    }
+    void invalidate() noexcept
+    {
+        storage_id_ = 0;
+    }
+
+private:
+    static constexpr std::uint32_t no_parent = UINT32_MAX;
+
+    struct node
+    {
+        ecs::entity value{};
+        transform_component* transform{};
+        bounds_component* bounds{};
+        /** Nearest ancestor node that has a transform. */
+        std::uint32_t parent{no_parent};
+    };
+
+    [[nodiscard]] bool current(const ecs::world& scene) const noexcept;
+    void rebuild(ecs::world& scene);
+
+    std::vector<node> nodes_;
+    /** Level d occupies nodes_[levels_[d], levels_[d + 1]). */
+    std::vector<std::uint32_t> levels_;
+    std::vector<std::uint8_t> updated_;
+    std::vector<std::uint8_t> visited_;
+    std::uint64_t storage_id_{};
+    ecs::change_revision structural_revision_{};
+    ecs::change_revision hierarchy_revision_{};
+    friend void update_world_transforms(ecs::world&) noexcept;
+    friend void update_world_transforms(ecs::world&, transform_hierarchy_cache&, jobs::job_system*);
+};
+
+/**
+ * @brief Pre-order flattening of a world's hierarchy in which every subtree is one contiguous range.
+ *
+ * `refresh` only rebuilds after entity lifetime, hierarchy membership or link edits, so a batch of edits
+ * such as an import costs a single linear rebuild on the next query.
+ */
+class hierarchy_index
+{
+public:
+    void refresh(const ecs::world& scene);
+
+    /** Roots in `roots()` order, each followed by its subtree depth-first. */
+    [[nodiscard]] std::span<const ecs::entity> order() const noexcept
+    {
+        return order_;
+    }
+    [[nodiscard]] bool contains(ecs::entity value) const noexcept
+    {
+        return position(value) != npos;
+    }
+    /** `root` followed by all of its descendants; empty if `root` is not indexed. */
+    [[nodiscard]] std::span<const ecs::entity> subtree(ecs::entity root) const noexcept
+    {
+        const std::uint32_t begin = position(root);
+        if (begin == npos) return {};
+        return std::span<const ecs::entity>(order_).subspan(begin, subtree_end_[begin] - begin);
+    }
+    /** Number of ancestors; roots have depth zero. */
+    [[nodiscard]] std::uint32_t depth(ecs::entity value) const noexcept
+    {
+        const std::uint32_t found = position(value);
+        return found == npos ? 0 : depth_[found];
+    }
+    [[nodiscard]] bool is_descendant(ecs::entity candidate, ecs::entity ancestor) const noexcept
+    {
+        const std::uint32_t inner = position(candidate);
+        const std::uint32_t outer = position(ancestor);
+        return inner != npos && outer != npos && inner > outer && inner < subtree_end_[outer];
+    }
+
+private:
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+    [[nodiscard]] std::uint32_t position(ecs::entity value) const noexcept
+    {
+        if (value.index >= positions_.size()) return npos;
+        const std::uint32_t found = positions_[value.index];
+        return found != npos && order_[found] == value ? found : npos;
+    }
+    [[nodiscard]] bool current(const ecs::world& scene) noexcept;
+    void rebuild(const ecs::world& scene);
+
+    std::vector<ecs::entity> order_;
+    /** Per pre-order position: one past the last descendant, and the depth. */
+    std::vector<std::uint32_t> subtree_end_;
+    std::vector<std::uint32_t> depth_;
+    /** Pre-order position by entity index. */
+    std::vector<std::uint32_t> positions_;
+    std::uint64_t storage_id_{};
+    ecs::change_revision structural_revision_{};
+    ecs::change_revision hierarchy_revision_{};
+};
+
 [[nodiscard]] bool is_descendant(const ecs::world& scene, ecs::entity candidate, ecs::entity ancestor) noexcept;
 [[nodiscard]] std::vector<ecs::entity> roots(const ecs::world& scene);
 [[nodiscard]] std::vector<ecs::entity> children(const ecs::world& scene, ecs::entity parent);
@@ -23,7 +138,16 @@ bool reorder(ecs::world& scene, ecs::entity child, ecs::entity before_sibling =
 void detach(ecs::world& scene, ecs::entity child) noexcept;
 void mark_transform_subtree_dirty(ecs::world& scene, ecs::entity root) noexcept;
 void update_world_transforms(ecs::world& scene) noexcept;
+
+/**
+ * @brief Recompute world matrices for dirty transforms and their descendants only.
+ *
+ * Depth levels are processed in order; each level is split across `jobs` when given.
+ */
+void update_world_transforms(ecs::world& scene, transform_hierarchy_cache& cache, jobs::job_system* jobs = nullptr);
 [[nodiscard]] std::vector<ecs::entity> subtree(const ecs::world& scene, ecs::entity root);
 bool destroy_subtree(ecs::world& scene, ecs::entity root) noexcept;
+/** Destroys the indexed subtree of `root` as one range scan, refreshing `index` first. */
+bool destroy_subtree(ecs::world& scene, hierarchy_index& index, ecs::entity root) noexcept;
 
 } // namespace arc::scene
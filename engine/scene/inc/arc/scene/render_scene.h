@@ -4,9 +4,13 @@
 #include <arc/render/renderer.h>
 #include <arc/render/render_world.h>
 #include <arc/scene/components.h>
+#include <arc/scene/hierarchy.h>
 #include <arc/scene/terrain.h>
 
+#include <array>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace arc::scene
 {
@@ -56,6 +60,76 @@ struct scene_render_visibility
     bool water{true};
     bool vegetation{true};
     bool decals{true};
+
+    friend bool operator==(const scene_render_visibility&, const scene_render_visibility&) noexcept = default;
+};
+
+/**
+ * @brief Persistent mesh draw stream kept current from a world's change journals.
+ *
+ * Each extraction re-reads only entities whose render-relevant components changed, or were added or removed,
+ * since the previous one, and reports the rewritten item slots in the packet's item delta. Released items
+ * leave vacant slots that later items reuse, so item indices, and the GPU Scene slots bound to them, stay
+ * stable. Mesh renderers whose output depends on the camera or on streamed virtual geometry are re-read every
+ * frame. Component edits must go through tracked access (`get`, `try_get`, `mark_dirty`) to be seen. Packets
+ * share the stream rather than copy it; an extraction that edits it while an earlier packet still holds it
+ * copies it first, so a frame without changes costs nothing per item.
+ */
+class render_extraction_cache
+{
+public:
+    /**
+     * @brief Bring the cached stream up to date with `scene` and share it, with its edits, with `packet`.
+     *
+     * Virtual mesh instances are appended to `packet` directly; `packet.camera` must already be set.
+     */
+    void extract(const ecs::world& scene, const render::renderer& renderer, const scene_render_visibility& visibility,
+                 render::render_world_packet& packet, render_scene_result& result);
+
+    /** @return Number of occupied item slots. */
+    [[nodiscard]] std::size_t item_count() const noexcept
+    {
+        return items_->size() - items_->vacancies;
+    }
+    void invalidate() noexcept
+    {
+        storage_id_ = 0;
+    }
+
+private:
+    static constexpr std::uint32_t no_item = UINT32_MAX;
+    /** Components that each contribute at most one item per entity. */
+    static constexpr std::size_t source_count = 3;
+
+    struct entity_items
+    {
+        std::array<std::uint32_t, source_count> items{no_item, no_item, no_item};
+    };
+
+    void rebuild(const ecs::world& scene);
+    void collect_changes(const ecs::world& scene);
+    void mark(const ecs::world& scene, ecs::entity value);
+    void write(std::uint32_t& slot, const render::render_item* item);
+    /** @return The stream to edit, copied first if a packet still shares it. */
+    render::render_draw_stream& writable_items();
+
+    std::shared_ptr<render::render_draw_stream> items_ = std::make_shared<render::render_draw_stream>();
+    std::vector<std::uint32_t> free_items_;
+    /** Items owned by each entity, indexed by entity index. */
+    std::vector<entity_items> entities_;
+    /** Entities to re-read this extraction, and each one's position in `pending_` by entity index. */
+    std::vector<ecs::entity> pending_;
+    std::vector<std::uint32_t> pending_positions_;
+    /** Entities whose output cannot be cached and is re-read every extraction. */
+    std::vector<ecs::entity> volatile_entities_;
+    std::vector<std::uint32_t> changed_items_;
+    std::vector<std::uint32_t> removed_items_;
+    std::size_t selected_items_{};
+    std::uint64_t sequence_{};
+    std::uint64_t storage_id_{};
+    ecs::change_cursor cursor_{};
+    scene_render_visibility visibility_{};
+    bool virtual_geometry_{};
 };
 
 /** Prewarm all extraction queries so subsequent frames perform no query allocation. */
@@ -63,6 +137,10 @@ void prepare_render_scene_queries(ecs::world& scene);
 
 /**
  * @brief Extract visible scene renderers into renderer frame events.
+ *
+ * With a `transform_cache`, only dirty transform subtrees are propagated before extraction. With an
+ * `extraction_cache`, mesh items are updated from the world's change journals instead of rebuilt. With `jobs`,
+ * the component passes and chunks of the mesh passes run concurrently; the packet is the same either way.
  */
 render_scene_result
 render_scene(ecs::world& scene, render::renderer& renderer, std::uint32_t viewport_width, std::uint32_t viewport_height,
@@ -71,6 +149,8 @@ render_scene(ecs::world& scene, render::renderer& renderer, std::uint32_t viewpo
              render::editor_overlay_mode overlay = render::editor_overlay_mode::selected_wireframe,
              bool shadows_enabled = true, scene_render_visibility environment_visibility = {},
              float delta_seconds = 0.0f, render::debug_overlay_stream debug_overlay = {},
-             ecs::entity preferred_camera = {}, terrain_render_proxy_cache* terrain_proxies = nullptr);
+             ecs::entity preferred_camera = {}, terrain_render_proxy_cache* terrain_proxies = nullptr,
+             transform_hierarchy_cache* transform_cache = nullptr,
+             render_extraction_cache* extraction_cache = nullptr, jobs::job_system* jobs = nullptr);
 
 } // namespace arc::scene
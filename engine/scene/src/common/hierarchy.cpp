@@ -1,8 +1,11 @@
 #include <arc/scene/hierarchy.h>
 #include <arc/scene/transforms.h>
 
+#include <arc/simd/simd.h>
+
 #include <algorithm>
-#include <unordered_set>
+#include <iterator>
+#include <utility>
 
 namespace arc::scene
 {
@@ -28,29 +31,50 @@ void rebuild_root_links(ecs::world& scene, const std::vector<entity>& order)
     }
 }
 
-void update_subtree(ecs::world& scene, entity value, const math::matrix4f* parent_world,
-                    std::unordered_set<entity, ecs::entity_hash>& visited) noexcept
+static_assert(math::matrix4f::layout == math::matrix_layout::column_major);
+
+/** Column-major 4x4 product, one result column per SIMD register; matches `math::matmul` bit for bit. */
+math::matrix4f multiply(const math::matrix4f& lhs, const math::matrix4f& rhs) noexcept
 {
-    if (!scene.alive(value) || !visited.insert(value).second) return;
-    auto* transform = scene.try_get<transform_component>(value);
-    if (transform)
+    const float* a = lhs.data();
+    const float* b = rhs.data();
+    const simd::simd<float, 4> columns[4] = {
+        simd::load_unaligned<float, 4>(a), simd::load_unaligned<float, 4>(a + 4),
+        simd::load_unaligned<float, 4>(a + 8), simd::load_unaligned<float, 4>(a + 12)};
+    math::matrix4f result;
+    for (std::size_t column = 0; column < 4; ++column)
     {
-        const auto local = local_matrix(*transform);
-        transform->world = parent_world ? math::matmul(*parent_world, local) : local;
-        transform->dirty = false;
-        if (auto* bounds = scene.try_get<bounds_component>(value)) bounds->dirty = true;
-        parent_world = &transform->world;
+        const float* factors = b + column * 4;
+        auto sum = simd::mul(columns[0], simd::fill<float, 4>(factors[0]));
+        for (std::size_t k = 1; k < 4; ++k)
+            sum = simd::add(sum, simd::mul(columns[k], simd::fill<float, 4>(factors[k])));
+        simd::store_unaligned<float, 4>(result.data() + column * 4, sum);
     }
-    const auto* hierarchy = scene.try_get<hierarchy_component>(value);
-    entity child = hierarchy ? hierarchy->first_child : entity{};
-    std::unordered_set<entity, ecs::entity_hash> visited_siblings;
-    while (scene.alive(child) && visited_siblings.insert(child).second)
+    return result;
+}
+
+ecs::change_revision structural_revision(const ecs::world& scene) noexcept
+{
+    const auto changes = scene.structural_changes();
+    return changes.empty() ? ecs::change_revision{} : changes.back().revision;
+}
+
+/** World matrix of `value` composed from the local transforms of it and its ancestors, ignoring cached worlds. */
+math::matrix4f compose_world(const ecs::world& scene, entity value)
+{
+    std::vector<const transform_component*> chain;
+    entity current = value;
+    for (std::size_t steps = 0; steps <= scene.live_count() && scene.alive(current); ++steps)
     {
-        const auto* child_links = scene.try_get<hierarchy_component>(child);
-        const entity next = child_links ? child_links->next_sibling : entity{};
-        update_subtree(scene, child, parent_world, visited);
-        child = next;
+        if (const auto* transform = scene.try_get<transform_component>(current)) chain.push_back(transform);
+        const auto* hierarchy = scene.try_get<hierarchy_component>(current);
+        current = hierarchy ? hierarchy->parent : entity{};
     }
+    if (chain.empty()) return math::identity<float, 4>();
+    math::matrix4f world = local_matrix(*chain.back());
+    for (auto it = std::next(chain.rbegin()); it != chain.rend(); ++it)
+        world = multiply(world, local_matrix(**it));
+    return world;
 }
 
 } // namespace
@@ -58,9 +82,9 @@ void update_subtree(ecs::world& scene, entity value, const math::matrix4f* paren
 bool is_descendant(const ecs::world& scene, entity candidate, entity ancestor) noexcept
 {
     if (!scene.alive(candidate) || !scene.alive(ancestor)) return false;
+    // A well-formed chain is shorter than the live entity count, so the bound only trips on a cycle.
     entity current = candidate;
-    std::unordered_set<entity, ecs::entity_hash> visited;
-    while (scene.alive(current) && visited.insert(current).second)
+    for (std::size_t steps = 0; steps <= scene.live_count() && scene.alive(current); ++steps)
     {
         if (current == ancestor) return candidate != ancestor;
         const auto* hierarchy = scene.try_get<hierarchy_component>(current);
@@ -122,9 +146,12 @@ std::vector<entity> children(const ecs::world& scene, entity parent)
     std::vector<entity> result;
     const auto* hierarchy = scene.try_get<hierarchy_component>(parent);
     entity child = hierarchy ? hierarchy->first_child : entity{};
-    std::unordered_set<entity, ecs::entity_hash> visited;
-    while (scene.alive(child) && visited.insert(child).second)
+    std::vector<bool> visited;
+    while (scene.alive(child))
     {
+        if (child.index >= visited.size()) visited.resize(static_cast<std::size_t>(child.index) + 1u);
+        if (visited[child.index]) break;
+        visited[child.index] = true;
         result.push_back(child);
         const auto* links = scene.try_get<hierarchy_component>(child);
         child = links ? links->next_sibling : entity{};
@@ -141,6 +168,7 @@ void detach(ecs::world& scene, entity child) noexcept
     {
         auto& parent_links = links(scene, parent);
         if (parent_links.first_child == child) parent_links.first_child = child_links->next_sibling;
+        if (parent_links.last_child == child) parent_links.last_child = child_links->previous_sibling;
         if (parent_links.child_count > 0) --parent_links.child_count;
     }
     if (scene.alive(child_links->previous_sibling))
@@ -170,18 +198,18 @@ bool reparent(ecs::world& scene, entity child, entity parent, entity before_sibl
     bool has_preserved_transform{};
     if (policy == reparent_transform_policy::preserve_world && scene.has<transform_component>(child))
     {
-        update_world_transforms(scene);
-        preserved_local = scene.get<transform_component>(child).world;
+        // Only the two ancestor chains are composed; cached world matrices may be stale here.
+        preserved_local = compose_world(scene, child);
         entity transform_parent = parent;
         while (scene.alive(transform_parent) && !scene.has<transform_component>(transform_parent))
         {
             const auto* hierarchy = scene.try_get<hierarchy_component>(transform_parent);
             transform_parent = hierarchy ? hierarchy->parent : entity{};
         }
-        if (const auto* parent_transform = scene.try_get<transform_component>(transform_parent))
+        if (scene.alive(transform_parent))
         {
             math::matrix4f inverse_parent;
-            if (!inverse_affine(parent_transform->world, inverse_parent)) return false;
+            if (!inverse_affine(compose_world(scene, transform_parent), inverse_parent)) return false;
             preserved_local = math::matmul(inverse_parent, preserved_local);
         }
         if (!decompose_trs(preserved_local, preserved_transform)) return false;
@@ -209,18 +237,28 @@ bool reparent(ecs::world& scene, entity child, entity parent, entity before_sibl
         else if (!scene.alive(parent_links.first_child))
         {
             parent_links.first_child = child;
+            parent_links.last_child = child;
         }
         else
         {
-            entity last = parent_links.first_child;
-            while (scene.alive(links(scene, last).next_sibling))
-                last = links(scene, last).next_sibling;
+            entity last = parent_links.last_child;
+            const auto* last_links = std::as_const(scene).try_get<hierarchy_component>(last);
+            if (!scene.alive(last) || !last_links || last_links->parent != parent ||
+                scene.alive(last_links->next_sibling))
+            {
+                // Links written before last_child was maintained; walk once and cache the tail below.
+                last = parent_links.first_child;
+                while (scene.alive(links(scene, last).next_sibling))
+                    last = links(scene, last).next_sibling;
+            }
             links(scene, last).next_sibling = child;
             child_links.previous_sibling = last;
+            parent_links.last_child = child;
         }
     }
     else
     {
+        // Unlinked roots only have a place in `roots()` order, so link every root into one chain.
         auto order = roots(scene);
         order.erase(std::remove(order.begin(), order.end(), child), order.end());
         const auto before = std::find(order.begin(), order.end(), before_sibling);
@@ -256,9 +294,122 @@ void mark_transform_subtree_dirty(ecs::world& scene, entity root) noexcept
 
 void update_world_transforms(ecs::world& scene) noexcept
 {
-    std::unordered_set<entity, ecs::entity_hash> visited;
-    for (const entity value : roots(scene))
-        update_subtree(scene, value, nullptr, visited);
+    transform_hierarchy_cache cache;
+    cache.rebuild(scene);
+    for (const auto& node : cache.nodes_)
+        node.transform->dirty = true;
+    update_world_transforms(scene, cache);
+}
+
+bool transform_hierarchy_cache::current(const ecs::world& scene) const noexcept
+{
+    return storage_id_ == scene.storage_id() && structural_revision_ == structural_revision(scene) &&
+           hierarchy_revision_ == scene.last_change(ecs::component_type<hierarchy_component>());
+}
+
+void transform_hierarchy_cache::rebuild(ecs::world& scene)
+{
+    // Only const lookups here: caching addresses must not record component changes.
+    const ecs::world& view = scene;
+    nodes_.clear();
+    levels_.assign(1, 0);
+    visited_.assign(visited_.size(), 0);
+    const auto enqueue = [this](entity value) noexcept
+    {
+        if (value.index >= visited_.size()) visited_.resize(static_cast<std::size_t>(value.index) + 1u);
+        return !std::exchange(visited_[value.index], std::uint8_t{1});
+    };
+    std::vector<entity> frontier;
+    std::vector<std::uint32_t> frontier_parents;
+    for (const entity value : roots(view))
+    {
+        if (!enqueue(value)) continue;
+        frontier.push_back(value);
+        frontier_parents.push_back(no_parent);
+    }
+
+    std::vector<entity> next;
+    std::vector<std::uint32_t> next_parents;
+    while (!frontier.empty())
+    {
+        next.clear();
+        next_parents.clear();
+        for (std::size_t index = 0; index < frontier.size(); ++index)
+        {
+            const entity value = frontier[index];
+            std::uint32_t parent = frontier_parents[index];
+            if (const auto* transform = view.try_get<transform_component>(value))
+            {
+                nodes_.push_back({value, const_cast<transform_component*>(transform),
+                                  const_cast<bounds_component*>(view.try_get<bounds_component>(value)), parent});
+                parent = static_cast<std::uint32_t>(nodes_.size() - 1);
+            }
+            const auto* hierarchy = view.try_get<hierarchy_component>(value);
+            entity child = hierarchy ? hierarchy->first_child : entity{};
+            while (view.alive(child) && enqueue(child))
+            {
+                next.push_back(child);
+                next_parents.push_back(parent);
+                const auto* links = view.try_get<hierarchy_component>(child);
+                child = links ? links->next_sibling : entity{};
+            }
+        }
+        levels_.push_back(static_cast<std::uint32_t>(nodes_.size()));
+        frontier.swap(next);
+        frontier_parents.swap(next_parents);
+    }
+
+    storage_id_ = scene.storage_id();
+    structural_revision_ = structural_revision(scene);
+    hierarchy_revision_ = scene.last_change(ecs::component_type<hierarchy_component>());
+}
+
+void update_world_transforms(ecs::world& scene, transform_hierarchy_cache& cache, jobs::job_system* jobs)
+{
+    using node = transform_hierarchy_cache::node;
+    if (!cache.current(scene)) cache.rebuild(scene);
+    auto& nodes = cache.nodes_;
+    auto& updated = cache.updated_;
+    updated.assign(nodes.size(), 0);
+
+    // A node is recomputed when its own transform is dirty or its transform parent was recomputed this pass.
+    const auto propagate = [&](std::size_t begin, std::size_t end) noexcept
+    {
+        for (std::size_t index = begin; index < end; ++index)
+        {
+            const node& current = nodes[index];
+            const bool has_parent = current.parent != transform_hierarchy_cache::no_parent;
+            if (!current.transform->dirty && !(has_parent && updated[current.parent])) continue;
+            const auto local = local_matrix(*current.transform);
+            current.transform->world = has_parent ? multiply(nodes[current.parent].transform->world, local) : local;
+            current.transform->dirty = false;
+            updated[index] = 1;
+        }
+    };
+
+    constexpr std::size_t parallel_level_size = 1024;
+    constexpr std::size_t batch_size = 256;
+    for (std::size_t level = 0; level + 1 < cache.levels_.size(); ++level)
+    {
+        const std::size_t begin = cache.levels_[level];
+        const std::size_t end = cache.levels_[level + 1];
+        if (jobs && end - begin >= parallel_level_size)
+            jobs->parallel_for(begin, end, batch_size, propagate);
+        else
+            propagate(begin, end);
+    }
+
+    // Change tracking is not thread-safe, so record the results after the parallel levels.
+    for (std::size_t index = 0; index < nodes.size(); ++index)
+    {
+        if (!updated[index]) continue;
+        scene.mark_dirty<transform_component>(nodes[index].value);
+        if (nodes[index].bounds)
+        {
+            nodes[index].bounds->dirty = true;
+            scene.mark_dirty<bounds_component>(nodes[index].value);
+        }
+    }
 }
 
 std::vector<entity> subtree(const ecs::world& scene, entity root)
@@ -266,12 +417,21 @@ std::vector<entity> subtree(const ecs::world& scene, entity root)
     std::vector<entity> result;
     if (!scene.alive(root)) return result;
     result.push_back(root);
-    std::unordered_set<entity, ecs::entity_hash> visited{root};
+    std::vector<bool> visited(static_cast<std::size_t>(root.index) + 1u);
+    visited[root.index] = true;
     for (std::size_t index = 0; index < result.size(); ++index)
     {
-        const auto nested = arc::scene::children(scene, result[index]);
-        for (const entity value : nested)
-            if (visited.insert(value).second) result.push_back(value);
+        const auto* hierarchy = scene.try_get<hierarchy_component>(result[index]);
+        entity child = hierarchy ? hierarchy->first_child : entity{};
+        while (scene.alive(child))
+        {
+            if (child.index >= visited.size()) visited.resize(static_cast<std::size_t>(child.index) + 1u);
+            if (visited[child.index]) break;
+            visited[child.index] = true;
+            result.push_back(child);
+            const auto* links = scene.try_get<hierarchy_component>(child);
+            child = links ? links->next_sibling : entity{};
+        }
     }
     return result;
 }
@@ -286,4 +446,107 @@ bool destroy_subtree(ecs::world& scene, entity root) noexcept
     return true;
 }
 
+bool destroy_subtree(ecs::world& scene, hierarchy_index& index, entity root) noexcept
+{
+    index.refresh(scene);
+    const auto values = index.subtree(root);
+    if (values.empty()) return false;
+    arc::scene::detach(scene, root);
+    // Pre-order reversed visits every child before its parent; the span stays valid until the next refresh.
+    for (auto it = values.rbegin(); it != values.rend(); ++it)
+        scene.destroy(*it);
+    return true;
+}
+
+void hierarchy_index::refresh(const ecs::world& scene)
+{
+    if (!current(scene)) rebuild(scene);
+}
+
+bool hierarchy_index::current(const ecs::world& scene) noexcept
+{
+    const ecs::change_revision hierarchy = scene.last_change(ecs::component_type<hierarchy_component>());
+    if (storage_id_ != scene.storage_id() || hierarchy_revision_ != hierarchy) return false;
+
+    // Structural changes that cannot affect the hierarchy are skipped without rebuilding.
+    const auto changes = scene.structural_changes();
+    auto pending = std::upper_bound(changes.begin(), changes.end(), structural_revision_,
+                                    [](ecs::change_revision revision, const ecs::structural_change& change)
+                                    { return revision < change.revision; });
+    for (; pending != changes.end(); ++pending)
+    {
+        if (pending->kind == ecs::structural_change_kind::entity_created ||
+            pending->kind == ecs::structural_change_kind::entity_destroyed ||
+            pending->component == ecs::component_type<hierarchy_component>())
+            return false;
+    }
+    structural_revision_ = structural_revision(scene);
+    return true;
+}
+
+void hierarchy_index::rebuild(const ecs::world& scene)
+{
+    order_.clear();
+    depth_.clear();
+    positions_.assign(positions_.size(), npos);
+    const auto visit = [this](entity value) noexcept
+    {
+        if (value.index >= positions_.size()) positions_.resize(static_cast<std::size_t>(value.index) + 1u, npos);
+        if (positions_[value.index] != npos) return false;
+        positions_[value.index] = static_cast<std::uint32_t>(order_.size());
+        return true;
+    };
+
+    // Depth-first with an explicit stack; siblings are pushed in reverse so they pop in link order.
+    std::vector<std::pair<entity, std::uint32_t>> pending;
+    std::vector<entity> siblings;
+    const auto push_chain = [&](entity first, std::uint32_t depth)
+    {
+        siblings.clear();
+        for (entity value = first; scene.alive(value);)
+        {
+            if (value.index < positions_.size() && positions_[value.index] != npos) break;
+            siblings.push_back(value);
+            if (siblings.size() > scene.live_count()) break;
+            const auto* links = scene.try_get<hierarchy_component>(value);
+            value = links ? links->next_sibling : entity{};
+        }
+        for (auto it = siblings.rbegin(); it != siblings.rend(); ++it)
+            pending.emplace_back(*it, depth);
+    };
+
+    const auto root_values = roots(scene);
+    for (auto it = root_values.rbegin(); it != root_values.rend(); ++it)
+        pending.emplace_back(*it, 0u);
+    while (!pending.empty())
+    {
+        const auto [value, depth] = pending.back();
+        pending.pop_back();
+        if (!visit(value)) continue;
+        order_.push_back(value);
+        depth_.push_back(depth);
+        const auto* links = scene.try_get<hierarchy_component>(value);
+        if (links) push_chain(links->first_child, depth + 1);
+    }
+
+    // A subtree ends at the next position whose depth is not greater than its root's.
+    subtree_end_.resize(order_.size());
+    std::vector<std::uint32_t> open;
+    for (std::uint32_t position = 0; position < order_.size(); ++position)
+    {
+        while (!open.empty() && depth_[open.back()] >= depth_[position])
+        {
+            subtree_end_[open.back()] = position;
+            open.pop_back();
+        }
+        open.push_back(position);
+    }
+    for (const std::uint32_t position : open)
+        subtree_end_[position] = static_cast<std::uint32_t>(order_.size());
+
+    storage_id_ = scene.storage_id();
+    structural_revision_ = structural_revision(scene);
+    hierarchy_revision_ = scene.last_change(ecs::component_type<hierarchy_component>());
+}
+
 } // namespace arc::scene
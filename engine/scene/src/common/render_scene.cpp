@@ -8,8 +8,13 @@
 #include <arc/scene/transforms.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
 
 namespace arc::scene
 {
@@ -24,10 +29,15 @@ bool entity_is_active(const ecs::world& scene, entity value)
     return !active || active->active;
 }
 
-std::string entity_label(const ecs::world& scene, entity value)
+std::string_view entity_name(const ecs::world& scene, entity value)
 {
     const auto* name = scene.try_get<name_component>(value);
-    return name ? name->value : std::string{};
+    return name ? std::string_view(name->value) : std::string_view{};
+}
+
+std::string entity_label(const ecs::world& scene, entity value)
+{
+    return std::string(entity_name(scene, value));
 }
 
 std::uint32_t render_layer_mask(const ecs::world& scene, entity value)
@@ -84,50 +94,55 @@ render::render_mobility entity_mobility(const ecs::world& scene, entity value) n
     return render::render_mobility::movable;
 }
 
-void append_mesh_item(ecs::world& scene, render::render_world_packet& packet, render_scene_result& result, entity value,
-                      const transform_component& transform, render::mesh_handle mesh, render::material_handle material,
-                      bool visible, bool transparent = false, render::buffer_handle skin = {},
-                      std::uint32_t joint_count = 0, std::uint32_t instance_count = 1,
-                      const math::vector4f& base_color_tint = math::vector4f::one, bool casts_shadows = true,
-                      bool receives_shadows = true, float shadow_lod_bias = 0.0f, float maximum_shadow_distance = 0.0f,
-                      bool affects_indirect_lighting = true, float surface_card_density_bias = 0.0f,
-                      float distance_field_resolution_bias = 0.0f, bool visible_in_hardware_tracing = true)
+render::render_item mesh_item(const ecs::world& scene, entity value, const transform_component& transform,
+                              render::mesh_handle mesh, render::material_handle material, bool visible,
+                              bool transparent = false, render::buffer_handle skin = {}, std::uint32_t joint_count = 0,
+                              std::uint32_t instance_count = 1,
+                              const math::vector4f& base_color_tint = math::vector4f::one, bool casts_shadows = true,
+                              bool receives_shadows = true, float shadow_lod_bias = 0.0f,
+                              float maximum_shadow_distance = 0.0f, bool affects_indirect_lighting = true,
+                              float surface_card_density_bias = 0.0f, float distance_field_resolution_bias = 0.0f,
+                              bool visible_in_hardware_tracing = true)
 {
-    if (!entity_is_active(scene, value)) return;
+    const math::matrix4f world = transform.dirty ? local_matrix(transform) : transform.world;
+    return {.mesh = mesh,
+            .material = material,
+            .model = world,
+            .previous_model = world,
+            .world_bounds = world_bounds_for(scene, value, transform),
+            .render_layer_mask = render_layer_mask(scene, value),
+            .object_id = render::make_render_object_id(value.index, value.generation),
+            .skin_matrices = skin,
+            .skin_joint_count = joint_count,
+            .instance_count = instance_count,
+            .visible = visible,
+            .selected = entity_selected(scene, value),
+            .transparent = transparent,
+            .casts_shadows = casts_shadows,
+            .receives_shadows = receives_shadows,
+            .mobility = entity_mobility(scene, value),
+            .shadow_lod_bias = shadow_lod_bias,
+            .maximum_shadow_distance = maximum_shadow_distance,
+            .affects_indirect_lighting = affects_indirect_lighting,
+            .surface_card_density_bias = surface_card_density_bias,
+            .distance_field_resolution_bias = distance_field_resolution_bias,
+            .visible_in_hardware_tracing = visible_in_hardware_tracing,
+            .base_color_tint = base_color_tint,
+            .label = entity_name(scene, value)};
+}
 
+void append_mesh_item(render::render_draw_stream& items, render_scene_result& result,
+                      const std::optional<render::render_item>& item)
+{
+    if (!item) return;
     ++result.renderable_count;
-    const bool selected = entity_selected(scene, value);
-    if (selected) ++result.selected_count;
+    if (item->selected) ++result.selected_count;
+    items.push_back(*item);
+}
 
-    const math::matrix4f world = transform.dirty ? local_matrix(transform) : transform.world;
-    packet.items.push_back({.mesh = mesh,
-                            .material = material,
-                            .model = world,
-                            .previous_model = world,
-                            .world_bounds = world_bounds_for(scene, value, transform),
-                            .render_layer_mask = render_layer_mask(scene, value),
-                            .object_id = render::make_render_object_id(value.index, value.generation),
-                            .skin_matrices = skin,
-                            .skin_joint_count = joint_count,
-                            .instance_count = instance_count,
-                            .visible = visible,
-                            .selected = selected,
-                            .transparent = transparent,
-                            .casts_shadows = casts_shadows,
-                            .receives_shadows = receives_shadows,
-                            .mobility = entity_mobility(scene, value),
-                            .shadow_lod_bias = shadow_lod_bias,
-                            .maximum_shadow_distance = maximum_shadow_distance,
-                            .affects_indirect_lighting = affects_indirect_lighting,
-                            .surface_card_density_bias = surface_card_density_bias,
-                            .distance_field_resolution_bias = distance_field_resolution_bias,
-                            .visible_in_hardware_tracing = visible_in_hardware_tracing,
-                            .base_color_tint = base_color_tint,
-                            .label = entity_label(scene, value)});
-}
-
-void append_virtual_mesh_items(ecs::world& scene, render::renderer& renderer, render::render_world_packet& packet,
-                               render_scene_result& result, entity value, const transform_component& transform,
+void append_virtual_mesh_items(const ecs::world& scene, const render::renderer& renderer,
+                               std::vector<render::virtual_render_item>& virtual_items, render_scene_result& result,
+                               entity value, const transform_component& transform,
                                const mesh_renderer_component& mesh_renderer)
 {
     if (!entity_is_active(scene, value)) return;
@@ -143,7 +158,7 @@ void append_virtual_mesh_items(ecs::world& scene, render::renderer& renderer, re
 
     const math::matrix4f world = transform.dirty ? local_matrix(transform) : transform.world;
     const auto object = render::make_render_object_id(value.index, value.generation);
-    packet.virtual_items.push_back(
+    virtual_items.push_back(
         {.mesh = mesh_renderer.mesh.virtualized,
          .material = mesh_renderer.material,
          .root_node = mesh->root_nodes.size() == 1 ? mesh->root_nodes.front() : render::invalid_virtual_geometry_index,
@@ -210,6 +225,151 @@ render::mesh_handle select_cooked_lod(const render::geometry_resource_handle& ge
     return geometry.select_conventional_lod(std::max(0.0f, error_threshold) * distance / projection_scale);
 }
 
+// Output that depends on the camera or on virtual geometry streaming cannot be kept between extractions.
+bool mesh_renderer_volatile(const render::renderer& renderer, const mesh_renderer_component& mesh_renderer)
+{
+    return mesh_renderer.mesh.conventional_lod_count > 1 ||
+           (mesh_renderer.representation != render::geometry_representation_policy::conventional &&
+            renderer.resolved_config().features.virtual_geometry);
+}
+
+// Returns the conventional item for a mesh renderer; virtual instances are appended to `virtual_items` directly.
+std::optional<render::render_item>
+mesh_renderer_item(const ecs::world& scene, const render::renderer& renderer, const render::render_camera& camera,
+                   std::vector<render::virtual_render_item>& virtual_items, render_scene_result& result,
+                   const scene_render_visibility& visibility, entity value, const transform_component& transform,
+                   const mesh_renderer_component& mesh_renderer)
+{
+    bool transparent{};
+    if (!environment_mesh_visible(scene, value, visibility, transparent)) return std::nullopt;
+    const bool may_virtualize = mesh_renderer.representation != render::geometry_representation_policy::conventional;
+    if (!transparent && may_virtualize && renderer.resolved_config().features.virtual_geometry &&
+        renderer.virtual_mesh_alive(mesh_renderer.mesh.virtualized))
+    {
+        append_virtual_mesh_items(scene, renderer, virtual_items, result, value, transform, mesh_renderer);
+        return std::nullopt;
+    }
+    if (!entity_is_active(scene, value)) return std::nullopt;
+    render::mesh_handle mesh =
+        select_cooked_lod(mesh_renderer.mesh, camera, world_bounds_for(scene, value, transform),
+                          renderer.resolved_config().geometry_error_threshold);
+    auto material = mesh_renderer.material;
+    if (mesh_renderer.mesh.conventional_lod_count <= 1) apply_lod(scene, value, mesh, material);
+    return mesh_item(scene, value, transform, mesh, material, mesh_renderer.visible, transparent, {}, 0, 1,
+                     mesh_renderer.base_color_tint, mesh_renderer.casts_shadows, mesh_renderer.receives_shadows,
+                     mesh_renderer.shadow_lod_bias, mesh_renderer.maximum_shadow_distance,
+                     mesh_renderer.affects_indirect_lighting, mesh_renderer.surface_card_density_bias,
+                     mesh_renderer.distance_field_resolution_bias, mesh_renderer.visible_in_hardware_tracing);
+}
+
+std::optional<render::render_item> skinned_mesh_item(const ecs::world& scene, entity value,
+                                                     const transform_component& transform,
+                                                     const skinned_mesh_renderer_component& mesh_renderer)
+{
+    if (!entity_is_active(scene, value)) return std::nullopt;
+    return mesh_item(scene, value, transform, mesh_renderer.mesh, mesh_renderer.material, mesh_renderer.visible, false,
+                     mesh_renderer.skin_matrices, mesh_renderer.joint_count, 1, math::vector4f::one,
+                     mesh_renderer.casts_shadows, mesh_renderer.receives_shadows, mesh_renderer.shadow_lod_bias,
+                     mesh_renderer.maximum_shadow_distance);
+}
+
+std::optional<render::render_item> instance_group_item(const ecs::world& scene, entity value,
+                                                       const transform_component& transform,
+                                                       const instance_group_component& instances)
+{
+    if (!entity_is_active(scene, value)) return std::nullopt;
+    return mesh_item(scene, value, transform, instances.mesh, instances.material, instances.visible, false, {}, 0,
+                     instances.instance_count);
+}
+
+enum class mesh_source : std::uint8_t
+{
+    mesh_renderer,
+    skinned_mesh_renderer,
+    instance_group
+};
+
+// A run of one mesh pass's entities extracted by a single job into its own streams.
+struct mesh_extraction_chunk
+{
+    mesh_source source{};
+    std::span<const entity> entities;
+    render::render_draw_stream items;
+    std::vector<render::virtual_render_item> virtual_items;
+    render_scene_result result{};
+};
+
+constexpr std::size_t mesh_extraction_chunk_size = 1024;
+
+// Chunks are cut from the prepared query's entity list, so the split, and the merged order, is the same every run.
+template <class Component>
+void append_mesh_chunks(const ecs::world& scene, mesh_source source, std::vector<mesh_extraction_chunk>& chunks)
+{
+    scene.view<transform_component, Component>().entities().for_each_span(
+        [&](std::span<const entity> values)
+        {
+            for (std::size_t first = 0; first < values.size(); first += mesh_extraction_chunk_size)
+                chunks.push_back(
+                    {.source = source,
+                     .entities = values.subspan(first, std::min(mesh_extraction_chunk_size, values.size() - first))});
+        });
+}
+
+// Appends the items of one chunk's entities to `items`, which is the chunk's own stream or, serially, the packet's.
+void extract_mesh_chunk(const ecs::world& scene, const render::renderer& renderer, const render::render_camera& camera,
+                        const scene_render_visibility& visibility, const mesh_extraction_chunk& chunk,
+                        render::render_draw_stream& items, std::vector<render::virtual_render_item>& virtual_items,
+                        render_scene_result& result)
+{
+    for (const auto value : chunk.entities)
+    {
+        const auto& transform = *scene.try_get<transform_component>(value);
+        switch (chunk.source)
+        {
+        case mesh_source::mesh_renderer:
+            append_mesh_item(items, result,
+                             mesh_renderer_item(scene, renderer, camera, virtual_items, result, visibility, value,
+                                                transform, *scene.try_get<mesh_renderer_component>(value)));
+            break;
+        case mesh_source::skinned_mesh_renderer:
+            append_mesh_item(
+                items, result,
+                skinned_mesh_item(scene, value, transform, *scene.try_get<skinned_mesh_renderer_component>(value)));
+            break;
+        case mesh_source::instance_group:
+            append_mesh_item(
+                items, result,
+                instance_group_item(scene, value, transform, *scene.try_get<instance_group_component>(value)));
+            break;
+        }
+    }
+}
+
+std::uint64_t next_item_sequence() noexcept
+{
+    static std::atomic<std::uint64_t> sequence{};
+    return sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Visits every component whose edits can change the items extracted for an entity.
+template <class Function> void for_each_item_component(const Function& function)
+{
+    function(std::type_identity<transform_component>{});
+    function(std::type_identity<bounds_component>{});
+    function(std::type_identity<mesh_renderer_component>{});
+    function(std::type_identity<skinned_mesh_renderer_component>{});
+    function(std::type_identity<instance_group_component>{});
+    function(std::type_identity<lod_component>{});
+    function(std::type_identity<name_component>{});
+    function(std::type_identity<active_component>{});
+    function(std::type_identity<selection_component>{});
+    function(std::type_identity<render_layer_component>{});
+    function(std::type_identity<mobility_component>{});
+    function(std::type_identity<terrain_component>{});
+    function(std::type_identity<water_component>{});
+    function(std::type_identity<vegetation_component>{});
+}
+
 render::cloud_layer_data to_render_cloud_layer(const cloud_layer_settings& layer)
 {
     return {.enabled = layer.enabled,
@@ -330,8 +490,418 @@ render::world_environment_data to_render_environment(const ecs::world& scene, en
     return output;
 }
 
+void extract_waters(const ecs::world& scene, const scene_render_visibility& visibility,
+                    render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, water_component>().each(
+        [&](entity value, const transform_component& transform, const water_component& water)
+        {
+            if (!visibility.water || !entity_is_active(scene, value) || !water.enabled) return;
+            packet.waters.push_back({.object_id = render::make_render_object_id(value.index, value.generation),
+                                     .position = transform.position,
+                                     .size = water.size,
+                                     .color = water.color,
+                                     .roughness = water.roughness,
+                                     .wave_scale = water.wave_scale,
+                                     .wave_speed = water.wave_speed,
+                                     .transparency = water.transparency,
+                                     .label = entity_label(scene, value)});
+            ++result.water_count;
+        });
+}
+
+void extract_vegetation(const ecs::world& scene, const scene_render_visibility& visibility,
+                        render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, vegetation_component>().each(
+        [&](entity value, const transform_component& transform, const vegetation_component& vegetation)
+        {
+            if (!visibility.vegetation || !entity_is_active(scene, value) || !vegetation.enabled) return;
+            packet.vegetation.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .position = transform.position,
+                 .density = vegetation.density,
+                 .patch_size = vegetation.patch_size,
+                 .color = vegetation.color,
+                 .wind_strength = vegetation.wind_strength,
+                 .wind_speed = vegetation.wind_speed,
+                 .cast_shadows = vegetation.cast_shadows,
+                 .shadow_lod_bias = vegetation.shadow_lod_bias,
+                 .maximum_shadow_distance = vegetation.maximum_shadow_distance,
+                 .label = entity_label(scene, value)});
+            ++result.vegetation_count;
+            result.vegetation_instance_count += vegetation.density;
+        });
+}
+
+void extract_decals(const ecs::world& scene, const scene_render_visibility& visibility,
+                    render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, decal_component>().each(
+        [&](entity value, const transform_component& transform, const decal_component& decal)
+        {
+            if (!visibility.decals || !entity_is_active(scene, value) || !decal.enabled) return;
+            const math::matrix4f world = transform.dirty ? local_matrix(transform) : transform.world;
+            packet.decals.push_back({.object_id = render::make_render_object_id(value.index, value.generation),
+                                     .model = world,
+                                     .world_bounds = world_bounds_for(scene, value, transform),
+                                     .color = decal.color,
+                                     .texture = decal.texture,
+                                     .opacity = decal.opacity,
+                                     .label = entity_label(scene, value)});
+            ++result.decal_count;
+        });
+}
+
+void extract_directional_lights(const ecs::world& scene, const scene_render_visibility&,
+                                render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, directional_light_component>().each(
+        [&](entity value, const transform_component& transform, const directional_light_component& light)
+        {
+            if (!entity_is_active(scene, value) || !light.enabled) return;
+            packet.directional_lights.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .direction = world_forward_direction(transform),
+                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
+                 .intensity = light.intensity,
+                 .casts_shadows = light.casts_shadows,
+                 .enabled = light.enabled,
+                 .use_color_temperature = light.use_color_temperature,
+                 .temperature_kelvin = light.temperature_kelvin,
+                 .intensity_unit = light.intensity_unit,
+                 .cookie_texture = light.cookie_texture,
+                 .shadow = light.shadow,
+                 .cascades = light.cascades,
+                 .mobility = entity_mobility(scene, value),
+                 .label = entity_label(scene, value)});
+            ++result.directional_light_count;
+        });
+}
+
+void extract_point_lights(const ecs::world& scene, const scene_render_visibility&,
+                          render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, point_light_component>().each(
+        [&](entity value, const transform_component& transform, const point_light_component& light)
+        {
+            if (!entity_is_active(scene, value) || !light.enabled) return;
+            packet.point_lights.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .position = world_position(transform),
+                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
+                 .intensity = light.intensity,
+                 .range = light.range,
+                 .casts_shadows = light.casts_shadows,
+                 .enabled = light.enabled,
+                 .use_color_temperature = light.use_color_temperature,
+                 .temperature_kelvin = light.temperature_kelvin,
+                 .intensity_unit = light.intensity_unit,
+                 .cookie_texture = light.cookie_texture,
+                 .shadow = light.shadow,
+                 .mobility = entity_mobility(scene, value),
+                 .label = entity_label(scene, value)});
+            ++result.point_light_count;
+        });
+}
+
+void extract_spot_lights(const ecs::world& scene, const scene_render_visibility&,
+                         render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, spot_light_component>().each(
+        [&](entity value, const transform_component& transform, const spot_light_component& light)
+        {
+            if (!entity_is_active(scene, value) || !light.enabled) return;
+            packet.spot_lights.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .position = world_position(transform),
+                 .direction = world_forward_direction(transform),
+                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
+                 .intensity = light.intensity,
+                 .range = light.range,
+                 .inner_angle = light.inner_angle,
+                 .outer_angle = light.outer_angle,
+                 .casts_shadows = light.casts_shadows,
+                 .enabled = light.enabled,
+                 .use_color_temperature = light.use_color_temperature,
+                 .temperature_kelvin = light.temperature_kelvin,
+                 .intensity_unit = light.intensity_unit,
+                 .cookie_texture = light.cookie_texture,
+                 .shadow = light.shadow,
+                 .mobility = entity_mobility(scene, value),
+                 .label = entity_label(scene, value)});
+            ++result.spot_light_count;
+        });
+}
+
+void extract_area_lights(const ecs::world& scene, const scene_render_visibility&,
+                         render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, area_light_component>().each(
+        [&](entity value, const transform_component& transform, const area_light_component& light)
+        {
+            if (!entity_is_active(scene, value) || !light.enabled) return;
+            const auto direction = world_forward_direction(transform);
+            const auto up = world_up_direction(transform);
+            const auto tangent = math::normalize(math::cross(direction, up));
+            packet.area_lights.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .position = world_position(transform),
+                 .direction = direction,
+                 .tangent = tangent,
+                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
+                 .intensity = light.intensity,
+                 .width = light.width,
+                 .height = light.height,
+                 .shape = light.shape,
+                 .two_sided = light.two_sided,
+                 .casts_shadows = light.casts_shadows,
+                 .enabled = light.enabled,
+                 .use_color_temperature = light.use_color_temperature,
+                 .temperature_kelvin = light.temperature_kelvin,
+                 .intensity_unit = light.intensity_unit,
+                 .shadow = light.shadow,
+                 .mobility = entity_mobility(scene, value),
+                 .label = entity_label(scene, value)});
+            ++result.area_light_count;
+        });
+}
+
+void extract_reflection_probes(const ecs::world& scene, const scene_render_visibility&,
+                               render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, reflection_probe_component>().each(
+        [&](entity value, const transform_component& transform, const reflection_probe_component& probe)
+        {
+            if (!entity_is_active(scene, value) || !probe.enabled) return;
+            packet.reflection_probes.push_back({.position = transform.position,
+                                                .box_extents = probe.box_extents,
+                                                .radius = probe.radius,
+                                                .blend_distance = probe.blend_distance,
+                                                .intensity = probe.intensity,
+                                                .priority = probe.priority,
+                                                .cubemap = probe.cubemap,
+                                                .resolution = probe.resolution,
+                                                .shape = static_cast<std::uint8_t>(probe.shape),
+                                                .update_policy = static_cast<std::uint8_t>(probe.update_policy),
+                                                .label = entity_label(scene, value)});
+            ++result.reflection_probe_count;
+        });
+}
+
+void extract_irradiance_probes(const ecs::world& scene, const scene_render_visibility&,
+                               render::render_world_packet& packet, render_scene_result& result)
+{
+    scene.view<transform_component, irradiance_probe_component>().each(
+        [&](entity value, const transform_component& transform, const irradiance_probe_component& probe)
+        {
+            if (!entity_is_active(scene, value) || !probe.enabled) return;
+            packet.irradiance_probes.push_back({.position = transform.position,
+                                                .radius = probe.radius,
+                                                .visibility = probe.visibility,
+                                                .intensity = probe.intensity,
+                                                .priority = probe.priority,
+                                                .spherical_harmonics = probe.spherical_harmonics,
+                                                .label = entity_label(scene, value)});
+            ++result.irradiance_probe_count;
+        });
+}
+
+void extract_baked_lighting(const ecs::world& scene, const scene_render_visibility&,
+                            render::render_world_packet& packet, render_scene_result&)
+{
+    scene.view<baked_lighting_component>().each(
+        [&](entity value, const baked_lighting_component& baked)
+        {
+            if (!entity_is_active(scene, value) || !baked.enabled) return;
+            packet.baked_lighting.push_back(
+                {.object_id = render::make_render_object_id(value.index, value.generation),
+                 .lightmap = baked.lightmap,
+                 .directional_lightmap = baked.directional_lightmap,
+                 .uv_channel = baked.uv_channel,
+                 .scale_offset = baked.scale_offset,
+                 .intensity = baked.intensity});
+        });
+}
+
+// Passes other than the mesh passes; each writes only its own packet stream and result counters.
+using extraction_pass = void (*)(const ecs::world&, const scene_render_visibility&, render::render_world_packet&,
+                                 render_scene_result&);
+constexpr std::array<extraction_pass, 10> extraction_passes{
+    &extract_waters, &extract_vegetation, &extract_decals, &extract_directional_lights, &extract_point_lights,
+    &extract_spot_lights, &extract_area_lights, &extract_reflection_probes, &extract_irradiance_probes,
+    &extract_baked_lighting};
+
 } // namespace
 
+void render_extraction_cache::extract(const ecs::world& scene, const render::renderer& renderer,
+                                      const scene_render_visibility& visibility,
+                                      render::render_world_packet& packet, render_scene_result& result)
+{
+    const ecs::change_cursor cursor{scene.revision()};
+    const bool virtual_geometry = renderer.resolved_config().features.virtual_geometry;
+    const bool current = storage_id_ == scene.storage_id() && cursor_.revision <= cursor.revision &&
+                         visibility_ == visibility && virtual_geometry_ == virtual_geometry;
+    changed_items_.clear();
+    removed_items_.clear();
+    if (current)
+    {
+        for (const auto value : volatile_entities_)
+            mark(scene, value);
+        collect_changes(scene);
+    }
+    else
+    {
+        rebuild(scene);
+    }
+    volatile_entities_.clear();
+
+    // Entity order, not journal order, decides which free slot each new item takes.
+    std::sort(pending_.begin(), pending_.end(), [](entity lhs, entity rhs) { return lhs.index < rhs.index; });
+    for (const auto value : pending_)
+    {
+        pending_positions_[value.index] = no_item;
+        if (value.index >= entities_.size()) entities_.resize(static_cast<std::size_t>(value.index) + 1u);
+        std::array<std::optional<render::render_item>, source_count> produced{};
+        bool is_volatile{};
+        const auto* transform = scene.alive(value) ? scene.try_get<transform_component>(value) : nullptr;
+        if (transform)
+        {
+            if (const auto* mesh_renderer = scene.try_get<mesh_renderer_component>(value))
+            {
+                is_volatile = mesh_renderer_volatile(renderer, *mesh_renderer);
+                produced[0] = mesh_renderer_item(scene, renderer, packet.camera, packet.virtual_items, result,
+                                                 visibility, value, *transform, *mesh_renderer);
+            }
+            if (const auto* mesh_renderer = scene.try_get<skinned_mesh_renderer_component>(value))
+                produced[1] = skinned_mesh_item(scene, value, *transform, *mesh_renderer);
+            if (const auto* instances = scene.try_get<instance_group_component>(value))
+                produced[2] = instance_group_item(scene, value, *transform, *instances);
+        }
+        auto& owned = entities_[value.index].items;
+        for (std::size_t source = 0; source < source_count; ++source)
+            write(owned[source], produced[source] ? &*produced[source] : nullptr);
+        if (is_volatile) volatile_entities_.push_back(value);
+    }
+    pending_.clear();
+    std::sort(changed_items_.begin(), changed_items_.end());
+    std::sort(removed_items_.begin(), removed_items_.end());
+
+    const auto sequence = next_item_sequence();
+    packet.shared_items = items_;
+    packet.item_delta = {.base_sequence = current ? sequence_ : 0u,
+                         .sequence = sequence,
+                         .changed_items = changed_items_,
+                         .removed_items = removed_items_};
+    result.renderable_count += item_count();
+    result.selected_count += selected_items_;
+
+    sequence_ = sequence;
+    storage_id_ = scene.storage_id();
+    cursor_ = cursor;
+    visibility_ = visibility;
+    virtual_geometry_ = virtual_geometry;
+    // Compact once holes dominate; the GPU Scene maps the rebuilt items back onto the same slots.
+    if (items_->vacancies > 1024u && items_->vacancies * 2u > items_->size()) invalidate();
+}
+
+void render_extraction_cache::rebuild(const ecs::world& scene)
+{
+    // A packet may still share the old stream; start a new one instead of copying what is about to be cleared.
+    if (items_.use_count() > 1)
+        items_ = std::make_shared<render::render_draw_stream>();
+    else
+        writable_items().clear();
+    free_items_.clear();
+    entities_.clear();
+    volatile_entities_.clear();
+    selected_items_ = 0;
+    const auto add = [&](entity value, const transform_component&, const auto&) { mark(scene, value); };
+    scene.view<transform_component, mesh_renderer_component>().each(add);
+    scene.view<transform_component, skinned_mesh_renderer_component>().each(add);
+    scene.view<transform_component, instance_group_component>().each(add);
+}
+
+void render_extraction_cache::collect_changes(const ecs::world& scene)
+{
+    for_each_item_component(
+        [&]<class T>(std::type_identity<T>)
+        {
+            if (scene.last_change(ecs::component_type<T>()) <= cursor_.revision) return;
+            for (const auto change : scene.changes_since<T>(cursor_))
+                mark(scene, change.value);
+        });
+
+    // Removals leave no component change behind, so lifetime and membership edits come from the structural log.
+    const auto changes = scene.structural_changes();
+    auto pending = std::upper_bound(changes.begin(), changes.end(), cursor_.revision,
+                                    [](ecs::change_revision revision, const ecs::structural_change& change)
+                                    { return revision < change.revision; });
+    for (; pending != changes.end(); ++pending)
+    {
+        bool relevant = pending->kind == ecs::structural_change_kind::entity_destroyed;
+        if (pending->kind == ecs::structural_change_kind::component_added ||
+            pending->kind == ecs::structural_change_kind::component_removed)
+            for_each_item_component([&]<class T>(std::type_identity<T>)
+                                    { relevant = relevant || pending->component == ecs::component_type<T>(); });
+        if (!relevant) continue;
+        for (const auto value : scene.structural_entities(*pending))
+            mark(scene, value);
+    }
+}
+
+void render_extraction_cache::mark(const ecs::world& scene, entity value)
+{
+    if (value.index >= pending_positions_.size())
+        pending_positions_.resize(static_cast<std::size_t>(value.index) + 1u, no_item);
+    auto& position = pending_positions_[value.index];
+    if (position == no_item)
+    {
+        position = static_cast<std::uint32_t>(pending_.size());
+        pending_.push_back(value);
+    }
+    else if (scene.alive(value))
+    {
+        pending_[position] = value;
+    }
+}
+
+void render_extraction_cache::write(std::uint32_t& slot, const render::render_item* item)
+{
+    if (slot != no_item && items_->has(slot, render::render_item_flag::selected)) --selected_items_;
+    if (!item)
+    {
+        if (slot == no_item) return;
+        writable_items().vacate(slot);
+        free_items_.push_back(slot);
+        removed_items_.push_back(slot);
+        slot = no_item;
+        return;
+    }
+    if (slot == no_item && !free_items_.empty())
+    {
+        slot = free_items_.back();
+        free_items_.pop_back();
+    }
+    if (slot == no_item)
+        slot = writable_items().push_back(*item);
+    else
+        writable_items().assign(slot, *item);
+    if (item->selected) ++selected_items_;
+    changed_items_.push_back(slot);
+}
+
+render::render_draw_stream& render_extraction_cache::writable_items()
+{
+    // Packets only ever drop their references, so once this is the sole owner no reader can appear. The fence
+    // pairs with the last packet's reference drop, so its reads happen before these edits.
+    if (items_.use_count() > 1)
+        items_ = std::make_shared<render::render_draw_stream>(*items_);
+    else
+        std::atomic_thread_fence(std::memory_order_acquire);
+    return *items_;
+}
+
 void prepare_render_scene_queries(ecs::world& scene)
 {
     scene.prepare_query<world_environment_component, celestial_sky_component>();
@@ -358,11 +928,16 @@ render_scene_result render_scene(ecs::world& scene, render::renderer& renderer,
                                  render::mesh_visualization_mode visualization, render::editor_overlay_mode overlay,
                                  bool shadows_enabled, scene_render_visibility environment_visibility,
                                  float delta_seconds, render::debug_overlay_stream debug_overlay,
-                                 entity preferred_camera, terrain_render_proxy_cache* terrain_proxies)
+                                 entity preferred_camera, terrain_render_proxy_cache* terrain_proxies,
+                                 transform_hierarchy_cache* transform_cache,
+                                 render_extraction_cache* extraction_cache, jobs::job_system* jobs)
 {
     render_scene_result result{};
     prepare_render_scene_queries(scene);
-    update_world_transforms(scene);
+    if (transform_cache)
+        update_world_transforms(scene, *transform_cache, jobs);
+    else
+        update_world_transforms(scene);
     update_world_environments(scene, delta_seconds);
 
     const transform_component* camera_transform{};
@@ -473,32 +1048,6 @@ render_scene_result render_scene(ecs::world& scene, render::renderer& renderer,
             if (world_packet.environment.fog.enabled) ++result.fog_count;
         });
 
-    scene.view<transform_component, mesh_renderer_component>().each(
-        [&](entity value, const transform_component& transform, const mesh_renderer_component& mesh_renderer)
-        {
-            bool transparent{};
-            if (!environment_mesh_visible(scene, value, environment_visibility, transparent)) return;
-            const bool may_virtualize =
-                mesh_renderer.representation != render::geometry_representation_policy::conventional;
-            if (!transparent && may_virtualize && renderer.resolved_config().features.virtual_geometry &&
-                renderer.virtual_mesh_alive(mesh_renderer.mesh.virtualized))
-            {
-                append_virtual_mesh_items(scene, renderer, world_packet, result, value, transform, mesh_renderer);
-                return;
-            }
-            render::mesh_handle mesh =
-                select_cooked_lod(mesh_renderer.mesh, world_packet.camera, world_bounds_for(scene, value, transform),
-                                  renderer.resolved_config().geometry_error_threshold);
-            auto material = mesh_renderer.material;
-            if (mesh_renderer.mesh.conventional_lod_count <= 1) apply_lod(scene, value, mesh, material);
-            append_mesh_item(scene, world_packet, result, value, transform, mesh, material, mesh_renderer.visible,
-                             transparent, {}, 0, 1, mesh_renderer.base_color_tint, mesh_renderer.casts_shadows,
-                             mesh_renderer.receives_shadows, mesh_renderer.shadow_lod_bias,
-                             mesh_renderer.maximum_shadow_distance, mesh_renderer.affects_indirect_lighting,
-                             mesh_renderer.surface_card_density_bias, mesh_renderer.distance_field_resolution_bias,
-                             mesh_renderer.visible_in_hardware_tracing);
-        });
-
     std::vector<ecs::entity_guid> active_terrain_guids;
     scene.view<transform_component, terrain_component>().each(
         [&](entity value, const transform_component& transform, const terrain_component& terrain)
@@ -531,215 +1080,66 @@ render_scene_result render_scene(ecs::world& scene, render::renderer& renderer,
         });
     if (terrain_proxies) terrain_proxies->release_missing(active_terrain_guids, renderer);
 
-    scene.view<transform_component, water_component>().each(
-        [&](entity value, const transform_component& transform, const water_component& water)
-        {
-            if (!environment_visibility.water || !entity_is_active(scene, value) || !water.enabled) return;
-            world_packet.waters.push_back({.object_id = render::make_render_object_id(value.index, value.generation),
-                                           .position = transform.position,
-                                           .size = water.size,
-                                           .color = water.color,
-                                           .roughness = water.roughness,
-                                           .wave_scale = water.wave_scale,
-                                           .wave_speed = water.wave_speed,
-                                           .transparency = water.transparency,
-                                           .label = entity_label(scene, value)});
-            ++result.water_count;
-        });
-
-    scene.view<transform_component, vegetation_component>().each(
-        [&](entity value, const transform_component& transform, const vegetation_component& vegetation)
-        {
-            if (!environment_visibility.vegetation || !entity_is_active(scene, value) || !vegetation.enabled) return;
-            world_packet.vegetation.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .position = transform.position,
-                 .density = vegetation.density,
-                 .patch_size = vegetation.patch_size,
-                 .color = vegetation.color,
-                 .wind_strength = vegetation.wind_strength,
-                 .wind_speed = vegetation.wind_speed,
-                 .cast_shadows = vegetation.cast_shadows,
-                 .shadow_lod_bias = vegetation.shadow_lod_bias,
-                 .maximum_shadow_distance = vegetation.maximum_shadow_distance,
-                 .label = entity_label(scene, value)});
-            ++result.vegetation_count;
-            result.vegetation_instance_count += vegetation.density;
-        });
-
-    scene.view<transform_component, decal_component>().each(
-        [&](entity value, const transform_component& transform, const decal_component& decal)
-        {
-            if (!environment_visibility.decals || !entity_is_active(scene, value) || !decal.enabled) return;
-            const math::matrix4f world = transform.dirty ? local_matrix(transform) : transform.world;
-            world_packet.decals.push_back({.object_id = render::make_render_object_id(value.index, value.generation),
-                                           .model = world,
-                                           .world_bounds = world_bounds_for(scene, value, transform),
-                                           .color = decal.color,
-                                           .texture = decal.texture,
-                                           .opacity = decal.opacity,
-                                           .label = entity_label(scene, value)});
-            ++result.decal_count;
-        });
-
-    scene.view<transform_component, skinned_mesh_renderer_component>().each(
-        [&](entity value, const transform_component& transform, const skinned_mesh_renderer_component& mesh_renderer)
-        {
-            append_mesh_item(scene, world_packet, result, value, transform, mesh_renderer.mesh, mesh_renderer.material,
-                             mesh_renderer.visible, false, mesh_renderer.skin_matrices, mesh_renderer.joint_count, 1,
-                             math::vector4f::one, mesh_renderer.casts_shadows, mesh_renderer.receives_shadows,
-                             mesh_renderer.shadow_lod_bias, mesh_renderer.maximum_shadow_distance);
-        });
-
-    scene.view<transform_component, instance_group_component>().each(
-        [&](entity value, const transform_component& transform, const instance_group_component& instances)
-        {
-            append_mesh_item(scene, world_packet, result, value, transform, instances.mesh, instances.material,
-                             instances.visible, false, {}, 0, instances.instance_count);
-        });
-
-    scene.view<transform_component, directional_light_component>().each(
-        [&](entity value, const transform_component& transform, const directional_light_component& light)
-        {
-            if (!entity_is_active(scene, value) || !light.enabled) return;
-            world_packet.directional_lights.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .direction = world_forward_direction(transform),
-                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
-                 .intensity = light.intensity,
-                 .casts_shadows = light.casts_shadows,
-                 .enabled = light.enabled,
-                 .use_color_temperature = light.use_color_temperature,
-                 .temperature_kelvin = light.temperature_kelvin,
-                 .intensity_unit = light.intensity_unit,
-                 .cookie_texture = light.cookie_texture,
-                 .shadow = light.shadow,
-                 .cascades = light.cascades,
-                 .mobility = entity_mobility(scene, value),
-                 .label = entity_label(scene, value)});
-            ++result.directional_light_count;
-        });
-
-    scene.view<transform_component, point_light_component>().each(
-        [&](entity value, const transform_component& transform, const point_light_component& light)
-        {
-            if (!entity_is_active(scene, value) || !light.enabled) return;
-            world_packet.point_lights.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .position = world_position(transform),
-                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
-                 .intensity = light.intensity,
-                 .range = light.range,
-                 .casts_shadows = light.casts_shadows,
-                 .enabled = light.enabled,
-                 .use_color_temperature = light.use_color_temperature,
-                 .temperature_kelvin = light.temperature_kelvin,
-                 .intensity_unit = light.intensity_unit,
-                 .cookie_texture = light.cookie_texture,
-                 .shadow = light.shadow,
-                 .mobility = entity_mobility(scene, value),
-                 .label = entity_label(scene, value)});
-            ++result.point_light_count;
-        });
-
-    scene.view<transform_component, spot_light_component>().each(
-        [&](entity value, const transform_component& transform, const spot_light_component& light)
-        {
-            if (!entity_is_active(scene, value) || !light.enabled) return;
-            world_packet.spot_lights.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .position = world_position(transform),
-                 .direction = world_forward_direction(transform),
-                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
-                 .intensity = light.intensity,
-                 .range = light.range,
-                 .inner_angle = light.inner_angle,
-                 .outer_angle = light.outer_angle,
-                 .casts_shadows = light.casts_shadows,
-                 .enabled = light.enabled,
-                 .use_color_temperature = light.use_color_temperature,
-                 .temperature_kelvin = light.temperature_kelvin,
-                 .intensity_unit = light.intensity_unit,
-                 .cookie_texture = light.cookie_texture,
-                 .shadow = light.shadow,
-                 .mobility = entity_mobility(scene, value),
-                 .label = entity_label(scene, value)});
-            ++result.spot_light_count;
-        });
-
-    scene.view<transform_component, area_light_component>().each(
-        [&](entity value, const transform_component& transform, const area_light_component& light)
-        {
-            if (!entity_is_active(scene, value) || !light.enabled) return;
-            const auto direction = world_forward_direction(transform);
-            const auto up = world_up_direction(transform);
-            const auto tangent = math::normalize(math::cross(direction, up));
-            world_packet.area_lights.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .position = world_position(transform),
-                 .direction = direction,
-                 .tangent = tangent,
-                 .color = effective_light_color(light.color, light.use_color_temperature, light.temperature_kelvin),
-                 .intensity = light.intensity,
-                 .width = light.width,
-                 .height = light.height,
-                 .shape = light.shape,
-                 .two_sided = light.two_sided,
-                 .casts_shadows = light.casts_shadows,
-                 .enabled = light.enabled,
-                 .use_color_temperature = light.use_color_temperature,
-                 .temperature_kelvin = light.temperature_kelvin,
-                 .intensity_unit = light.intensity_unit,
-                 .shadow = light.shadow,
-                 .mobility = entity_mobility(scene, value),
-                 .label = entity_label(scene, value)});
-            ++result.area_light_count;
-        });
-
-    scene.view<transform_component, reflection_probe_component>().each(
-        [&](entity value, const transform_component& transform, const reflection_probe_component& probe)
-        {
-            if (!entity_is_active(scene, value) || !probe.enabled) return;
-            world_packet.reflection_probes.push_back({.position = transform.position,
-                                                      .box_extents = probe.box_extents,
-                                                      .radius = probe.radius,
-                                                      .blend_distance = probe.blend_distance,
-                                                      .intensity = probe.intensity,
-                                                      .priority = probe.priority,
-                                                      .cubemap = probe.cubemap,
-                                                      .resolution = probe.resolution,
-                                                      .shape = static_cast<std::uint8_t>(probe.shape),
-                                                      .update_policy = static_cast<std::uint8_t>(probe.update_policy),
-                                                      .label = entity_label(scene, value)});
-            ++result.reflection_probe_count;
-        });
-
-    scene.view<transform_component, irradiance_probe_component>().each(
-        [&](entity value, const transform_component& transform, const irradiance_probe_component& probe)
+    // Terrain proxies upload through the renderer above; the remaining passes only read the scene and the renderer,
+    // so each runs as its own job, with the mesh passes split further into entity chunks. Every job writes a separate
+    // packet stream or chunk, and chunks are appended in order afterwards, so the packet does not depend on how the
+    // jobs were scheduled. The cached mesh stream, when used, is one more job. Without a job system the tasks run in
+    // order on this thread and the chunks write straight into the packet, which yields the same order.
+    std::vector<mesh_extraction_chunk> mesh_chunks;
+    if (!extraction_cache)
+    {
+        append_mesh_chunks<mesh_renderer_component>(scene, mesh_source::mesh_renderer, mesh_chunks);
+        append_mesh_chunks<skinned_mesh_renderer_component>(scene, mesh_source::skinned_mesh_renderer, mesh_chunks);
+        append_mesh_chunks<instance_group_component>(scene, mesh_source::instance_group, mesh_chunks);
+    }
+    if (!jobs)
+    {
+        std::size_t mesh_entity_count{};
+        for (const auto& chunk : mesh_chunks)
+            mesh_entity_count += chunk.entities.size();
+        world_packet.items.reserve(mesh_entity_count);
+    }
+    const auto run_tasks = [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t task = begin; task < end; ++task)
         {
-            if (!entity_is_active(scene, value) || !probe.enabled) return;
-            world_packet.irradiance_probes.push_back({.position = transform.position,
-                                                      .radius = probe.radius,
-                                                      .visibility = probe.visibility,
-                                                      .intensity = probe.intensity,
-                                                      .priority = probe.priority,
-                                                      .spherical_harmonics = probe.spherical_harmonics,
-                                                      .label = entity_label(scene, value)});
-            ++result.irradiance_probe_count;
-        });
+            if (task < mesh_chunks.size())
+            {
+                auto& chunk = mesh_chunks[task];
+                if (jobs) chunk.items.reserve(chunk.entities.size());
+                extract_mesh_chunk(scene, renderer, world_packet.camera, environment_visibility, chunk,
+                                   jobs ? chunk.items : world_packet.items,
+                                   jobs ? chunk.virtual_items : world_packet.virtual_items,
+                                   jobs ? chunk.result : result);
+            }
+            else if (task > mesh_chunks.size())
+                extraction_passes[task - mesh_chunks.size() - 1](scene, environment_visibility, world_packet, result);
+            else if (extraction_cache)
+                extraction_cache->extract(scene, renderer, environment_visibility, world_packet, result);
+        }
+    };
+    const std::size_t task_count = mesh_chunks.size() + 1 + extraction_passes.size();
+    if (jobs)
+        jobs->parallel_for(0, task_count, 1, run_tasks);
+    else
+        run_tasks(0, task_count);
 
-    scene.view<baked_lighting_component>().each(
-        [&](entity value, const baked_lighting_component& baked)
+    if (jobs)
+    {
+        std::size_t chunk_item_count{};
+        for (const auto& chunk : mesh_chunks)
+            chunk_item_count += chunk.items.size();
+        world_packet.items.reserve(chunk_item_count);
+        for (auto& chunk : mesh_chunks)
         {
-            if (!entity_is_active(scene, value) || !baked.enabled) return;
-            world_packet.baked_lighting.push_back(
-                {.object_id = render::make_render_object_id(value.index, value.generation),
-                 .lightmap = baked.lightmap,
-                 .directional_lightmap = baked.directional_lightmap,
-                 .uv_channel = baked.uv_channel,
-                 .scale_offset = baked.scale_offset,
-                 .intensity = baked.intensity});
-        });
+            world_packet.items.append(chunk.items);
+            world_packet.virtual_items.insert(world_packet.virtual_items.end(),
+                                              std::make_move_iterator(chunk.virtual_items.begin()),
+                                              std::make_move_iterator(chunk.virtual_items.end()));
+            result.renderable_count += chunk.result.renderable_count;
+            result.selected_count += chunk.result.selected_count;
+        }
+    }
 
     const auto lighting = render::pack_scene_lighting(world_packet.directional_lights, world_packet.point_lights,
                                                       world_packet.spot_lights, nullptr, render::max_point_lights,
@@ -751,10 +1151,11 @@ render_scene_result render_scene(ecs::world& scene, render::renderer& renderer,
 
     result.environment = world_packet.environment;
     const bool gpu_driven = renderer.resolved_config().features.gpu_driven_rendering;
-    render::prepare_render_world(world_packet, {.gpu_driven = gpu_driven});
-    result.submitted_draw_count = gpu_driven
-                                      ? world_packet.items.size() + world_packet.virtual_items.size()
-                                      : world_packet.visible_items.size() + world_packet.visible_virtual_items.size();
+    render::prepare_render_world(world_packet, {.gpu_driven = gpu_driven, .jobs = jobs});
+    const auto& items = world_packet.item_stream();
+    result.submitted_draw_count =
+        gpu_driven ? items.size() - items.vacancies + world_packet.virtual_items.size()
+                   : world_packet.visible_items.size() + world_packet.visible_virtual_items.size();
     result.culled_count = world_packet.culled_item_count;
     result.culled_virtual_cluster_count = world_packet.culled_virtual_cluster_count;
     result.instance_batch_count = world_packet.instance_batches.size();
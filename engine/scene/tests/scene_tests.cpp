@@ -3,10 +3,13 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <limits>
 #include <numeric>
+#include <string>
+#include <utility>
 #include <vector>
 
 TEST_CASE("registry creates destroys and rejects stale entities")
@@ -189,6 +192,170 @@ TEST_CASE("scene hierarchy propagates transforms and destroys complete subtrees"
     REQUIRE(scene.get<arc::scene::hierarchy_component>(root).child_count == 0);
 }
 
+TEST_CASE("cached transform propagation recomputes only dirty subtrees")
+{
+    using arc::scene::transform_component;
+    arc::ecs::world scene;
+    const auto root = scene.create();
+    const auto moving = scene.create();
+    const auto still = scene.create();
+    const auto leaf = scene.create();
+    scene.emplace<transform_component>(root).position = {1.0f, 0.0f, 0.0f};
+    scene.emplace<transform_component>(moving).position = {2.0f, 0.0f, 0.0f};
+    scene.emplace<transform_component>(still).position = {4.0f, 0.0f, 0.0f};
+    scene.emplace<transform_component>(leaf).position = {8.0f, 0.0f, 0.0f};
+    constexpr auto keep_local = arc::scene::reparent_transform_policy::preserve_local;
+    REQUIRE(arc::scene::reparent(scene, moving, root, {}, keep_local));
+    REQUIRE(arc::scene::reparent(scene, still, root, {}, keep_local));
+    REQUIRE(arc::scene::reparent(scene, leaf, moving, {}, keep_local));
+
+    arc::scene::transform_hierarchy_cache cache;
+    arc::scene::update_world_transforms(scene, cache);
+    REQUIRE(cache.node_count() == 4);
+    REQUIRE(cache.depth_count() == 3);
+    const auto world_x = [&](arc::ecs::entity value)
+    { return arc::scene::world_position(std::as_const(scene).get<transform_component>(value))[0]; };
+    REQUIRE(world_x(leaf) == Catch::Approx(11.0f));
+    REQUIRE(world_x(still) == Catch::Approx(5.0f));
+
+    const auto before = scene.last_change(arc::ecs::component_type<transform_component>());
+    scene.get<transform_component>(moving).set_position({3.0f, 0.0f, 0.0f});
+    const auto edited = scene.last_change(arc::ecs::component_type<transform_component>());
+    REQUIRE(edited > before);
+    arc::scene::update_world_transforms(scene, cache);
+    REQUIRE(world_x(leaf) == Catch::Approx(12.0f));
+    REQUIRE(scene.component_change_for(leaf, arc::ecs::component_type<transform_component>()).revision > edited);
+    REQUIRE(scene.component_change_for(still, arc::ecs::component_type<transform_component>()).revision < edited);
+
+    REQUIRE(arc::scene::reparent(scene, leaf, still, {}, keep_local));
+    arc::scene::update_world_transforms(scene, cache);
+    REQUIRE(world_x(leaf) == Catch::Approx(13.0f));
+}
+
+TEST_CASE("reparenting preserves world transforms without a full transform pass")
+{
+    using arc::scene::transform_component;
+    arc::ecs::world scene;
+    const auto bystander = scene.create();
+    scene.emplace<transform_component>(bystander).position = {1.0f, 0.0f, 0.0f};
+    REQUIRE(scene.get<transform_component>(bystander).dirty);
+
+    constexpr std::size_t group_count = 64;
+    constexpr std::size_t node_count = 24000;
+    std::vector<arc::ecs::entity> groups;
+    for (std::size_t group = 0; group < group_count; ++group)
+    {
+        groups.push_back(scene.create());
+        scene.emplace<transform_component>(groups.back()).position = {static_cast<float>(group), 2.0f, 0.0f};
+        REQUIRE(arc::scene::reparent(scene, groups.back()));
+    }
+    std::vector<arc::ecs::entity> nodes;
+    for (std::size_t index = 0; index < node_count; ++index)
+    {
+        nodes.push_back(scene.create());
+        scene.emplace<transform_component>(nodes.back()).position = {0.0f, 0.0f, static_cast<float>(index % 7)};
+        REQUIRE(arc::scene::reparent(scene, nodes.back(), groups[index % group_count], {},
+                                     arc::scene::reparent_transform_policy::preserve_local));
+    }
+    // Moving nodes back to the root level keeps their world position and appends them to the root chain.
+    constexpr std::size_t moved_stride = 97;
+    std::vector<arc::ecs::entity> moved;
+    for (std::size_t index = 0; index < node_count; index += moved_stride)
+    {
+        moved.push_back(nodes[index]);
+        REQUIRE(arc::scene::reparent(scene, nodes[index]));
+    }
+
+    // Nothing outside the reparented subtrees was recomputed along the way.
+    REQUIRE(scene.get<transform_component>(bystander).dirty);
+    const auto root_order = arc::scene::roots(scene);
+    REQUIRE(root_order.size() == 1 + group_count + moved.size());
+    REQUIRE(std::equal(moved.begin(), moved.end(), root_order.end() - static_cast<std::ptrdiff_t>(moved.size())));
+
+    arc::scene::update_world_transforms(scene);
+    for (std::size_t index = 0; index < node_count; index += moved_stride)
+    {
+        const auto world = arc::scene::world_position(scene.get<transform_component>(nodes[index]));
+        REQUIRE(world[0] == Catch::Approx(static_cast<float>(index % group_count)));
+        REQUIRE(world[1] == Catch::Approx(2.0f));
+        REQUIRE(world[2] == Catch::Approx(static_cast<float>(index % 7)));
+    }
+}
+
+TEST_CASE("root appends after detach follow roots order regardless of other worlds")
+{
+    using arc::ecs::entity;
+    const auto build = [](bool touch_other_world)
+    {
+        arc::ecs::world scene;
+        const std::vector<entity> nodes{scene.create(), scene.create(), scene.create(), scene.create()};
+        for (const auto value : nodes)
+            scene.emplace<arc::scene::hierarchy_component>(value);
+        REQUIRE(arc::scene::reparent(scene, nodes[3], nodes[0]));
+        REQUIRE(arc::scene::reparent(scene, nodes[2], {}));
+        // detach() unlinks a root without a structural record.
+        arc::scene::detach(scene, nodes[1]);
+        if (touch_other_world)
+        {
+            arc::ecs::world other;
+            REQUIRE(arc::scene::reparent(other, other.create(), {}));
+        }
+        REQUIRE(arc::scene::reparent(scene, nodes[3], {}));
+        REQUIRE(arc::scene::roots(scene) == std::vector<entity>{nodes[0], nodes[2], nodes[1], nodes[3]});
+        return arc::scene::roots(scene);
+    };
+    REQUIRE(build(false) == build(true));
+}
+
+TEST_CASE("hierarchy index flattens subtrees into contiguous pre-order ranges")
+{
+    using arc::ecs::entity;
+    arc::ecs::world scene;
+    const auto root = scene.create();
+    std::vector<entity> branches;
+    std::vector<entity> leaves;
+    for (int branch = 0; branch < 3; ++branch)
+    {
+        branches.push_back(scene.create());
+        REQUIRE(arc::scene::reparent(scene, branches.back(), root));
+        for (int leaf = 0; leaf < 2; ++leaf)
+        {
+            leaves.push_back(scene.create());
+            REQUIRE(arc::scene::reparent(scene, leaves.back(), branches.back()));
+        }
+    }
+    REQUIRE(scene.get<arc::scene::hierarchy_component>(root).last_child == branches.back());
+    REQUIRE(arc::scene::children(scene, root) == branches);
+
+    arc::scene::hierarchy_index index;
+    index.refresh(scene);
+    REQUIRE(index.order().size() == 10);
+    REQUIRE(index.order().front() == root);
+    const auto middle = index.subtree(branches[1]);
+    REQUIRE(std::vector<entity>(middle.begin(), middle.end()) ==
+            std::vector<entity>{branches[1], leaves[2], leaves[3]});
+    REQUIRE(index.depth(leaves[5]) == 2);
+    REQUIRE(index.is_descendant(leaves[4], root));
+    REQUIRE_FALSE(index.is_descendant(leaves[4], branches[0]));
+
+    scene.emplace<arc::scene::transform_component>(leaves[0]);
+    index.refresh(scene);
+    REQUIRE(index.subtree(root).size() == 10);
+
+    REQUIRE(arc::scene::reparent(scene, branches[0], branches[2]));
+    REQUIRE(scene.get<arc::scene::hierarchy_component>(branches[2]).last_child == branches[0]);
+    index.refresh(scene);
+    REQUIRE(index.subtree(branches[2]).size() == 6);
+    REQUIRE(index.depth(leaves[1]) == 3);
+
+    REQUIRE(arc::scene::destroy_subtree(scene, index, branches[2]));
+    REQUIRE_FALSE(scene.alive(leaves[0]));
+    REQUIRE(scene.alive(branches[1]));
+    index.refresh(scene);
+    REQUIRE(index.order().size() == 4);
+    REQUIRE(arc::scene::children(scene, root) == std::vector<entity>{branches[1]});
+}
+
 TEST_CASE("transform and camera helpers use right handed minus z forward")
 {
     arc::scene::transform_component transform;
@@ -301,11 +468,12 @@ TEST_CASE("render scene extracts visible mesh draw events from active camera")
     const auto& world_event = std::get<arc::render::render_world_event>(packet.events[0].payload);
     REQUIRE(world_event.packet);
     REQUIRE(world_event.packet->visible_items.size() == 1);
-    const auto& item = world_event.packet->items[world_event.packet->visible_items[0]];
-    REQUIRE(item.mesh == mesh);
+    const auto& items = world_event.packet->items;
+    const auto index = world_event.packet->visible_items[0];
+    REQUIRE(items.meshes[index] == mesh);
     REQUIRE(world_event.packet->mode == arc::render::render_mode::wireframe);
-    REQUIRE(item.selected);
-    REQUIRE(item.base_color_tint[2] == Catch::Approx(0.6f));
+    REQUIRE(items.has(index, arc::render::render_item_flag::selected));
+    REQUIRE(items.details[index].base_color_tint[2] == Catch::Approx(0.6f));
     REQUIRE(world_event.packet->shadows_enabled);
 }
 
@@ -735,12 +903,13 @@ TEST_CASE("mesh renderer keeps conventional fallback when virtual geometry is un
     REQUIRE(world_event.packet);
     REQUIRE(world_event.packet->visible_items.size() == 1);
     REQUIRE(world_event.packet->virtual_items.empty());
-    const auto& item = world_event.packet->items[world_event.packet->visible_items[0]];
-    REQUIRE(item.mesh == conventional_mesh);
-    REQUIRE(item.object_id.index == mesh_entity.index);
-    REQUIRE(item.object_id.generation == mesh_entity.generation);
-    REQUIRE(item.selected);
-    REQUIRE(item.base_color_tint[0] == Catch::Approx(0.8f));
+    const auto& items = world_event.packet->items;
+    const auto index = world_event.packet->visible_items[0];
+    REQUIRE(items.meshes[index] == conventional_mesh);
+    REQUIRE(items.details[index].object_id.index == mesh_entity.index);
+    REQUIRE(items.details[index].object_id.generation == mesh_entity.generation);
+    REQUIRE(items.has(index, arc::render::render_item_flag::selected));
+    REQUIRE(items.details[index].base_color_tint[0] == Catch::Approx(0.8f));
 }
 
 TEST_CASE("render scene can request wireframe overlay for every draw")
@@ -911,8 +1080,8 @@ TEST_CASE("render scene extracts skinned and instanced render items")
     const auto& world_event = std::get<arc::render::render_world_event>(packet.events[0].payload);
     REQUIRE(world_event.packet);
     REQUIRE(world_event.packet->items.size() == 2);
-    REQUIRE(world_event.packet->items[0].skin_joint_count == 64);
-    REQUIRE(world_event.packet->items[1].instance_count == 12);
+    REQUIRE(world_event.packet->items.details[0].skin_joint_count == 64);
+    REQUIRE(world_event.packet->items.details[1].instance_count == 12);
 }
 
 TEST_CASE("render scene applies first valid LOD mesh")
@@ -940,7 +1109,228 @@ TEST_CASE("render scene applies first valid LOD mesh")
 
     const auto packet = renderer.frame_queue().commit(4);
     const auto& world_event = std::get<arc::render::render_world_event>(packet.events[0].payload);
-    REQUIRE(world_event.packet->items[0].mesh == lod_mesh);
+    REQUIRE(world_event.packet->items.meshes[0] == lod_mesh);
+}
+
+TEST_CASE("render extraction cache re-reads only changed entities and keeps item slots stable")
+{
+    arc::ecs::world scene;
+    arc::render::renderer renderer;
+
+    const auto camera_entity = scene.create();
+    arc::scene::transform_component camera_transform;
+    camera_transform.position = arc::math::vector3f{0.0f, 0.0f, 20.0f};
+    scene.emplace<arc::scene::transform_component>(camera_entity, camera_transform);
+    scene.emplace<arc::scene::camera_component>(camera_entity);
+
+    const auto add_mesh = [&](std::uint32_t mesh_index)
+    {
+        const auto value = scene.create();
+        scene.emplace<arc::scene::transform_component>(value).position = {static_cast<float>(mesh_index), 0.0f, 0.0f};
+        scene.emplace<arc::scene::mesh_renderer_component>(
+            value, arc::scene::mesh_renderer_component{
+                       .mesh = arc::render::geometry_resource_handle{{.index = mesh_index, .generation = 1}}});
+        return value;
+    };
+    std::vector<arc::ecs::entity> meshes;
+    for (std::uint32_t index = 1; index <= 4; ++index)
+        meshes.push_back(add_mesh(index));
+
+    arc::scene::transform_hierarchy_cache transforms;
+    arc::scene::render_extraction_cache cache;
+    std::uint64_t frame{};
+    arc::scene::render_scene_result result{};
+    const auto extract = [&]
+    {
+        result = arc::scene::render_scene(scene, renderer, 1280, 720, arc::render::render_mode::shaded,
+                                          arc::render::mesh_visualization_mode::standard,
+                                          arc::render::editor_overlay_mode::selected_wireframe, true, {}, 0.0f, {},
+                                          {}, nullptr, &transforms, &cache);
+        const auto packet = renderer.frame_queue().commit(++frame);
+        return std::get<arc::render::render_world_event>(packet.events[0].payload).packet;
+    };
+
+    const auto initial = extract();
+    REQUIRE(initial->item_stream().size() == 4);
+    REQUIRE(initial->item_delta.base_sequence == 0);
+    REQUIRE(result.renderable_count == 4);
+
+    const auto unchanged = extract();
+    REQUIRE(unchanged->item_delta.base_sequence == initial->item_delta.sequence);
+    REQUIRE(unchanged->item_delta.changed_items.empty());
+    REQUIRE(unchanged->item_delta.removed_items.empty());
+    // An untouched frame hands out the same stream instead of a copy.
+    REQUIRE(unchanged->shared_items == initial->shared_items);
+
+    const float initial_x = initial->item_stream().details[2].model(0, 3);
+    scene.get<arc::scene::transform_component>(meshes[2]).set_position({7.0f, 0.0f, 0.0f});
+    const auto moved = extract();
+    REQUIRE(moved->item_delta.changed_items == std::vector<std::uint32_t>{2});
+    REQUIRE(moved->item_stream().details[2].model(0, 3) == Catch::Approx(7.0f));
+    // Earlier packets still hold the stream, so the edit went to a copy and left theirs as submitted.
+    REQUIRE(moved->shared_items != initial->shared_items);
+    REQUIRE(initial->item_stream().details[2].model(0, 3) == initial_x);
+
+    REQUIRE(scene.remove<arc::scene::mesh_renderer_component>(meshes[1]));
+    const auto removed = extract();
+    REQUIRE(removed->item_delta.removed_items == std::vector<std::uint32_t>{1});
+    REQUIRE(removed->item_stream().size() == 4);
+    REQUIRE(removed->item_stream().has(1, arc::render::render_item_flag::vacant));
+    REQUIRE(result.renderable_count == 3);
+    REQUIRE(result.submitted_draw_count == 3);
+
+    const auto added = add_mesh(9);
+    const auto reused = extract();
+    REQUIRE(reused->item_delta.changed_items == std::vector<std::uint32_t>{1});
+    REQUIRE(reused->item_delta.removed_items.empty());
+    const auto& reused_items = reused->item_stream();
+    REQUIRE(reused_items.details[1].object_id == arc::render::make_render_object_id(added.index, added.generation));
+    REQUIRE(reused_items.meshes[1] == arc::render::mesh_handle{.index = 9, .generation = 1});
+    REQUIRE(result.renderable_count == 4);
+
+    REQUIRE(scene.destroy(meshes[3]));
+    const auto destroyed = extract();
+    REQUIRE(destroyed->item_delta.changed_items.empty());
+    REQUIRE(destroyed->item_delta.removed_items == std::vector<std::uint32_t>{3});
+    REQUIRE(result.renderable_count == 3);
+
+    const auto uncached = arc::scene::render_scene(scene, renderer, 1280, 720);
+    REQUIRE(uncached.renderable_count == result.renderable_count);
+    REQUIRE(uncached.culled_count == result.culled_count);
+}
+
+TEST_CASE("render extraction cache keeps its label table bounded under spawn and destroy churn")
+{
+    arc::ecs::world scene;
+    arc::render::renderer renderer;
+    const auto camera_entity = scene.create();
+    scene.emplace<arc::scene::transform_component>(camera_entity).position = {0.0f, 0.0f, 20.0f};
+    scene.emplace<arc::scene::camera_component>(camera_entity);
+
+    arc::scene::transform_hierarchy_cache transforms;
+    arc::scene::render_extraction_cache cache;
+    std::uint64_t frame{};
+    const auto extract = [&]
+    {
+        static_cast<void>(arc::scene::render_scene(scene, renderer, 1280, 720, arc::render::render_mode::shaded,
+                                                   arc::render::mesh_visualization_mode::standard,
+                                                   arc::render::editor_overlay_mode::selected_wireframe, true, {},
+                                                   0.0f, {}, {}, nullptr, &transforms, &cache));
+        const auto packet = renderer.frame_queue().commit(++frame);
+        return std::get<arc::render::render_world_event>(packet.events[0].payload).packet;
+    };
+
+    constexpr std::uint32_t live_count = 64;
+    std::vector<arc::ecs::entity> live;
+    std::uint32_t spawned{};
+    const auto spawn = [&]
+    {
+        const auto value = scene.create();
+        scene.emplace<arc::scene::transform_component>(value).position = {static_cast<float>(spawned % 8), 0.0f, 0.0f};
+        scene.emplace<arc::scene::name_component>(value, "churn mesh " + std::to_string(spawned));
+        scene.emplace<arc::scene::mesh_renderer_component>(
+            value, arc::scene::mesh_renderer_component{
+                       .mesh = arc::render::geometry_resource_handle{{.index = 1, .generation = 1}}});
+        ++spawned;
+        live.push_back(value);
+    };
+    for (std::uint32_t index = 0; index < live_count; ++index)
+        spawn();
+
+    std::size_t largest_table{};
+    for (int round = 0; round < 400; ++round)
+    {
+        // Replace a quarter of the meshes each frame with longer-named ones in the freed slots.
+        for (std::uint32_t index = 0; index < live_count / 4; ++index)
+        {
+            const auto slot = (static_cast<std::uint32_t>(round) * 7u + index) % live_count;
+            REQUIRE(scene.destroy(live[slot]));
+            live.erase(live.begin() + slot);
+            spawn();
+        }
+        const auto packet = extract();
+        const auto& items = packet->item_stream();
+        std::size_t live_bytes{};
+        for (std::size_t item = 0; item < items.size(); ++item)
+            live_bytes += items.label(item).size();
+        REQUIRE(items.label_data.size() == live_bytes + items.dead_label_bytes);
+        largest_table = std::max(largest_table, items.label_data.size());
+    }
+    const auto packet = extract();
+    const auto& items = packet->item_stream();
+    std::size_t named{};
+    for (std::size_t item = 0; item < items.size(); ++item)
+        named += items.label(item).starts_with("churn mesh ") ? 1u : 0u;
+    REQUIRE(named == live_count);
+    // 6400 spawns would leave well over 100 KiB of labels behind without compaction.
+    REQUIRE(largest_table < 16u * 1024u);
+}
+
+TEST_CASE("render scene extraction on the job system matches serial extraction")
+{
+    arc::ecs::world scene;
+    arc::render::renderer renderer;
+
+    const auto camera_entity = scene.create();
+    arc::scene::transform_component camera_transform;
+    camera_transform.position = arc::math::vector3f{0.0f, 0.0f, 40.0f};
+    scene.emplace<arc::scene::transform_component>(camera_entity, camera_transform);
+    scene.emplace<arc::scene::camera_component>(camera_entity);
+
+    // Enough meshes for several extraction chunks, mixed with the other mesh and light passes.
+    for (std::uint32_t index = 0; index < 2600; ++index)
+    {
+        const auto value = scene.create();
+        scene.emplace<arc::scene::transform_component>(value).position = {static_cast<float>(index % 50) - 25.0f,
+                                                                          static_cast<float>(index / 50) - 25.0f, 0.0f};
+        scene.emplace<arc::scene::name_component>(value, "mesh " + std::to_string(index));
+        if (index % 7 == 0)
+            scene.emplace<arc::scene::skinned_mesh_renderer_component>(
+                value, arc::scene::skinned_mesh_renderer_component{.mesh = {.index = 2, .generation = 1}});
+        else if (index % 11 == 0)
+            scene.emplace<arc::scene::instance_group_component>(
+                value,
+                arc::scene::instance_group_component{.mesh = {.index = 3, .generation = 1}, .instance_count = 4});
+        else
+            scene.emplace<arc::scene::mesh_renderer_component>(
+                value, arc::scene::mesh_renderer_component{
+                           .mesh = arc::render::geometry_resource_handle{{.index = 1 + index % 5, .generation = 1}}});
+        if (index % 100 == 0) scene.emplace<arc::scene::point_light_component>(value);
+    }
+
+    std::uint64_t frame{};
+    const auto extract = [&](arc::jobs::job_system* jobs)
+    {
+        const auto result = arc::scene::render_scene(
+            scene, renderer, 1280, 720, arc::render::render_mode::shaded,
+            arc::render::mesh_visualization_mode::standard, arc::render::editor_overlay_mode::selected_wireframe, true,
+            {}, 0.0f, {}, {}, nullptr, nullptr, nullptr, jobs);
+        const auto packet = renderer.frame_queue().commit(++frame);
+        return std::pair{result, std::get<arc::render::render_world_event>(packet.events[0].payload).packet};
+    };
+
+    const auto [serial_result, serial] = extract(nullptr);
+    REQUIRE(serial->items.size() == 2600);
+    arc::jobs::job_system jobs(arc::jobs::job_system_config{
+        .worker_count = 4, .run_inline = false, .io_worker_count = 0, .enable_render_thread = false});
+    for (int run = 0; run < 3; ++run)
+    {
+        const auto [result, parallel] = extract(&jobs);
+        REQUIRE(result.renderable_count == serial_result.renderable_count);
+        REQUIRE(result.point_light_count == serial_result.point_light_count);
+        REQUIRE(parallel->items.meshes == serial->items.meshes);
+        REQUIRE(parallel->sort_keys == serial->sort_keys);
+        REQUIRE(parallel->items.label_data == serial->items.label_data);
+        REQUIRE(parallel->visible_items == serial->visible_items);
+        REQUIRE(parallel->point_lights.size() == serial->point_lights.size());
+        for (std::size_t index = 0; index < serial->items.size(); ++index)
+        {
+            REQUIRE(parallel->items.details[index].object_id == serial->items.details[index].object_id);
+            REQUIRE(parallel->items.label(index) == serial->items.label(index));
+        }
+        for (std::size_t index = 0; index < serial->point_lights.size(); ++index)
+            REQUIRE(parallel->point_lights[index].object_id == serial->point_lights[index].object_id);
+    }
 }
 
 TEST_CASE("terrain heightfields generate deterministic normalized resource data")
@@ -8,8 +8,12 @@ namespace arc::simd
 template <class T, std::size_t N>
 constexpr simd<T, N> select(const simd_mask<N>& mask, const simd<T, N>& a, const simd<T, N>& b) noexcept
 {
+    using detail::simd_access;
+
+    // Backend blends take the second operand where the mask is set.
     return [&]<std::size_t... Index>(std::index_sequence<Index...>) {
-        return simd<T, N>{ops_for<simd<T, N>>::blend(a.data[Index], b.data[Index], mask.data[Index])...};
+        return simd_access::template make_simd<T, N>(ops_for<simd<T, N>>::blend(
+            simd_access::block(b, Index), simd_access::block(a, Index), simd_access::block(mask, Index))...);
     }(std::make_index_sequence<simd<T, N>::blocks()>{});
 }
 
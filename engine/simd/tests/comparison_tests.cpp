@@ -2,6 +2,8 @@
 
 #include <arc/simd/simd.h>
 
+#include <array>
+
 TEST_CASE("cmp_eq", "[simd]")
 {
     arc::simd::simd<float, 4> a = arc::simd::fill<float, 4>(2.0f);
@@ -18,4 +20,15 @@ TEST_CASE("cmp_ne", "[simd]")
     auto mask = arc::simd::cmp_ne(a, b);
 
     REQUIRE(arc::simd::all(mask));
-}
\ No newline at end of file
+}
+TEST_CASE("select", "[simd]")
+{
+    const std::array<float, 8> values{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    const auto a = arc::simd::load_unaligned<float, 8>(values.data());
+    const auto b = arc::simd::fill<float, 8>(0.0f);
+    const auto picked = arc::simd::select(arc::simd::cmp_gt(a, arc::simd::fill<float, 8>(4.5f)), a, b);
+
+    std::array<float, 8> result{};
+    arc::simd::store_unaligned<float, 8>(result.data(), picked);
+    REQUIRE(result == std::array<float, 8>{0.0f, 0.0f, 0.0f, 0.0f, 5.0f, 6.0f, 7.0f, 8.0f});
+}